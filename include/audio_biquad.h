@@ -0,0 +1,97 @@
+#ifndef AUDIO_BIQUAD_H
+#define AUDIO_BIQUAD_H
+
+#include <zephyr/sys/util.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file audio_biquad.h
+ * @brief Float biquad cascade (transposed direct form II)
+ *
+ * Stages are kept in CMSIS-DSP layout, five coefficients per stage
+ * {b0, b1, b2, a1, a2} with the feedback terms negated:
+ *
+ *   y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] + a1 y[n-1] + a2 y[n-2]
+ *
+ * On Cortex-M with CONFIG_CMSIS_DSP the block runs through
+ * arm_biquad_cascade_df2T_f32(); elsewhere through a stage-major loop
+ * that filters the whole block one stage at a time, so each stage keeps
+ * its coefficients and state in registers and the inner loop has no
+ * per-sample branching.
+ *
+ * Only the first @c stages stages run. Users that switch filters on and
+ * off keep the live ones at the front and remove a stage once it has
+ * ramped to unity, which leaves the other stages' state untouched.
+ */
+
+/** @brief Largest cascade */
+#define AUDIO_BIQUAD_MAX_STAGES CONFIG_AUDIO_BIQUAD_MAX_STAGES
+
+/** @brief Coefficients per stage */
+#define AUDIO_BIQUAD_COEFFS     5
+
+/**
+ * @brief Cascade state.
+ */
+struct audio_biquad_cascade {
+    uint8_t stages;     /**< Running stages, 0 = passthrough */
+    float coeffs[AUDIO_BIQUAD_COEFFS * AUDIO_BIQUAD_MAX_STAGES];
+    float state[2 * AUDIO_BIQUAD_MAX_STAGES];
+};
+
+/**
+ * @brief Designs a peaking (bell) filter, RBJ cookbook.
+ *
+ * A negative @p gain_db gives a notch of that depth; 0 dB is exactly the
+ * identity {1, 0, 0, 0, 0}.
+ *
+ * @param coeffs Destination, AUDIO_BIQUAD_COEFFS entries
+ * @param freq_hz Center frequency, below half the sample rate
+ * @param q Quality factor (center frequency / bandwidth)
+ * @param gain_db Gain at the center frequency
+ * @param sample_rate Sample rate in Hz
+ * @return 0 on success, -EINVAL for a frequency outside (0, Nyquist) or q <= 0
+ */
+int audio_biquad_design_peaking(float *coeffs, float freq_hz, float q, float gain_db,
+                                uint32_t sample_rate);
+
+/**
+ * @brief Empties the cascade.
+ */
+void audio_biquad_init(struct audio_biquad_cascade *bq);
+
+/**
+ * @brief Clears the state of all stages, keeping the coefficients.
+ */
+void audio_biquad_reset(struct audio_biquad_cascade *bq);
+
+/**
+ * @brief Appends a stage with cleared state.
+ *
+ * @return Index of the new stage, -ENOMEM if the cascade is full
+ */
+int audio_biquad_add_stage(struct audio_biquad_cascade *bq, const float *coeffs);
+
+/**
+ * @brief Replaces the coefficients of a stage, keeping its state.
+ */
+void audio_biquad_set_stage(struct audio_biquad_cascade *bq, size_t stage, const float *coeffs);
+
+/**
+ * @brief Removes a stage; later stages move down by one.
+ *
+ * Click-free when the stage has been ramped to the identity first.
+ */
+void audio_biquad_remove_stage(struct audio_biquad_cascade *bq, size_t stage);
+
+/**
+ * @brief Filters samples in place through all running stages.
+ *
+ * @param bq Cascade
+ * @param data Samples
+ * @param count Number of samples
+ */
+void audio_biquad_process(struct audio_biquad_cascade *bq, float *data, size_t count);
+
+#endif // AUDIO_BIQUAD_H
@@ -0,0 +1,383 @@
+#ifndef AUDIO_BLOCK_H
+#define AUDIO_BLOCK_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "audio_placement.h"
+
+/**
+ * @file audio_block.h
+ * @brief Audio block layout and memory pool (shared by V1 and V2)
+ *
+ * Both the threaded (audio_fw.h) and the sequential (audio_fw_v2.h) API are
+ * served by the same slabs in core.c, so the block layout lives here once.
+ */
+
+/**
+ * @brief Total size of an audio block in bytes.
+ */
+#define AUDIO_BLOCK_SIZE_BYTES  (CONFIG_AUDIO_BLOCK_SAMPLES * sizeof(int16_t))
+
+/**
+ * @brief Alignment of every block payload (and block header) in bytes.
+ */
+#define AUDIO_BLOCK_ALIGN       CONFIG_AUDIO_BLOCK_ALIGNMENT
+
+/**
+ * @brief Distance between two payloads in the data slab.
+ *
+ * The payload is padded up to the alignment so that consecutive blocks
+ * never share a cache line and vector loads never run into the next block.
+ */
+#define AUDIO_BLOCK_STRIDE_BYTES  ROUND_UP(AUDIO_BLOCK_SIZE_BYTES, AUDIO_BLOCK_ALIGN)
+
+/**
+ * @brief Number of int16 samples covered by one aligned vector.
+ */
+#define AUDIO_BLOCK_VEC_SAMPLES  (AUDIO_BLOCK_ALIGN / sizeof(int16_t))
+
+/**
+ * @brief Tells the compiler that a payload pointer is block-aligned.
+ *
+ * Only valid for buffers that come from the framework's slabs.
+ */
+#define AUDIO_BLOCK_ASSUME_ALIGNED(ptr) \
+    ((__typeof__(ptr))__builtin_assume_aligned((ptr), AUDIO_BLOCK_ALIGN))
+
+/**
+ * @brief Rounds a sample count up to a whole number of aligned vectors.
+ *
+ * In-place kernels may process this many samples instead of @p n to avoid a
+ * scalar tail loop. The extra samples live in the payload padding and are
+ * never part of data_len.
+ */
+#define AUDIO_BLOCK_PADDED_LEN(n)  ROUND_UP((n), AUDIO_BLOCK_VEC_SAMPLES)
+
+BUILD_ASSERT(IS_POWER_OF_TWO(AUDIO_BLOCK_ALIGN) && AUDIO_BLOCK_ALIGN >= 4,
+             "AUDIO_BLOCK_ALIGNMENT must be a power of two >= 4");
+
+/**
+ * @brief Last block before the source stops emitting on silence.
+ *
+ * Downstream strips and the mixer pass it on and account the time until
+ * the next block as idle (see audio_idle.h).
+ */
+#define AUDIO_BLOCK_FLAG_IDLE   BIT(0)
+
+/**
+ * @brief Audio block structure holding PCM data.
+ *
+ * This structure acts as a wrapper around the raw PCM data buffer.
+ * It includes reference counting to allow zero-copy distribution to multiple nodes.
+ * Sequential (V2) code simply never shares a block and can ignore ref_count.
+ *
+ * Fields between data_len and ref_count are stream metadata and are copied
+ * as a whole by audio_block_copy() and CoW. Fields from ref_count on
+ * belong to the block instance and are never copied.
+ *
+ * @warning All data buffers must be allocated from the framework's memory slabs.
+ *          Do not wrap hardware DMA buffers directly without modifying the release logic.
+ *
+ * @warning New per-stream fields go between data_len and ref_count, new
+ *          per-instance bookkeeping after ref_count.
+ */
+struct audio_block {
+    void *fifo_reserved;    /**< Required by Zephyr k_fifo */
+    int16_t *data;          /**< Pointer to PCM data buffer (allocated from slab) */
+    /* --- metadata, copied --- */
+    size_t data_len;        /**< Number of valid samples in the buffer */
+    uint32_t flags;         /**< AUDIO_BLOCK_FLAG_* stream markers */
+    /* --- instance bookkeeping, not copied --- */
+    atomic_t ref_count;     /**< Reference counter for memory management */
+#if defined(CONFIG_AUDIO_COW_ELISION)
+    atomic_t readers;       /**< References held by declared read-only consumers */
+#endif
+#if defined(CONFIG_AUDIO_POOL_RESERVATIONS)
+    uint8_t pool_class;     /**< Reservation class charged for this block */
+#endif
+};
+
+/**
+ * @brief Byte range of the metadata copied between blocks.
+ */
+#define AUDIO_BLOCK_META_OFFSET  offsetof(struct audio_block, data_len)
+#define AUDIO_BLOCK_META_SIZE    (offsetof(struct audio_block, ref_count) - AUDIO_BLOCK_META_OFFSET)
+
+/**
+ * @brief Copies metadata and the valid samples of one block into another.
+ *
+ * Only data_len samples are copied, rounded up to whole aligned vectors,
+ * so short blocks cost less than a full payload. Both blocks must come
+ * from the framework's slabs.
+ *
+ * @param dst Destination block (its instance fields are left untouched)
+ * @param src Source block
+ */
+static inline void audio_block_copy(struct audio_block *dst, const struct audio_block *src)
+{
+    size_t samples = AUDIO_BLOCK_PADDED_LEN(MIN(src->data_len, (size_t)CONFIG_AUDIO_BLOCK_SAMPLES));
+
+    memcpy((uint8_t *)dst + AUDIO_BLOCK_META_OFFSET,
+           (const uint8_t *)src + AUDIO_BLOCK_META_OFFSET, AUDIO_BLOCK_META_SIZE);
+    memcpy(AUDIO_BLOCK_ASSUME_ALIGNED(dst->data), AUDIO_BLOCK_ASSUME_ALIGNED(src->data),
+           samples * sizeof(int16_t));
+}
+
+/**
+ * @brief Allocates a new audio block.
+ *
+ * Allocates both the metadata wrapper and the data buffer from memory slabs.
+ * Initialize the reference count to 1.
+ *
+ * @return Pointer to the allocated audio block, or NULL if allocation failed.
+ */
+struct audio_block *audio_block_alloc(void);
+
+/**
+ * @brief Allocates a block, waiting for a release if the pool is empty.
+ *
+ * Blocked callers are woken by audio_block_release(). When several threads
+ * wait, the highest-priority one is served first (FIFO within a priority).
+ * With CONFIG_AUDIO_POOL_RESERVATIONS a release wakes all waiters, and the
+ * first one whose class is admitted takes the block.
+ * From an ISR this behaves like audio_block_alloc().
+ *
+ * @param timeout How long to wait (K_NO_WAIT, K_FOREVER or a duration)
+ * @return Pointer to the allocated block, or NULL on timeout.
+ */
+struct audio_block *audio_block_alloc_timeout(k_timeout_t timeout);
+
+/**
+ * @brief Time producers spent blocked in audio_block_alloc_timeout().
+ */
+struct audio_alloc_wait_stats {
+    uint32_t waits;         /**< Allocations that had to wait */
+    uint32_t timeouts;      /**< Waits that ended without a block */
+    uint64_t total_wait_us; /**< Sum of all wait times */
+    uint32_t max_wait_us;   /**< Longest single wait */
+};
+
+/**
+ * @brief Gets the allocation wait statistics.
+ *
+ * @param stats Destination
+ */
+void audio_block_wait_stats_get(struct audio_alloc_wait_stats *stats);
+
+/**
+ * @brief Releases a reference to an audio block.
+ *
+ * Decrements the reference count. If the count reaches zero, the memory
+ * (both data buffer and wrapper) is freed back to the slabs.
+ *
+ * @param block Pointer to the audio block to release.
+ */
+void audio_block_release(struct audio_block *block);
+
+/**
+ * @brief Ensures an audio block is writable (exclusive).
+ *
+ * Checks if the reference count is > 1. If so, it allocates a new block,
+ * copies the content, releases the old block, and updates the pointer.
+ * This implements Copy-on-Write (CoW).
+ *
+ * @warning Triggers memory allocation. Can fail if slab is full (Copy Storm risk).
+ * @note Copies metadata and the valid samples only (see audio_block_copy()).
+ *
+ * @param block_ptr Address of the pointer to the audio block.
+ * @return 0 on success, -ENOMEM if allocation failed (pointer remains unchanged).
+ */
+int audio_block_get_writable(struct audio_block **block_ptr);
+
+/**
+ * @brief Copy-on-Write counters.
+ */
+struct audio_cow_stats {
+    uint32_t copies;        /**< Copies made by audio_block_get_writable() */
+    uint32_t avoided;       /**< Shared blocks taken over without a copy */
+};
+
+/**
+ * @brief Gets the Copy-on-Write counters.
+ *
+ * @param stats Destination
+ */
+void audio_cow_stats_get(struct audio_cow_stats *stats);
+
+#if defined(CONFIG_AUDIO_COW_ELISION)
+
+/**
+ * @brief Declares the caller's reference as read-only.
+ *
+ * A writer calling audio_block_get_writable() while all other references
+ * are declared readers yields to them instead of copying, and takes the
+ * block over once they have released it. This only pays off when the
+ * readers run at the writer's priority (or on another CPU); otherwise the
+ * writer falls back to a copy after CONFIG_AUDIO_COW_ELISION_YIELDS.
+ *
+ * @param block Block the caller holds a reference to and will not modify
+ */
+void audio_block_begin_read(struct audio_block *block);
+
+/**
+ * @brief Ends a read-only declaration while keeping the reference.
+ *
+ * Use this before forwarding the block (pass-through analyzers).
+ */
+void audio_block_end_read(struct audio_block *block);
+
+/**
+ * @brief Ends a read-only declaration and releases the reference.
+ */
+void audio_block_release_read(struct audio_block *block);
+
+#else
+
+static inline void audio_block_begin_read(struct audio_block *block)
+{
+}
+
+static inline void audio_block_end_read(struct audio_block *block)
+{
+}
+
+static inline void audio_block_release_read(struct audio_block *block)
+{
+    audio_block_release(block);
+}
+
+#endif /* CONFIG_AUDIO_COW_ELISION */
+
+#if defined(CONFIG_AUDIO_POOL_RESERVATIONS)
+
+/**
+ * @brief Usage of one pool reservation class.
+ */
+struct audio_pool_stats {
+    size_t reserved;        /**< Guaranteed blocks for this class */
+    size_t used;            /**< Blocks currently charged to this class */
+    size_t peak;            /**< Highest value of used */
+    uint32_t denials;       /**< Allocations refused for this class */
+    size_t shared_free;     /**< Unreserved blocks still free for any class */
+};
+
+/**
+ * @brief Guarantees a class a minimum number of blocks.
+ *
+ * Reserved blocks are only handed to that class. Everything not reserved
+ * forms a shared overflow region that any class can use once its own
+ * reservation is exhausted. Class 0 is used by unbound threads and ISRs.
+ * Set reservations up before the class allocates.
+ *
+ * @param cls Class index (< CONFIG_AUDIO_POOL_CLASSES)
+ * @param min_blocks Blocks to reserve
+ * @return 0 on success, -EINVAL for a bad class, -EBUSY if the class holds
+ *         blocks, -ENOMEM if all reservations together exceed the pool or
+ *         the blocks of the shared region that are still free
+ */
+int audio_pool_reserve(uint8_t cls, size_t min_blocks);
+
+/**
+ * @brief Charges allocations of a thread to a class.
+ *
+ * audio_block_alloc() (and therefore CoW copies) made by @p tid use the
+ * class. channel_strip_set_pool_class() binds strip threads.
+ *
+ * @param tid Thread to bind
+ * @param cls Class index
+ * @return 0 on success, -EINVAL for a bad class, -ENOMEM if the binding table is full
+ */
+int audio_pool_bind_thread(k_tid_t tid, uint8_t cls);
+
+/**
+ * @brief Removes a thread's class binding (it falls back to class 0).
+ */
+void audio_pool_unbind_thread(k_tid_t tid);
+
+/**
+ * @brief Allocates a block charged to an explicit class.
+ *
+ * @param cls Class index
+ * @return Block, or NULL if the class has no reservation left and the
+ *         shared region is exhausted (counted as a denial)
+ */
+struct audio_block *audio_block_alloc_class(uint8_t cls);
+
+/**
+ * @brief Gets usage and denials of one class.
+ *
+ * @return 0 on success, -EINVAL for a bad class
+ */
+int audio_pool_stats_get(uint8_t cls, struct audio_pool_stats *stats);
+
+/**
+ * @brief Logs usage and denials of all classes.
+ */
+void audio_pool_stats_report(void);
+
+#endif /* CONFIG_AUDIO_POOL_RESERVATIONS */
+
+/**
+ * @brief Owner node index for blocks that are not inside a node.
+ *
+ * Used for blocks that are freshly allocated or queued in front of a strip.
+ */
+#define AUDIO_BLOCK_OWNER_NO_NODE  (-1)
+
+#if defined(CONFIG_AUDIO_BLOCK_TRACKING)
+
+/**
+ * @brief Records who currently holds a block.
+ *
+ * The framework tags blocks on allocation (current thread name), on strip
+ * input, before every node of a strip and on V1 node output. Applications
+ * may tag their own hand-offs, e.g. blocks parked in a driver queue.
+ *
+ * @param block Block to tag
+ * @param owner Strip or thread name (must stay valid, not copied)
+ * @param node Node index within the strip, or AUDIO_BLOCK_OWNER_NO_NODE
+ */
+void audio_block_set_owner(const struct audio_block *block, const char *owner, int node);
+
+/**
+ * @brief Returns the number of blocks currently allocated.
+ */
+size_t audio_block_outstanding(void);
+
+/**
+ * @brief Logs every block held by its current owner for too long.
+ *
+ * A period is one block of CONFIG_AUDIO_BLOCK_SAMPLES at sample_rate. A
+ * block that sits with the same owner for many periods has most likely
+ * been leaked by that node.
+ *
+ * @param periods Minimum age in block periods
+ * @param sample_rate Rate the owning strips run at in Hz (e.g. their
+ *                    sample_rate; 0 = CONFIG_AUDIO_SAMPLE_RATE)
+ * @return Number of blocks listed
+ */
+size_t audio_block_dump_stale(uint32_t periods, uint32_t sample_rate);
+
+#else
+
+static inline void audio_block_set_owner(const struct audio_block *block,
+                                         const char *owner, int node)
+{
+}
+
+static inline size_t audio_block_outstanding(void)
+{
+    return 0;
+}
+
+static inline size_t audio_block_dump_stale(uint32_t periods, uint32_t sample_rate)
+{
+    return 0;
+}
+
+#endif /* CONFIG_AUDIO_BLOCK_TRACKING */
+
+#endif // AUDIO_BLOCK_H
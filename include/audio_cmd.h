@@ -0,0 +1,106 @@
+#ifndef AUDIO_CMD_H
+#define AUDIO_CMD_H
+
+#include <zephyr/kernel.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @file audio_cmd.h
+ * @brief Control command ring between control threads and the audio path
+ *
+ * Each channel strip owns one ring. Control threads push commands, the
+ * thread that processes the strip (strip thread or mixer thread) drains
+ * them between two blocks, or right away through the wake hook when no
+ * block is due. Producers serialize on a spinlock among
+ * themselves; the consumer side takes no lock, so control traffic never
+ * blocks the audio path.
+ */
+
+#define AUDIO_CMD_QUEUE_DEPTH  CONFIG_AUDIO_CMD_QUEUE_DEPTH
+
+BUILD_ASSERT(IS_POWER_OF_TWO(AUDIO_CMD_QUEUE_DEPTH), "AUDIO_CMD_QUEUE_DEPTH must be a power of two");
+
+/**
+ * @brief Command types.
+ */
+enum audio_cmd_type {
+    AUDIO_CMD_SET_PARAM,    /**< Set node parameter id to value, ramp over arg samples */
+    AUDIO_CMD_BYPASS,       /**< Bypass node (arg != 0) or re-enable it (arg == 0) */
+    AUDIO_CMD_RESET,        /**< Reset node state */
+    AUDIO_CMD_READ_PARAM,   /**< Read node parameter id, arg is the request sequence */
+    AUDIO_CMD_APPLY_PRESET, /**< Apply all entries of the struct audio_preset in ptr */
+    AUDIO_CMD_MOD_BIND,     /**< Link the struct audio_mod_binding in ptr */
+    AUDIO_CMD_MOD_UNBIND,   /**< Unlink the struct audio_mod_binding in ptr */
+};
+
+/**
+ * @brief One queued command.
+ */
+struct audio_cmd {
+    uint8_t type;           /**< enum audio_cmd_type */
+    uint8_t node;           /**< Node index within the strip */
+    uint16_t reserved;
+    uint32_t id;            /**< Parameter id (node specific) */
+    float value;            /**< Parameter value */
+    uint32_t arg;           /**< Type specific, see enum audio_cmd_type */
+    void *ptr;              /**< Type specific, see enum audio_cmd_type */
+};
+
+/**
+ * @brief Command ring plus the reply slot for parameter reads.
+ */
+struct audio_cmd_queue {
+    struct audio_cmd slots[AUDIO_CMD_QUEUE_DEPTH];
+    atomic_t head;          /**< Next slot to write (producers) */
+    atomic_t tail;          /**< Next slot to read (consumer) */
+    struct k_spinlock producer_lock;
+    uint32_t dropped;       /**< Commands rejected because the ring was full */
+    void (*wake)(struct audio_cmd_queue *q);   /**< Called after each push (NULL = none) */
+
+    struct k_mutex read_lock;   /**< One outstanding read at a time */
+    struct k_sem read_done;
+    uint32_t read_seq;
+    atomic_t reply_seq;
+    float reply_value;
+    int reply_result;
+};
+
+/**
+ * @brief Initializes an empty command ring.
+ */
+void audio_cmd_queue_init(struct audio_cmd_queue *q);
+
+/**
+ * @brief Queues a command (any thread or ISR).
+ *
+ * @return 0 on success, -ENOSPC if the ring is full
+ */
+int audio_cmd_push(struct audio_cmd_queue *q, const struct audio_cmd *cmd);
+
+/**
+ * @brief Takes the oldest command (consumer only).
+ *
+ * @return true if @p cmd was filled
+ */
+bool audio_cmd_pop(struct audio_cmd_queue *q, struct audio_cmd *cmd);
+
+/**
+ * @brief Posts the result of an AUDIO_CMD_READ_PARAM (consumer only).
+ */
+void audio_cmd_reply(struct audio_cmd_queue *q, uint32_t seq, int result, float value);
+
+/**
+ * @brief Queues a parameter read and waits for the consumer's reply.
+ *
+ * @param q Command ring
+ * @param cmd Read command (type, node and id filled in; arg is set here)
+ * @param value Destination for the parameter value
+ * @param timeout How long to wait for the next block boundary
+ * @return Result of the node's get_param, -ENOSPC if the ring is full or
+ *         -EAGAIN if nobody drained the ring in time
+ */
+int audio_cmd_read(struct audio_cmd_queue *q, struct audio_cmd *cmd, float *value,
+                   k_timeout_t timeout);
+
+#endif // AUDIO_CMD_H
@@ -0,0 +1,140 @@
+#ifndef AUDIO_FEATURES_H
+#define AUDIO_FEATURES_H
+
+#include <zephyr/kernel.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file audio_features.h
+ * @brief Spectral classifier features and their frame ring
+ *
+ * Computed once per analyzer frame from the magnitude spectrum the
+ * spectrum analyzer already has: MFCCs (mel filterbank, natural log,
+ * orthonormal DCT-II), spectral centroid, 85 % rolloff, flatness and
+ * flux. Frames go into a single-producer/single-consumer ring that the
+ * classifier reads in place (get, use, release), so the application
+ * neither copies spectra nor takes logs.
+ *
+ * With CONFIG_AUDIO_FEATURE_Q15 the frame fields are Q15: centroid,
+ * rolloff, flatness and flux directly (all in 0 .. 1), MFCCs divided by
+ * AUDIO_FEATURE_MFCC_Q15_SCALE.
+ */
+
+/** @brief MFCC range covered by the Q15 representation (+-) */
+#define AUDIO_FEATURE_MFCC_Q15_SCALE 512.0f
+
+#if defined(CONFIG_AUDIO_FEATURE_Q15)
+typedef int16_t audio_feature_t;
+#else
+typedef float audio_feature_t;
+#endif
+
+/**
+ * @brief One frame of features.
+ */
+struct audio_feature_frame {
+    uint32_t sequence;          /**< Analyzer frame number, gaps mean dropped frames */
+    audio_feature_t mfcc[CONFIG_AUDIO_FEATURE_MFCC_COEFFS];
+    audio_feature_t centroid;   /**< Magnitude-weighted mean frequency / Nyquist */
+    audio_feature_t rolloff;    /**< Frequency below 85 % of the power / Nyquist */
+    audio_feature_t flatness;   /**< Geometric / arithmetic mean of the power */
+    audio_feature_t flux;       /**< Rectified magnitude increase / magnitude sum */
+};
+
+/**
+ * @brief Feature extractor state, embedded in the spectrum analyzer.
+ */
+struct audio_features {
+    size_t num_bins;
+    float mel_edges[CONFIG_AUDIO_FEATURE_MEL_BANDS + 2];   /**< Band edges in bins */
+    float dct[CONFIG_AUDIO_FEATURE_MFCC_COEFFS][CONFIG_AUDIO_FEATURE_MEL_BANDS];
+    float mel[CONFIG_AUDIO_FEATURE_MEL_BANDS];
+    float prev_mag[CONFIG_AUDIO_FFT_MAX_SIZE / 2];
+    bool has_prev;
+    uint32_t sequence;
+
+    // Frame ring (producer: audio thread, consumer: classifier)
+    struct audio_feature_frame ring[CONFIG_AUDIO_FEATURE_RING_FRAMES];
+    atomic_t wr;
+    atomic_t rd;
+    atomic_t dropped;
+};
+
+/**
+ * @brief Converts a centroid/rolloff/flatness/flux field to float.
+ */
+static inline float audio_feature_to_float(audio_feature_t v)
+{
+#if defined(CONFIG_AUDIO_FEATURE_Q15)
+    return (float)v / 32768.0f;
+#else
+    return v;
+#endif
+}
+
+/**
+ * @brief Converts an MFCC field to float.
+ */
+static inline float audio_feature_mfcc_to_float(audio_feature_t v)
+{
+#if defined(CONFIG_AUDIO_FEATURE_Q15)
+    return (float)v * (AUDIO_FEATURE_MFCC_Q15_SCALE / 32768.0f);
+#else
+    return v;
+#endif
+}
+
+/**
+ * @brief Sets up the filterbank and DCT for a spectrum size and rate.
+ *
+ * The ring is left alone, so frames queued before a rate change can
+ * still be read.
+ *
+ * @param fx Extractor
+ * @param fft_size FFT size of the analyzer
+ * @param sample_rate Sample rate in Hz
+ * @return 0 on success, -EINVAL if fft_size exceeds CONFIG_AUDIO_FFT_MAX_SIZE
+ */
+int audio_features_init(struct audio_features *fx, size_t fft_size, uint32_t sample_rate);
+
+/**
+ * @brief Forgets the previous spectrum (flux restarts at 0).
+ */
+void audio_features_reset(struct audio_features *fx);
+
+/**
+ * @brief Computes one feature frame and queues it.
+ *
+ * Audio thread only. Counts a drop when the classifier lags by the whole
+ * ring.
+ *
+ * @param fx Extractor
+ * @param mag Magnitude spectrum, fft_size / 2 bins from DC
+ */
+void audio_features_compute(struct audio_features *fx, const float *mag);
+
+/**
+ * @brief Borrows the oldest queued frame.
+ *
+ * Consumer thread only. The frame stays valid until
+ * audio_features_release().
+ *
+ * @return 0 on success, -EAGAIN if the ring is empty
+ */
+int audio_features_get(struct audio_features *fx, const struct audio_feature_frame **frame);
+
+/**
+ * @brief Returns the frame borrowed with audio_features_get().
+ */
+void audio_features_release(struct audio_features *fx);
+
+/**
+ * @brief Frames dropped because the ring was full.
+ */
+static inline uint32_t audio_features_dropped(const struct audio_features *fx)
+{
+    return (uint32_t)atomic_get(&fx->dropped);
+}
+
+#endif // AUDIO_FEATURES_H
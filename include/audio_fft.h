@@ -0,0 +1,60 @@
+#ifndef AUDIO_FFT_H
+#define AUDIO_FFT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file audio_fft.h
+ * @brief Shared real FFT plans
+ *
+ * One plan per power-of-two size, created on first use and shared by all
+ * nodes. On Cortex-M with CONFIG_CMSIS_DSP the transforms run on
+ * arm_rfft_fast_f32(); elsewhere a radix-2 complex FFT of half the size
+ * with a real split step is used.
+ *
+ * Spectra use the CMSIS packed layout for both backends:
+ * out[0] = Re X[0], out[1] = Re X[N/2], out[2k], out[2k+1] = Re, Im X[k]
+ * for 0 < k < N/2. audio_fft_inverse(audio_fft_forward(x)) returns x.
+ */
+
+/**
+ * @brief Real FFT plan (opaque to callers).
+ */
+struct audio_fft;
+
+/**
+ * @brief Gets the shared plan for one transform size.
+ *
+ * Call from init code; plans are created under a lock but the transforms
+ * themselves only read the plan.
+ *
+ * @param size Transform size (power of two, 32 .. CONFIG_AUDIO_FFT_MAX_SIZE)
+ * @return Plan, or NULL for an unsupported size
+ */
+const struct audio_fft *audio_fft_plan(size_t size);
+
+/**
+ * @brief Transform size of a plan.
+ */
+size_t audio_fft_size(const struct audio_fft *plan);
+
+/**
+ * @brief Forward real FFT (unscaled).
+ *
+ * @param plan Plan from audio_fft_plan()
+ * @param in Time-domain input, size samples (used as scratch, clobbered)
+ * @param out Packed spectrum, size floats
+ */
+void audio_fft_forward(const struct audio_fft *plan, float *in, float *out);
+
+/**
+ * @brief Inverse real FFT (scaled by 1/size).
+ *
+ * @param plan Plan from audio_fft_plan()
+ * @param in Packed spectrum, size floats (used as scratch, clobbered)
+ * @param out Time-domain output, size samples
+ */
+void audio_fft_inverse(const struct audio_fft *plan, float *in, float *out);
+
+#endif // AUDIO_FFT_H
@@ -3,29 +3,7 @@
 
 #include <zephyr/kernel.h>
 #include <stdint.h>
-
-/**
- * @brief Total size of an audio block in bytes.
- */
-#define AUDIO_BLOCK_SIZE_BYTES  (CONFIG_AUDIO_BLOCK_SAMPLES * sizeof(int16_t))
-
-/**
- * @brief Audio block structure holding PCM data.
- *
- * This structure acts as a wrapper around the raw PCM data buffer.
- * It includes reference counting to allow zero-copy distribution to multiple nodes.
- *
- * @warning All data buffers must be allocated from the framework's memory slabs.
- *          Do not wrap hardware DMA buffers directly without modifying the release logic.
- *
- * @warning If adding new fields, update audio_block_get_writable() to copy them.
- */
-struct audio_block {
-    void *fifo_reserved;    /**< Required by Zephyr k_fifo */
-    int16_t *data;          /**< Pointer to PCM data buffer (allocated from slab) */
-    size_t data_len;        /**< Number of valid samples in the buffer */
-    atomic_t ref_count;     /**< Reference counter for memory management */
-};
+#include "audio_block.h"
 
 struct audio_node;
 
@@ -61,47 +39,39 @@ struct audio_node {
 };
 
 /**
- * @brief Allocates a new audio block.
- *
- * Allocates both the metadata wrapper and the data buffer from memory slabs.
- * Initialize the reference count to 1.
+ * @brief Starts the processing thread for an audio node.
  *
- * @return Pointer to the allocated audio block, or NULL if allocation failed.
+ * @param node Pointer to the audio node.
+ * @param stack Pointer to the stack memory area for the thread.
  */
-struct audio_block *audio_block_alloc(void);
+void audio_node_start(struct audio_node *node, k_thread_stack_t *stack);
 
 /**
- * @brief Releases a reference to an audio block.
+ * @brief Starts the processing thread with an explicit stack size and name.
  *
- * Decrements the reference count. If the count reaches zero, the memory
- * (both data buffer and wrapper) is freed back to the slabs.
+ * The name is used as thread name and for stack high-water tracking
+ * (CONFIG_AUDIO_STACK_STATS).
  *
- * @param block Pointer to the audio block to release.
+ * @param node Pointer to the audio node.
+ * @param stack Pointer to the stack memory area for the thread.
+ * @param stack_size Size of the stack in bytes.
+ * @param name Node name (may be NULL, referenced by the stack tracking).
  */
-void audio_block_release(struct audio_block *block);
+void audio_node_start_named(struct audio_node *node, k_thread_stack_t *stack,
+                            size_t stack_size, const char *name);
 
 /**
- * @brief Ensures an audio block is writable (exclusive).
- *
- * Checks if the reference count is > 1. If so, it allocates a new block,
- * copies the content, releases the old block, and updates the pointer.
- * This implements Copy-on-Write (CoW).
- *
- * @warning Triggers memory allocation. Can fail if slab is full (Copy Storm risk).
- * @warning Performs a shallow copy of metadata. Ensure struct updates are reflected here.
+ * @brief Starts the processing thread on a stack sized from the profile.
  *
- * @param block_ptr Address of the pointer to the audio block.
- * @return 0 on success, -ENOMEM if allocation failed (pointer remains unchanged).
- */
-int audio_block_get_writable(struct audio_block **block_ptr);
-
-/**
- * @brief Starts the processing thread for an audio node.
+ * Allocates the stack with k_thread_stack_alloc(). The size is taken from
+ * the profile installed with audio_stack_profile_set(), falling back to
+ * CONFIG_AUDIO_THREAD_STACK_SIZE for unknown names.
  *
  * @param node Pointer to the audio node.
- * @param stack Pointer to the stack memory area for the thread.
+ * @param name Node name used for the profile lookup.
+ * @return 0 on success, -ENOMEM if the stack could not be allocated.
  */
-void audio_node_start(struct audio_node *node, k_thread_stack_t *stack);
+int audio_node_start_profiled(struct audio_node *node, const char *name);
 
 /**
  * @brief Pushes an audio block to the node's output.
@@ -3,6 +3,8 @@
 
 #include <zephyr/kernel.h>
 #include <stdint.h>
+#include <errno.h>
+#include "audio_block.h"
 
 /**
  * @file audio_fw_v2.h
@@ -14,22 +16,6 @@
  * - User code (manual threading for custom scenarios)
  */
 
-/**
- * @brief Total size of an audio block in bytes.
- */
-#define AUDIO_BLOCK_SIZE_BYTES  (CONFIG_AUDIO_BLOCK_SAMPLES * sizeof(int16_t))
-
-/**
- * @brief Audio block structure holding PCM data.
- *
- * Simplified version without reference counting for sequential processing.
- * In sequential mode, blocks flow through the pipeline without sharing.
- */
-struct audio_block {
-    int16_t *data;          /**< Pointer to PCM data buffer */
-    size_t data_len;        /**< Number of valid samples in the buffer */
-};
-
 /**
  * @brief Forward declaration
  */
@@ -61,6 +47,50 @@ struct audio_node_api {
      * @param self Pointer to the node instance.
      */
     void (*reset)(struct audio_node *self);
+
+    /**
+     * @brief Sample rate change notification (optional).
+     *
+     * Called by the owning strip/mixer when the node joins a pipeline and
+     * whenever the pipeline's rate changes, always between two blocks.
+     * Nodes with rate-dependent coefficients recompute them here.
+     *
+     * @param self Pointer to the node instance.
+     * @param sample_rate New sample rate in Hz.
+     */
+    void (*set_sample_rate)(struct audio_node *self, uint32_t sample_rate);
+
+    /**
+     * @brief Set a parameter (optional).
+     *
+     * Called from the thread that processes the node, between two blocks.
+     * Nodes that support ramps move to the new value over @p ramp_samples
+     * samples; others apply it immediately.
+     *
+     * @param self Pointer to the node instance.
+     * @param id Node specific parameter id (e.g. NODE_VOL_PARAM_GAIN).
+     * @param value New value.
+     * @param ramp_samples Ramp length in samples, 0 for an immediate change.
+     * @return 0 on success, -EINVAL for an unknown id or bad value.
+     */
+    int (*set_param)(struct audio_node *self, uint32_t id, float value, uint32_t ramp_samples);
+
+    /**
+     * @brief Read a parameter (optional).
+     *
+     * @param self Pointer to the node instance.
+     * @param id Node specific parameter id.
+     * @param value Destination (ramp target if a ramp is running).
+     * @return 0 on success, -EINVAL for an unknown id.
+     */
+    int (*get_param)(struct audio_node *self, uint32_t id, float *value);
+
+    /**
+     * @brief Number of parameters (ids 0 .. param_count - 1).
+     *
+     * Lets presets capture every parameter of a node.
+     */
+    uint8_t param_count;
 };
 
 /**
@@ -74,20 +104,6 @@ struct audio_node {
     void *ctx;                           /**< Private context data for the node */
 };
 
-/**
- * @brief Allocates a new audio block.
- *
- * @return Pointer to the allocated audio block, or NULL if allocation failed.
- */
-struct audio_block *audio_block_alloc(void);
-
-/**
- * @brief Releases an audio block back to the memory pool.
- *
- * @param block Pointer to the audio block to release.
- */
-void audio_block_release(struct audio_block *block);
-
 /**
  * @brief Process a block through a node (convenience wrapper).
  *
@@ -116,6 +132,49 @@ static inline void audio_node_reset(struct audio_node *node)
     }
 }
 
+/**
+ * @brief Propagate a sample rate to a node (convenience wrapper).
+ *
+ * @param node The node to notify
+ * @param sample_rate Sample rate in Hz
+ */
+static inline void audio_node_set_sample_rate(struct audio_node *node, uint32_t sample_rate)
+{
+    if (node && node->vtable && node->vtable->set_sample_rate) {
+        node->vtable->set_sample_rate(node, sample_rate);
+    }
+}
+
+/**
+ * @brief Set a node parameter (convenience wrapper).
+ *
+ * Only safe from the thread that processes the node. Other threads go
+ * through channel_strip_set_param().
+ *
+ * @return 0 on success, -ENOTSUP if the node has no parameters
+ */
+static inline int audio_node_set_param(struct audio_node *node, uint32_t id, float value,
+                                       uint32_t ramp_samples)
+{
+    if (node && node->vtable && node->vtable->set_param) {
+        return node->vtable->set_param(node, id, value, ramp_samples);
+    }
+    return -ENOTSUP;
+}
+
+/**
+ * @brief Read a node parameter (convenience wrapper).
+ *
+ * @return 0 on success, -ENOTSUP if the node has no parameters
+ */
+static inline int audio_node_get_param(struct audio_node *node, uint32_t id, float *value)
+{
+    if (node && node->vtable && node->vtable->get_param) {
+        return node->vtable->get_param(node, id, value);
+    }
+    return -ENOTSUP;
+}
+
 // ============================================================================
 // Node Initialization Functions
 // ============================================================================
@@ -128,6 +187,9 @@ static inline void audio_node_reset(struct audio_node *node)
  */
 void node_sine_init(struct audio_node *node, float freq);
 
+/** @brief Sine parameter: frequency in Hz */
+#define NODE_SINE_PARAM_FREQ  0
+
 /**
  * @brief Initializes a volume control node.
  *
@@ -136,9 +198,16 @@ void node_sine_init(struct audio_node *node, float freq);
  */
 void node_vol_init(struct audio_node *node, float vol);
 
+/** @brief Volume parameter: linear gain factor (rampable) */
+#define NODE_VOL_PARAM_GAIN  0
+
 /**
  * @brief Updates the volume of a volume node.
  *
+ * Writes the node context directly; only use it while the node is not
+ * being processed. Running strips should use channel_strip_set_param()
+ * with NODE_VOL_PARAM_GAIN.
+ *
  * @param node Pointer to the volume node.
  * @param vol New volume factor.
  */
@@ -182,6 +251,182 @@ void node_analyzer_init(struct audio_node *node, float smoothing_factor);
  */
 int node_analyzer_get_stats(struct audio_node *node, struct analyzer_stats *stats);
 
+// ============================================================================
+// Oversampling Wrapper
+// ============================================================================
+
+/**
+ * @brief Initializes a wrapper that runs a nonlinear node oversampled.
+ *
+ * The inner node sees blocks of factor * n samples at factor times the
+ * pipeline rate, produced and consumed by polyphase half-band filters
+ * whose state lives in the wrapper. Parameters are forwarded to the inner
+ * node (ramps scaled to the inner rate). The inner node must not be added
+ * to a strip itself.
+ *
+ * @param node Wrapper node to initialize.
+ * @param inner Nonlinear node to run oversampled.
+ * @param factor Oversampling factor, 2 or 4.
+ * @return 0 on success, -EINVAL for a bad factor, -ENOMEM if all
+ *         CONFIG_AUDIO_OVERSAMPLE_MAX_NODES contexts are in use.
+ */
+int node_oversample_init(struct audio_node *node, struct audio_node *inner, uint8_t factor);
+
+/**
+ * @brief Latency added by the resampling filters.
+ *
+ * Pure group delay of the up/down filter pair, in samples at the pipeline
+ * rate, independent of the inner node. Use it to delay-compensate parallel
+ * paths.
+ *
+ * @param node Wrapper node.
+ * @return Latency in samples, 0 if node is not an oversampling wrapper.
+ */
+uint32_t node_oversample_get_latency(struct audio_node *node);
+
+// ============================================================================
+// Acoustic Echo Canceller
+// ============================================================================
+
+/**
+ * @brief Echo canceller tuning.
+ */
+struct aec_config {
+    float step_size;            /**< Normalized adaptation step, 0 .. 1 */
+    float dt_threshold;         /**< Geigel threshold: mic peak / reference peak */
+    uint16_t dt_hold_partitions; /**< Partitions adaptation stays frozen after double talk */
+};
+
+/**
+ * @brief Default echo canceller tuning (-6 dB Geigel threshold).
+ */
+#define AEC_DEFAULT_CONFIG {        \
+    .step_size = 0.5f,              \
+    .dt_threshold = 0.5f,           \
+    .dt_hold_partitions = 16,       \
+}
+
+/**
+ * @brief Echo canceller statistics.
+ */
+struct aec_stats {
+    float erle_db;                  /**< Smoothed echo return loss enhancement */
+    uint32_t double_talk_partitions; /**< Partitions with adaptation frozen */
+    uint32_t ref_underruns;         /**< Partitions short of reference samples */
+    uint32_t ref_overruns;          /**< Reference writes that found the ring full */
+};
+
+/** @brief AEC parameter: adaptation step size */
+#define NODE_AEC_PARAM_STEP          0
+/** @brief AEC parameter: Geigel double-talk threshold */
+#define NODE_AEC_PARAM_DT_THRESHOLD  1
+
+/**
+ * @brief Initializes an acoustic echo canceller node (mic path).
+ *
+ * Cancels up to CONFIG_AUDIO_AEC_PARTITIONS * CONFIG_AUDIO_AEC_PARTITION_SAMPLES
+ * samples of echo tail. Blocks are processed in whole partitions, so
+ * CONFIG_AUDIO_BLOCK_SAMPLES must be a multiple of the partition length;
+ * the tail of a shorter block passes through uncancelled.
+ *
+ * @param node Pointer to the node structure.
+ * @param config Tuning (NULL for AEC_DEFAULT_CONFIG).
+ * @return 0 on success, -EINVAL if step_size is outside [0, 1], dt_threshold
+ *         is not positive or the block size is not a multiple of the
+ *         partition length, -ENOMEM if all CONFIG_AUDIO_AEC_MAX_NODES are in use.
+ */
+int node_aec_init(struct audio_node *node, const struct aec_config *config);
+
+/**
+ * @brief Initializes the reference tap of an echo canceller.
+ *
+ * A pass-through node for the speaker strip. Every block it sees becomes
+ * echo reference for @p aec. The two strips may run on different threads.
+ *
+ * @param tap Node structure for the tap.
+ * @param aec Initialized echo canceller.
+ * @return 0 on success, -EINVAL if @p aec is not an echo canceller.
+ */
+int node_aec_ref_init(struct audio_node *tap, struct audio_node *aec);
+
+/**
+ * @brief Feeds echo reference samples without a tap node.
+ *
+ * Same single-producer rules as the tap: one feeding thread per canceller.
+ *
+ * @return 0 on success, -EINVAL for a bad node.
+ */
+int node_aec_push_reference(struct audio_node *aec, const int16_t *samples, size_t count);
+
+/**
+ * @brief Reads echo canceller statistics.
+ *
+ * @return 0 on success, -EINVAL for a bad node.
+ */
+int node_aec_get_stats(struct audio_node *aec, struct aec_stats *stats);
+
+// ============================================================================
+// Noise Suppressor
+// ============================================================================
+
+/**
+ * @brief Noise suppressor tuning.
+ */
+struct noise_suppressor_config {
+    float max_attenuation_db;   /**< Gain floor, limits musical noise */
+    float oversubtraction;      /**< Noise estimate multiplier in the subtraction */
+    float gain_smoothing;       /**< Per-bin gain release per frame, 0 (none) .. <1 */
+    uint16_t noise_window_ms;   /**< Minimum-statistics search window */
+};
+
+/**
+ * @brief Default noise suppressor tuning.
+ */
+#define NOISE_SUPPRESSOR_DEFAULT_CONFIG {   \
+    .max_attenuation_db = 15.0f,            \
+    .oversubtraction = 2.0f,                \
+    .gain_smoothing = 0.7f,                 \
+    .noise_window_ms = 1500,                \
+}
+
+/**
+ * @brief Noise suppressor statistics.
+ */
+struct noise_suppressor_stats {
+    float noise_dbfs;           /**< Tracked noise level, dB re full-scale RMS */
+    float gain_db;              /**< Mean gain over bins of the last frame */
+    uint32_t frames;            /**< STFT frames processed */
+};
+
+/** @brief Noise suppressor parameter: maximum attenuation in dB */
+#define NODE_NS_PARAM_MAX_ATTENUATION   0
+/** @brief Noise suppressor parameter: oversubtraction factor */
+#define NODE_NS_PARAM_OVERSUBTRACTION   1
+
+/**
+ * @brief Initializes a spectral-subtraction noise suppressor node.
+ *
+ * Runs on a CONFIG_AUDIO_NS_FFT_SIZE STFT with half overlap and adds
+ * CONFIG_AUDIO_NS_FFT_SIZE - 1 samples of latency. The noise spectrum is
+ * tracked by minimum statistics, so stationary noise is learned while
+ * speech is present; it takes about one noise window to settle.
+ *
+ * @param node Pointer to the node structure.
+ * @param config Tuning (NULL for NOISE_SUPPRESSOR_DEFAULT_CONFIG).
+ * @return 0 on success, -EINVAL for a bad configuration, -ENOMEM if all
+ *         CONFIG_AUDIO_NS_MAX_NODES are in use.
+ */
+int node_noise_suppressor_init(struct audio_node *node,
+                               const struct noise_suppressor_config *config);
+
+/**
+ * @brief Reads noise suppressor statistics.
+ *
+ * @return 0 on success, -EINVAL for a bad node.
+ */
+int node_noise_suppressor_get_stats(struct audio_node *node,
+                                    struct noise_suppressor_stats *stats);
+
 // ============================================================================
 // Spectrum Analyzer Node (Large Window Example)
 // ============================================================================
@@ -206,6 +451,7 @@ struct spectrum_analyzer_config {
     enum spectrum_window_type window;    // Window function type
     bool compute_phase;                  // Whether to compute phase spectrum
     float magnitude_floor_db;            // Floor for magnitude in dB
+    bool compute_features;               // Feature frames (CONFIG_AUDIO_SPECTRUM_FEATURES)
 };
 
 /**
@@ -217,6 +463,7 @@ struct spectrum_analyzer_config {
     .window = SPECTRUM_WINDOW_HANN,             \
     .compute_phase = false,                     \
     .magnitude_floor_db = -120.0f,              \
+    .compute_features = false,                  \
 }
 
 /**
@@ -312,4 +559,270 @@ float spectrum_analyzer_bin_to_freq(size_t bin_index,
  */
 uint32_t node_spectrum_analyzer_get_process_count(struct audio_node *node);
 
+struct audio_feature_frame;
+
+/**
+ * @brief Borrows the oldest classifier feature frame (see audio_features.h).
+ *
+ * Zero-copy: the frame is read in place and returned with
+ * node_spectrum_analyzer_release_features(). One consumer thread per
+ * analyzer; it may differ from the thread processing the node.
+ *
+ * @param node Pointer to the spectrum analyzer node.
+ * @param frame Set to the frame.
+ * @return 0 on success, -EAGAIN if no frame is queued, -ENOTSUP if the
+ *         analyzer was not configured with compute_features, -EINVAL on error.
+ */
+int node_spectrum_analyzer_get_features(struct audio_node *node,
+                                        const struct audio_feature_frame **frame);
+
+/**
+ * @brief Returns the frame borrowed with node_spectrum_analyzer_get_features().
+ *
+ * @return 0 on success, -ENOTSUP without features, -EINVAL on error.
+ */
+int node_spectrum_analyzer_release_features(struct audio_node *node);
+
+/**
+ * @brief Get number of feature frames dropped because the ring was full.
+ *
+ * @param node Pointer to the spectrum analyzer node.
+ * @return Dropped frames (0 without features).
+ */
+uint32_t node_spectrum_analyzer_get_features_dropped(struct audio_node *node);
+
+// ============================================================================
+// Pitch Detector
+// ============================================================================
+
+/**
+ * @brief Pitch detector configuration.
+ */
+struct pitch_config {
+    float min_hz;               /**< Lowest fundamental searched, sets the frame length */
+    float max_hz;               /**< Highest fundamental searched */
+    float threshold;            /**< YIN absolute threshold on the normalized difference */
+    uint16_t hop_size;          /**< Samples between estimates, power of two (0 = one frame) */
+};
+
+/**
+ * @brief Default pitch detector configuration (voice range, ~10 ms hop at 48 kHz).
+ */
+#define PITCH_DEFAULT_CONFIG {      \
+    .min_hz = 70.0f,                \
+    .max_hz = 1000.0f,              \
+    .threshold = 0.15f,             \
+    .hop_size = 512,                \
+}
+
+/**
+ * @brief One pitch estimate.
+ */
+struct pitch_result {
+    float frequency_hz;         /**< Estimated fundamental, 0 when unvoiced */
+    float confidence;           /**< 1 - normalized difference at the chosen lag, 0 .. 1 */
+    bool voiced;                /**< Normalized difference fell below the threshold */
+    uint32_t sequence;          /**< Estimate counter, increments once per hop */
+};
+
+/** @brief Pitch parameter: YIN threshold */
+#define NODE_PITCH_PARAM_THRESHOLD  0
+
+/**
+ * @brief Initializes a YIN pitch detector node.
+ *
+ * Audio passes through untouched. Every hop the node evaluates the YIN
+ * difference function over the last frame via FFT cross-correlation on
+ * the shared STFT/FFT infrastructure (O(N log N) instead of O(N^2)).
+ *
+ * @param node Pointer to the node structure.
+ * @param config Configuration (NULL for PITCH_DEFAULT_CONFIG).
+ * @return 0 on success, -EINVAL for a bad range or hop, or when the
+ *         frame for min_hz exceeds CONFIG_AUDIO_FFT_MAX_SIZE, -ENOMEM if
+ *         all CONFIG_AUDIO_PITCH_MAX_NODES are in use.
+ */
+int node_pitch_init(struct audio_node *node, const struct pitch_config *config);
+
+/**
+ * @brief Reads the latest pitch estimate.
+ *
+ * Lock-free: safe from any thread while the node is processed, the
+ * estimate is published with a sequence lock and never torn.
+ *
+ * @param node Pitch detector node.
+ * @param result Destination.
+ * @return 0 on success, -EAGAIN before the first estimate, -EINVAL for a
+ *         bad node.
+ */
+int node_pitch_get(struct audio_node *node, struct pitch_result *result);
+
+// ============================================================================
+// Feedback Suppressor
+// ============================================================================
+
+/**
+ * @brief Feedback suppressor tuning.
+ */
+struct feedback_suppressor_config {
+    uint8_t max_notches;        /**< Notches deployed at once, up to CONFIG_AUDIO_BIQUAD_MAX_STAGES */
+    float notch_q;              /**< Notch center frequency / bandwidth */
+    float max_depth_db;         /**< Deepest notch */
+    float depth_step_db;        /**< Depth of a new notch, and added per retrigger */
+    float threshold_db;         /**< Peak over its spectral neighbourhood to count as feedback */
+    float min_level_dbfs;       /**< Quieter peaks are ignored (sine level, dBFS) */
+    uint16_t detect_ms;         /**< Time a peak must persist before a notch acts */
+    uint16_t hold_ms;           /**< Notch held at depth after its last trigger */
+    uint16_t release_ms;        /**< Ramp from max_depth_db back to 0 dB */
+};
+
+/**
+ * @brief Default feedback suppressor tuning (1/20 octave notches).
+ */
+#define FEEDBACK_SUPPRESSOR_DEFAULT_CONFIG {    \
+    .max_notches = 6,                           \
+    .notch_q = 30.0f,                           \
+    .max_depth_db = 18.0f,                      \
+    .depth_step_db = 6.0f,                      \
+    .threshold_db = 20.0f,                      \
+    .min_level_dbfs = -50.0f,                   \
+    .detect_ms = 150,                           \
+    .hold_ms = 5000,                            \
+    .release_ms = 10000,                        \
+}
+
+/**
+ * @brief One deployed notch.
+ */
+struct feedback_suppressor_notch {
+    float frequency_hz;
+    float depth_db;             /**< Attenuation at frequency_hz, positive */
+};
+
+/**
+ * @brief Feedback suppressor statistics.
+ */
+struct feedback_suppressor_stats {
+    uint8_t active_notches;     /**< Notches currently in the cascade */
+    uint32_t deployed;          /**< Notches placed at a new frequency */
+    uint32_t frames;            /**< Analysis frames processed */
+};
+
+/** @brief Feedback suppressor parameter: detection threshold in dB */
+#define NODE_FBS_PARAM_THRESHOLD    0
+/** @brief Feedback suppressor parameter: maximum notch depth in dB */
+#define NODE_FBS_PARAM_MAX_DEPTH    1
+
+/**
+ * @brief Initializes an acoustic feedback suppressor node.
+ *
+ * Tracks narrow, persistent peaks in the input spectrum (analysis-only
+ * STFT of CONFIG_AUDIO_FBS_FFT_SIZE) and places adaptive notch filters on
+ * them, run as one biquad cascade over the block. Notches deepen while
+ * the peak persists and are released after hold_ms. Adds no latency.
+ *
+ * @param node Pointer to the node structure.
+ * @param config Tuning (NULL for FEEDBACK_SUPPRESSOR_DEFAULT_CONFIG).
+ * @return 0 on success, -EINVAL for a bad configuration, -ENOMEM if all
+ *         CONFIG_AUDIO_FBS_MAX_NODES are in use.
+ */
+int node_feedback_suppressor_init(struct audio_node *node,
+                                  const struct feedback_suppressor_config *config);
+
+/**
+ * @brief Lists the deployed notches.
+ *
+ * Meant for displays; read from another thread the list may mix two
+ * analysis frames.
+ *
+ * @param node Feedback suppressor node.
+ * @param notches Destination.
+ * @param max_notches Capacity of @p notches.
+ * @return Number of notches written, -EINVAL for a bad node.
+ */
+int node_feedback_suppressor_get_notches(struct audio_node *node,
+                                         struct feedback_suppressor_notch *notches,
+                                         size_t max_notches);
+
+/**
+ * @brief Reads feedback suppressor statistics.
+ *
+ * @return 0 on success, -EINVAL for a bad node.
+ */
+int node_feedback_suppressor_get_stats(struct audio_node *node,
+                                       struct feedback_suppressor_stats *stats);
+
+// ============================================================================
+// Beamformer
+// ============================================================================
+
+#if defined(CONFIG_AUDIO_NODE_BEAMFORMER)
+
+/**
+ * @brief Microphone position in the array plane, relative to any origin.
+ */
+struct beamformer_mic {
+    float x_mm;
+    float y_mm;
+};
+
+/**
+ * @brief Beamformer configuration.
+ */
+struct beamformer_config {
+    uint8_t mics;               /**< Interleaved input channels, 2 .. CONFIG_AUDIO_BEAMFORMER_MAX_MICS */
+    uint8_t beams;              /**< Interleaved output channels, 1 .. mics and CONFIG_AUDIO_BEAMFORMER_MAX_BEAMS */
+    float speed_of_sound;       /**< m/s, 0 for 343 */
+    struct beamformer_mic positions[CONFIG_AUDIO_BEAMFORMER_MAX_MICS];
+};
+
+/** @brief Beamformer parameter: steering azimuth of @p beam in degrees */
+#define NODE_BEAMFORMER_PARAM_AZIMUTH(beam)  ((uint32_t)(beam))
+
+/**
+ * @brief Initializes a delay-and-sum beamformer node.
+ *
+ * Input blocks carry interleaved frames of config->mics channels, as a
+ * TDM or multi-PDM capture delivers them; output blocks carry interleaved
+ * frames of config->beams channels (a plain mono block for one beam), in
+ * place. Each beam delays every mic by a fractional number of samples
+ * (4-tap Lagrange interpolation), weights it and sums, in one Q15 pass.
+ *
+ * All beams start steered to azimuth 0 (the +x axis) with equal weights
+ * 1 / mics. NODE_BEAMFORMER_PARAM_AZIMUTH() steers a beam in the plane
+ * of the array, counterclockwise from +x, from the next block on. With a
+ * ramp the beam crossfades from the old direction to the new one over
+ * ramp_samples frames. The node adds one sample of latency on top of the
+ * steering delays. Raising the sample rate above CONFIG_AUDIO_SAMPLE_RATE
+ * may need delays beyond CONFIG_AUDIO_BEAMFORMER_MAX_DELAY; they are then
+ * clamped and a warning is logged.
+ *
+ * @param node Pointer to the node structure.
+ * @param config Channel counts and mic positions.
+ * @return 0 on success, -EINVAL for a bad configuration or an array whose
+ *         aperture needs more than CONFIG_AUDIO_BEAMFORMER_MAX_DELAY
+ *         samples at CONFIG_AUDIO_SAMPLE_RATE, -ENOMEM if all
+ *         CONFIG_AUDIO_BEAMFORMER_MAX_NODES are in use.
+ */
+int node_beamformer_init(struct audio_node *node, const struct beamformer_config *config);
+
+/**
+ * @brief Sets the delays and weights of one beam directly.
+ *
+ * For arrays that are not planar, tapered weights or null steering. The
+ * beam no longer follows an azimuth until the next steering parameter.
+ * Writes the node context directly; only use it while the node is not
+ * being processed. Running strips should steer with
+ * channel_strip_set_param() and NODE_BEAMFORMER_PARAM_AZIMUTH().
+ *
+ * @param node Beamformer node.
+ * @param beam Beam index.
+ * @param delays Per-mic delay in samples, 0 .. CONFIG_AUDIO_BEAMFORMER_MAX_DELAY.
+ * @param weights Per-mic weight, -1 .. 1 (NULL for 1 / mics each).
+ * @return 0 on success, -EINVAL for a bad node, beam or delay.
+ */
+int node_beamformer_set_beam(struct audio_node *node, uint8_t beam, const float *delays,
+                             const float *weights);
+
+#endif /* CONFIG_AUDIO_NODE_BEAMFORMER */
+
 #endif // AUDIO_FW_V2_H
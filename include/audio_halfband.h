@@ -0,0 +1,84 @@
+#ifndef AUDIO_HALFBAND_H
+#define AUDIO_HALFBAND_H
+
+#include <zephyr/sys/util.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file audio_halfband.h
+ * @brief Polyphase half-band FIR interpolator and decimator (Q15)
+ *
+ * A half-band filter has every even tap zero except the center tap (0.5),
+ * so each 2x stage only convolves one polyphase branch of @c taps
+ * coefficients; the other branch is a plain delay. The branch dot product
+ * uses dual 16-bit MACs (SMLAD) on cores with the DSP extension.
+ *
+ * Both directions delay the high-rate signal by taps - 1 samples, i.e. an
+ * up/down pair around a 2x section adds taps - 1 samples at the base rate.
+ */
+
+/** @brief Largest supported branch length */
+#define AUDIO_HALFBAND_MAX_TAPS \
+    MAX(CONFIG_AUDIO_OVERSAMPLE_TAPS, CONFIG_AUDIO_OVERSAMPLE_STAGE2_TAPS)
+
+/**
+ * @brief 2x interpolator state.
+ */
+struct audio_halfband_up {
+    const int16_t *coeffs;  /**< Branch coefficients, shared between instances */
+    uint8_t taps;           /**< Branch length (even) */
+    uint8_t pos;            /**< Newest sample in hist[pos] and hist[pos + taps] */
+    int16_t hist[2 * AUDIO_HALFBAND_MAX_TAPS];
+};
+
+/**
+ * @brief 2x decimator state.
+ */
+struct audio_halfband_down {
+    const int16_t *coeffs;
+    uint8_t taps;
+    uint8_t pos;
+    int16_t even[2 * AUDIO_HALFBAND_MAX_TAPS];  /**< Filtered branch */
+    int16_t odd[2 * AUDIO_HALFBAND_MAX_TAPS];   /**< Delay branch */
+};
+
+/**
+ * @brief Designs the branch coefficients of a half-band lowpass.
+ *
+ * Blackman-windowed sinc, quantized to Q15 with a branch sum of exactly
+ * 1.0 so DC passes at unity gain.
+ *
+ * @param coeffs Destination, @p taps entries
+ * @param taps Branch length (even, 2 .. AUDIO_HALFBAND_MAX_TAPS)
+ * @return 0 on success, -EINVAL for a bad length
+ */
+int audio_halfband_design(int16_t *coeffs, size_t taps);
+
+/**
+ * @brief Initializes (or resets) an interpolator.
+ *
+ * @param f Filter state
+ * @param coeffs Coefficients from audio_halfband_design(), must stay valid
+ * @param taps Branch length used for the design
+ */
+void audio_halfband_up_init(struct audio_halfband_up *f, const int16_t *coeffs, size_t taps);
+
+/**
+ * @brief Upsamples @p n samples into 2 * @p n samples.
+ */
+void audio_halfband_up(struct audio_halfband_up *f, const int16_t *in, int16_t *out, size_t n);
+
+/**
+ * @brief Initializes (or resets) a decimator.
+ */
+void audio_halfband_down_init(struct audio_halfband_down *f, const int16_t *coeffs, size_t taps);
+
+/**
+ * @brief Downsamples 2 * @p n samples into @p n samples.
+ *
+ * @p out may alias @p in.
+ */
+void audio_halfband_down(struct audio_halfband_down *f, const int16_t *in, int16_t *out, size_t n);
+
+#endif // AUDIO_HALFBAND_H
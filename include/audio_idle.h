@@ -0,0 +1,117 @@
+#ifndef AUDIO_IDLE_H
+#define AUDIO_IDLE_H
+
+#include "audio_block.h"
+#include <zephyr/kernel.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @file audio_idle.h
+ * @brief Silence detection and idle residency accounting
+ *
+ * Sources run their blocks through audio_idle_gate() before pushing them
+ * downstream. After a configurable number of silent blocks the gate marks
+ * the last block with AUDIO_BLOCK_FLAG_IDLE and then swallows further
+ * silence, so strips and the mixer block in k_fifo_get() and the CPU can
+ * enter its idle state. The first block above the threshold is passed on
+ * immediately, which bounds the resume latency to one block.
+ */
+
+/**
+ * @brief Idle residency of a source, strip or mixer.
+ */
+struct audio_idle_stats {
+    bool idle;              /**< Currently idle */
+    uint32_t entries;       /**< Number of times idle was entered */
+    uint64_t idle_ms;       /**< Total time spent idle, including the current period */
+};
+
+/**
+ * @brief Residency bookkeeping embedded in detectors, strips and mixers.
+ */
+struct audio_idle_residency {
+    struct k_spinlock lock;
+    int64_t since;          /**< Uptime at which the current idle period began */
+    struct audio_idle_stats stats;
+};
+
+/**
+ * @brief Silence detector for one source.
+ */
+struct audio_idle_detector {
+    int16_t threshold;      /**< Peak magnitude at or below which a block counts as silent */
+    uint32_t hold_blocks;   /**< Silent blocks before the stream goes idle */
+    uint32_t quiet_blocks;  /**< Consecutive silent blocks seen so far */
+    bool idle;
+    struct audio_idle_residency residency;
+};
+
+#if defined(CONFIG_AUDIO_IDLE)
+
+/**
+ * @brief Resets residency counters.
+ */
+void audio_idle_residency_init(struct audio_idle_residency *res);
+
+/**
+ * @brief Starts an idle period (no-op if already idle).
+ */
+void audio_idle_residency_enter(struct audio_idle_residency *res);
+
+/**
+ * @brief Ends the current idle period (no-op if not idle).
+ */
+void audio_idle_residency_leave(struct audio_idle_residency *res);
+
+/**
+ * @brief Reads residency counters.
+ *
+ * @param res Residency to read
+ * @param stats Destination
+ */
+void audio_idle_residency_get(struct audio_idle_residency *res, struct audio_idle_stats *stats);
+
+/**
+ * @brief Initializes a silence detector.
+ *
+ * @param det Detector to initialize
+ * @param threshold Peak magnitude treated as silence (e.g. 32 for -60 dBFS)
+ * @param hold_blocks Silent blocks before going idle (>= 1)
+ */
+void audio_idle_detector_init(struct audio_idle_detector *det, int16_t threshold,
+                              uint32_t hold_blocks);
+
+/**
+ * @brief Decides whether a source block is emitted.
+ *
+ * Returns @p block unchanged while there is signal or the hold time has
+ * not elapsed yet. The block that completes the hold time is returned with
+ * AUDIO_BLOCK_FLAG_IDLE set. While idle, silent blocks are released and
+ * NULL is returned.
+ *
+ * @param det Detector of the source
+ * @param block Block produced by the source (ownership passes to the gate)
+ * @return Block to push downstream, or NULL if nothing should be pushed
+ */
+struct audio_block *audio_idle_gate(struct audio_idle_detector *det, struct audio_block *block);
+
+/**
+ * @brief Returns whether the detector's stream is currently idle.
+ */
+static inline bool audio_idle_is_idle(const struct audio_idle_detector *det)
+{
+    return det->idle;
+}
+
+#else
+
+static inline struct audio_block *audio_idle_gate(struct audio_idle_detector *det,
+                                                  struct audio_block *block)
+{
+    return block;
+}
+
+#endif /* CONFIG_AUDIO_IDLE */
+
+#endif // AUDIO_IDLE_H
@@ -0,0 +1,103 @@
+#ifndef AUDIO_MOD_H
+#define AUDIO_MOD_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/slist.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @file audio_mod.h
+ * @brief Control-rate modulation sources for node parameters
+ *
+ * Sources (LFO, envelope, random) are evaluated once per block by the
+ * thread that processes the strip. Each binding turns the source output
+ * into center + depth * value and hands it to the node's set_param with
+ * a ramp over the block, so nodes with per-sample ramps interpolate
+ * between control points and the per-sample cost is only the ramp.
+ */
+
+/**
+ * @brief Modulation source shapes.
+ */
+enum audio_mod_type {
+    AUDIO_MOD_LFO_SINE,      /**< -1..1 sine */
+    AUDIO_MOD_LFO_TRIANGLE,  /**< -1..1 triangle */
+    AUDIO_MOD_LFO_SQUARE,    /**< -1 or 1 */
+    AUDIO_MOD_ENVELOPE,      /**< 0..1 attack/release envelope following a gate */
+    AUDIO_MOD_RANDOM,        /**< -1..1 smoothed random walk (new target every period) */
+};
+
+/**
+ * @brief A modulation source.
+ *
+ * A source belongs to one strip (or mixer); it advances once per block
+ * no matter how many bindings use it.
+ */
+struct audio_mod_source {
+    enum audio_mod_type type;
+    float rate_hz;          /**< LFO frequency or random target rate */
+    float attack_s;         /**< Envelope attack time */
+    float release_s;        /**< Envelope release time */
+    float phase;            /**< Position in the current period, 0..1 */
+    float value;            /**< Current output */
+    float start;            /**< Random: value at the start of the period */
+    float target;           /**< Random: value at the end of the period */
+    uint32_t rng;           /**< Random: xorshift32 state */
+    atomic_t gate;          /**< Envelope: gate set by audio_mod_env_gate() */
+    uint32_t tick;          /**< Driving thread's block tick it last advanced in */
+};
+
+/**
+ * @brief Connects a source to one node parameter.
+ *
+ * The binding is linked into the strip, so it must stay valid while bound.
+ */
+struct audio_mod_binding {
+    sys_snode_t snode;
+    struct audio_mod_source *source;
+    uint8_t node;           /**< Node index in the strip */
+    uint32_t param;         /**< Node specific parameter id */
+    float center;           /**< Parameter value for a source output of 0 */
+    float depth;            /**< Parameter change per unit of source output */
+};
+
+/**
+ * @brief Initializes an LFO.
+ *
+ * @param src Source to initialize
+ * @param type AUDIO_MOD_LFO_SINE, AUDIO_MOD_LFO_TRIANGLE or AUDIO_MOD_LFO_SQUARE
+ * @param rate_hz LFO frequency
+ */
+void audio_mod_lfo_init(struct audio_mod_source *src, enum audio_mod_type type, float rate_hz);
+
+/**
+ * @brief Initializes a linear attack/release envelope (starts closed).
+ */
+void audio_mod_env_init(struct audio_mod_source *src, float attack_ms, float release_ms);
+
+/**
+ * @brief Opens or closes an envelope's gate (any thread).
+ */
+void audio_mod_env_gate(struct audio_mod_source *src, bool open);
+
+/**
+ * @brief Initializes a smoothed random source.
+ *
+ * @param src Source to initialize
+ * @param rate_hz New random targets per second
+ * @param seed Non-zero seed
+ */
+void audio_mod_random_init(struct audio_mod_source *src, float rate_hz, uint32_t seed);
+
+/**
+ * @brief Advances a source by a number of samples and returns its output.
+ *
+ * @param src Source
+ * @param samples Samples elapsed since the last call
+ * @param sample_rate Pipeline rate in Hz
+ * @return New output value
+ */
+float audio_mod_advance(struct audio_mod_source *src, uint32_t samples, uint32_t sample_rate);
+
+#endif // AUDIO_MOD_H
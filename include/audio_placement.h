@@ -0,0 +1,53 @@
+#ifndef AUDIO_PLACEMENT_H
+#define AUDIO_PLACEMENT_H
+
+#include <zephyr/toolchain.h>
+#include <zephyr/linker/section_tags.h>
+
+/**
+ * @file audio_placement.h
+ * @brief Linker placement of block pools, node state and hot DSP code
+ *
+ * Selected in Kconfig (menu "Memory placement"). On Cortex-M7 parts the
+ * TCM options require the zephyr,dtcm / zephyr,itcm chosen nodes.
+ * The "named section" options place objects into a section that the board
+ * linker script must collect; native_sim keeps them as orphan sections,
+ * which is what tests/pool_placement checks.
+ */
+
+/**
+ * @brief Section attribute for block pool buffers (not zero-initialized).
+ */
+#if defined(CONFIG_AUDIO_POOL_PLACEMENT_DTCM)
+#define __audio_pool __dtcm_noinit_section
+#elif defined(CONFIG_AUDIO_POOL_PLACEMENT_SECTION)
+#define __audio_pool __attribute__((section(CONFIG_AUDIO_POOL_SECTION)))
+#else
+#define __audio_pool
+#endif
+
+/**
+ * @brief Section attribute for static node context arenas (zero-initialized).
+ */
+#if defined(CONFIG_AUDIO_NODE_STATE_PLACEMENT_DTCM)
+#define __audio_node_state __dtcm_bss_section
+#elif defined(CONFIG_AUDIO_NODE_STATE_PLACEMENT_SECTION)
+#define __audio_node_state __attribute__((section(CONFIG_AUDIO_NODE_STATE_SECTION)))
+#else
+#define __audio_node_state
+#endif
+
+/**
+ * @brief Function attribute for per-sample DSP kernels and the block hot path.
+ */
+#if defined(CONFIG_AUDIO_HOT_CODE_PLACEMENT_ITCM)
+#define __audio_hot __attribute__((section(".itcm.audio_hot"), noinline))
+#elif defined(CONFIG_AUDIO_HOT_CODE_PLACEMENT_RAMFUNC)
+#define __audio_hot __ramfunc
+#elif defined(CONFIG_AUDIO_HOT_CODE_PLACEMENT_SECTION)
+#define __audio_hot __attribute__((section(CONFIG_AUDIO_HOT_CODE_SECTION), noinline))
+#else
+#define __audio_hot
+#endif
+
+#endif // AUDIO_PLACEMENT_H
@@ -0,0 +1,116 @@
+#ifndef AUDIO_PRESET_H
+#define AUDIO_PRESET_H
+
+#include "channel_strip.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @file audio_preset.h
+ * @brief Whole-strip and whole-mixer parameter snapshots
+ *
+ * A preset is a flat list of (strip, node, parameter, value, ramp) entries.
+ * Capture walks every parameter each node reports through param_count.
+ * Apply hands the whole list to the processing thread in one command, so
+ * all values change at the same block boundary with no audible
+ * intermediate states.
+ */
+
+/** @brief Strip index of the mixer's master strip in preset entries */
+#define AUDIO_PRESET_MASTER  0xFE
+
+/**
+ * @brief One captured parameter.
+ */
+struct audio_preset_entry {
+    uint8_t strip;          /**< Channel index, 0 for a lone strip, or AUDIO_PRESET_MASTER */
+    uint8_t node;           /**< Node index within the strip */
+    uint16_t id;            /**< Node specific parameter id */
+    float value;            /**< Parameter value */
+    uint32_t ramp_samples;  /**< Ramp used when the preset is applied (0 = jump) */
+};
+
+/**
+ * @brief Preset blob.
+ */
+struct audio_preset {
+    atomic_t pending;       /**< Applies queued but not yet executed */
+    uint16_t count;         /**< Valid entries */
+    struct audio_preset_entry entries[CONFIG_AUDIO_PRESET_MAX_PARAMS];
+};
+
+/**
+ * @brief Empties a preset.
+ */
+void audio_preset_init(struct audio_preset *preset);
+
+/**
+ * @brief Sets the same ramp length for every entry.
+ *
+ * Entries can also be edited individually for per-parameter ramps.
+ */
+void audio_preset_set_ramp(struct audio_preset *preset, uint32_t ramp_samples);
+
+/**
+ * @brief Returns true while an apply of this preset is still queued.
+ *
+ * A queued preset must stay valid and unmodified until this returns false.
+ */
+static inline bool audio_preset_is_pending(const struct audio_preset *preset)
+{
+    return atomic_get(&preset->pending) != 0;
+}
+
+/**
+ * @brief Captures all parameters of a strip (strip index 0).
+ *
+ * Reads ramp targets through each node's get_param. While the strip is
+ * running, each read is queued like channel_strip_read_param() and answered
+ * by the processing thread between blocks, so the caller must not be that
+ * thread. Call it while no other thread is changing the same strip to get
+ * a consistent scene.
+ *
+ * @return 0 on success, -ENOMEM if the preset is too small, -EAGAIN if the
+ *         processing thread did not answer a read, -ENOSPC if the strip's
+ *         command ring is full
+ */
+int channel_strip_preset_capture(struct channel_strip *strip, struct audio_preset *preset);
+
+/**
+ * @brief Applies a preset to a strip at its next block boundary.
+ *
+ * Entries whose strip index is not 0 are ignored.
+ *
+ * @return 0 on success, -ENOSPC if the strip's command ring is full
+ */
+int channel_strip_preset_apply(struct channel_strip *strip, struct audio_preset *preset);
+
+/**
+ * @brief Captures all parameters of every channel and the master strip.
+ *
+ * Reads go through the mixer thread while it runs, as for
+ * channel_strip_preset_capture().
+ *
+ * @return 0 on success, -ENOMEM if the preset is too small, -EAGAIN or
+ *         -ENOSPC as for channel_strip_preset_capture()
+ */
+int audio_mixer_preset_capture(struct audio_mixer *mixer, struct audio_preset *preset);
+
+/**
+ * @brief Applies a preset to all strips of a mixer at one block boundary.
+ *
+ * @return 0 on success, -EBUSY if another preset is still queued
+ */
+int audio_mixer_preset_apply(struct audio_mixer *mixer, struct audio_preset *preset);
+
+/**
+ * @brief Executes the entries meant for one strip (processing thread only).
+ *
+ * @param strip Target strip
+ * @param preset Preset to apply
+ * @param strip_index Index the strip has in the preset
+ */
+void audio_preset_apply_to_strip(struct channel_strip *strip, const struct audio_preset *preset,
+                                 uint8_t strip_index);
+
+#endif // AUDIO_PRESET_H
@@ -0,0 +1,124 @@
+#ifndef AUDIO_STACK_H
+#define AUDIO_STACK_H
+
+#include <zephyr/kernel.h>
+#include <stddef.h>
+
+/**
+ * @file audio_stack.h
+ * @brief Stack high-water tracking and profile-based stack sizing
+ *
+ * Node (V1), strip and mixer threads register themselves when started.
+ * audio_stack_stats_report() prints the measured usage together with a
+ * ready-to-paste profile table. Feeding that table back through
+ * audio_stack_profile_set() lets the *_start_profiled() functions allocate
+ * right-sized stacks instead of one CONFIG_AUDIO_THREAD_STACK_SIZE for all.
+ */
+
+/**
+ * @brief Measured stack usage of one audio thread.
+ */
+struct audio_stack_stats {
+    const char *name;       /**< Node/strip name the thread was registered with */
+    size_t size;            /**< Stack size in bytes */
+    size_t used;            /**< High-water mark in bytes */
+    size_t recommended;     /**< used + CONFIG_AUDIO_STACK_MARGIN, rounded up */
+};
+
+/**
+ * @brief One entry of a measured stack profile.
+ */
+struct audio_stack_profile_entry {
+    const char *name;       /**< Node/strip name */
+    size_t stack_size;      /**< Stack size to allocate in bytes */
+};
+
+#if defined(CONFIG_AUDIO_STACK_STATS)
+
+/**
+ * @brief Registers an audio thread for high-water tracking.
+ *
+ * Called by audio_node_start(), channel_strip_start() and
+ * audio_mixer_start(); applications only need it for their own threads.
+ * Tracking a name again whose thread was untracked reuses its entry, so
+ * strips can be stopped and started any number of times.
+ *
+ * @param tid Thread to track
+ * @param name Name to report and to match in the profile (referenced,
+ *             must stay valid, may be NULL)
+ * @param stack_size Size of the thread's stack in bytes
+ * @return 0 on success, -ENOMEM if the tracking table is full
+ */
+int audio_stack_track(k_tid_t tid, const char *name, size_t stack_size);
+
+/**
+ * @brief Stops tracking a thread (e.g. before it is aborted).
+ *
+ * The last measured high-water mark is kept for the report. The entry is
+ * reused when the same name is tracked again, or for another thread once
+ * the table is full.
+ *
+ * @param tid Thread to forget
+ */
+void audio_stack_untrack(k_tid_t tid);
+
+/**
+ * @brief Gets the stack statistics of one tracked thread.
+ *
+ * @param index Index into the tracking table (0..n-1)
+ * @param stats Destination
+ * @return 0 on success, -ENOENT if index is past the last entry
+ */
+int audio_stack_stats_get(size_t index, struct audio_stack_stats *stats);
+
+/**
+ * @brief Logs usage of all tracked threads and a profile table.
+ */
+void audio_stack_stats_report(void);
+
+#else
+
+static inline int audio_stack_track(k_tid_t tid, const char *name, size_t stack_size)
+{
+    return 0;
+}
+
+static inline void audio_stack_untrack(k_tid_t tid)
+{
+}
+
+static inline int audio_stack_stats_get(size_t index, struct audio_stack_stats *stats)
+{
+    return -ENOTSUP;
+}
+
+static inline void audio_stack_stats_report(void)
+{
+}
+
+#endif /* CONFIG_AUDIO_STACK_STATS */
+
+#if defined(CONFIG_AUDIO_STACK_PROFILE)
+
+/**
+ * @brief Installs a measured stack profile.
+ *
+ * The table is referenced, not copied, and must stay valid.
+ *
+ * @param entries Profile table (typically the output of the report)
+ * @param count Number of entries
+ */
+void audio_stack_profile_set(const struct audio_stack_profile_entry *entries, size_t count);
+
+/**
+ * @brief Looks up the profiled stack size for a thread name.
+ *
+ * @param name Node/strip name
+ * @param fallback Size to return when the name is not in the profile
+ * @return Stack size in bytes
+ */
+size_t audio_stack_profile_lookup(const char *name, size_t fallback);
+
+#endif /* CONFIG_AUDIO_STACK_PROFILE */
+
+#endif // AUDIO_STACK_H
@@ -0,0 +1,136 @@
+#ifndef AUDIO_STFT_H
+#define AUDIO_STFT_H
+
+#include "audio_fw_v2.h"
+#include "audio_fft.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file audio_stft.h
+ * @brief STFT/ISTFT overlap-add base for spectral nodes
+ *
+ * Every hop_size samples the last fft_size input samples are windowed
+ * and transformed, a per-frame callback edits the packed spectrum (see
+ * audio_fft.h), and the inverse transform is windowed again and
+ * overlap-added into the output. Samples pass through one at a time, so
+ * block size and hop size are independent; the output lags the input by
+ * fft_size - 1 samples.
+ *
+ * Input and output are rings indexed with a mask and all frame buffers
+ * live in struct audio_stft, so the hot path neither moves history nor
+ * allocates. Plans come from audio_fft_plan() and are shared.
+ *
+ * Spectral nodes embed a struct audio_stft in their context and call
+ * audio_stft_process() from their process function, or use
+ * node_stft_init() when a callback is all they need.
+ */
+
+struct audio_stft;
+
+/**
+ * @brief Per-frame spectral callback.
+ *
+ * Runs on the processing thread. In synthesis mode the (modified)
+ * spectrum is resynthesized; in analysis-only mode it is discarded.
+ *
+ * @param stft STFT instance
+ * @param spec Packed spectrum, fft_size floats, may be modified in place
+ * @param user_data Pointer from the configuration
+ */
+typedef void (*audio_stft_frame_cb)(struct audio_stft *stft, float *spec, void *user_data);
+
+/**
+ * @brief STFT configuration.
+ */
+struct audio_stft_config {
+    uint16_t fft_size;          /**< Frame length, power of two up to CONFIG_AUDIO_FFT_MAX_SIZE */
+    uint16_t hop_size;          /**< Frame advance; fft_size / 2 or smaller with synthesis */
+    bool analysis_only;         /**< No resynthesis: samples pass through untouched */
+    audio_stft_frame_cb frame;  /**< Called once per hop */
+    void *user_data;            /**< Passed to the callback */
+};
+
+/**
+ * @brief STFT state, embedded in a node context.
+ *
+ * Fields are read-only for users, except window, which an analysis-only
+ * user may overwrite after audio_stft_init().
+ */
+struct audio_stft {
+    struct audio_stft_config config;
+    const struct audio_fft *fft;
+    float ola_scale;            /**< Makes analysis * synthesis window sum to 1 */
+    size_t mask;                /**< fft_size - 1 */
+    size_t pos;                 /**< Next input slot, also the next output slot */
+    size_t hop_fill;            /**< Samples collected towards the next frame */
+    size_t primed;              /**< Samples seen, saturates at fft_size */
+    uint32_t frames;            /**< Frames processed */
+
+    float window[CONFIG_AUDIO_FFT_MAX_SIZE];   /**< Analysis (and synthesis) window, sqrt-Hann */
+    int16_t in_ring[CONFIG_AUDIO_FFT_MAX_SIZE];
+    float out_ring[CONFIG_AUDIO_FFT_MAX_SIZE]; /**< Overlap-add accumulator */
+    float frame[CONFIG_AUDIO_FFT_MAX_SIZE];    /**< Time-domain frame */
+    float spec[CONFIG_AUDIO_FFT_MAX_SIZE];     /**< Packed spectrum handed to the callback */
+};
+
+/**
+ * @brief Initializes an STFT.
+ *
+ * @param stft State to initialize
+ * @param config Configuration (copied)
+ * @return 0 on success, -EINVAL for an unsupported size or hop
+ */
+int audio_stft_init(struct audio_stft *stft, const struct audio_stft_config *config);
+
+/**
+ * @brief Clears history and overlap-add state.
+ */
+void audio_stft_reset(struct audio_stft *stft);
+
+/**
+ * @brief Runs samples through the STFT in place.
+ *
+ * In analysis-only mode the samples are left untouched and frames start
+ * once fft_size samples have been seen, so no frame contains the zeroed
+ * history.
+ *
+ * @param stft STFT state
+ * @param samples Samples, replaced by the resynthesized output
+ * @param count Number of samples
+ */
+void audio_stft_process(struct audio_stft *stft, int16_t *samples, size_t count);
+
+/**
+ * @brief Reads sample @p i (0 = oldest) of the current frame.
+ *
+ * Valid inside the frame callback, for users that need the unwindowed
+ * time-domain frame next to its spectrum.
+ */
+static inline int16_t audio_stft_frame_sample(const struct audio_stft *stft, size_t i)
+{
+    return stft->in_ring[(stft->pos + i) & stft->mask];
+}
+
+/**
+ * @brief Input-to-output delay in samples (0 in analysis-only mode).
+ */
+uint32_t audio_stft_latency(const struct audio_stft *stft);
+
+/**
+ * @brief Initializes a node that runs an STFT callback.
+ *
+ * @param node Pointer to the node structure
+ * @param config STFT configuration with the frame callback
+ * @return 0 on success, -EINVAL for a bad configuration, -ENOMEM if all
+ *         CONFIG_AUDIO_STFT_MAX_NODES contexts are in use
+ */
+int node_stft_init(struct audio_node *node, const struct audio_stft_config *config);
+
+/**
+ * @brief Gets the STFT of a node created with node_stft_init().
+ */
+struct audio_stft *node_stft_get(struct audio_node *node);
+
+#endif // AUDIO_STFT_H
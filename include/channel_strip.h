@@ -2,6 +2,10 @@
 #define CHANNEL_STRIP_H
 
 #include "audio_fw_v2.h"
+#include "audio_stack.h"
+#include "audio_idle.h"
+#include "audio_cmd.h"
+#include "audio_mod.h"
 #include <zephyr/kernel.h>
 
 /**
@@ -20,6 +24,11 @@
 
 #define CHANNEL_STRIP_MAX_NODES  16  /**< Maximum nodes per channel strip */
 
+/** @brief Node index addressing every node of a strip (reset, bypass) */
+#define CHANNEL_STRIP_ALL_NODES  0xFF
+
+BUILD_ASSERT(CHANNEL_STRIP_MAX_NODES <= 32, "bypass_mask holds one bit per node");
+
 /**
  * @brief Channel strip structure.
  *
@@ -44,8 +53,85 @@ struct channel_strip {
     /** @brief Thread ID */
     k_tid_t thread_id;
 
+    /** @brief Thread suspended through channel_strip_suspend() */
+    bool suspended;
+
+    /** @brief Serializes suspend, resume and CPU moves of the thread */
+    struct k_mutex thread_lock;
+
     /** @brief User-defined name for debugging */
     const char *name;
+
+    /** @brief Sample rate of this pipeline in Hz */
+    uint32_t sample_rate;
+
+    /** @brief Rate change requested while running (0 = none), applied between blocks */
+    atomic_t pending_rate;
+
+    /** @brief Mixer running this strip as a channel or master (NULL = standalone) */
+    struct audio_mixer *mixer;
+
+    /** @brief Maximum input blocks processed per thread wake */
+    size_t batch_max;
+
+    /** @brief Smoothed processing cost in cycles per block (0 = not measured yet) */
+    uint32_t load_cycles;
+
+    /** @brief Bit n set: node n is skipped */
+    uint32_t bypass_mask;
+
+    /** @brief Control commands, drained between blocks by the processing thread */
+    struct audio_cmd_queue cmds;
+
+    /** @brief FIFO item that wakes the strip thread for commands alone */
+    struct {
+        void *fifo_reserved;
+    } cmd_wake;
+
+    /** @brief cmd_wake is queued in in_fifo */
+    atomic_t cmd_wake_pending;
+
+#if defined(CONFIG_AUDIO_SMP_AFFINITY)
+    /** @brief CPUs the strip thread may run on (bit n = CPU n, 0 = any) */
+    uint32_t cpu_mask;
+#endif
+
+#if defined(CONFIG_AUDIO_STRIP_DEADLINE)
+    /** @brief Schedule by block deadline (EDF) instead of fixed priority only */
+    bool deadline_mode;
+
+    /** @brief Batches that completed later than one block period after arrival */
+    uint32_t deadline_misses;
+
+    /** @brief Cycle count at which the oldest queued block arrived */
+    atomic_t arrival_cycles;
+
+    /** @brief Blocks in in_fifo, which may also hold the cmd_wake marker */
+    atomic_t queued_blocks;
+#endif
+
+#if defined(CONFIG_AUDIO_IDLE)
+    /** @brief Time spent waiting after an idle-marked block */
+    struct audio_idle_residency idle;
+#endif
+
+#if defined(CONFIG_AUDIO_MODULATION)
+    /** @brief Bound struct audio_mod_binding, evaluated once per block */
+    sys_slist_t mods;
+
+    /** @brief Modulation block counter of the strip thread */
+    uint32_t mod_tick;
+#endif
+
+#if defined(CONFIG_AUDIO_POOL_RESERVATIONS)
+    /** @brief Pool reservation class charged for blocks the strip allocates */
+    uint8_t pool_class;
+#endif
+
+#if defined(CONFIG_AUDIO_STACK_PROFILE)
+    /** @brief Stack allocated by channel_strip_start_profiled() (NULL otherwise) */
+    k_thread_stack_t *dyn_stack;
+#endif
 };
 
 /**
@@ -67,6 +153,29 @@ void channel_strip_init(struct channel_strip *strip, const char *name);
  */
 int channel_strip_add_node(struct channel_strip *strip, struct audio_node *node);
 
+/**
+ * @brief Sets the sample rate of the strip and propagates it to its nodes.
+ *
+ * Strips start at CONFIG_AUDIO_SAMPLE_RATE. If the strip thread is running
+ * the change is applied at the next block boundary; otherwise immediately.
+ * Strips driven by a mixer follow audio_mixer_set_sample_rate() instead.
+ *
+ * @param strip Pointer to the channel strip
+ * @param sample_rate Sample rate in Hz
+ * @return 0 on success, -EINVAL if sample_rate is 0, -EBUSY if the strip
+ *         is a mixer channel or master, or an earlier change is still
+ *         pending
+ */
+int channel_strip_set_sample_rate(struct channel_strip *strip, uint32_t sample_rate);
+
+/**
+ * @brief Returns the sample rate the strip currently runs at.
+ *
+ * @param strip Pointer to the channel strip
+ * @return Sample rate in Hz
+ */
+uint32_t channel_strip_get_sample_rate(const struct channel_strip *strip);
+
 /**
  * @brief Removes all nodes from the strip.
  *
@@ -90,6 +199,20 @@ void channel_strip_start(struct channel_strip *strip,
                           size_t stack_size,
                           int priority);
 
+/**
+ * @brief Starts the strip thread on a stack sized from the stack profile.
+ *
+ * The stack is allocated with k_thread_stack_alloc() using the size the
+ * profile (see audio_stack.h) lists for the strip's name, or
+ * CONFIG_AUDIO_THREAD_STACK_SIZE if the name is not profiled. It is freed
+ * again by channel_strip_stop().
+ *
+ * @param strip Pointer to the channel strip
+ * @param priority Thread priority (lower value = higher priority)
+ * @return 0 on success, -ENOMEM if the stack could not be allocated
+ */
+int channel_strip_start_profiled(struct channel_strip *strip, int priority);
+
 /**
  * @brief Stops the channel strip processing thread.
  *
@@ -97,6 +220,27 @@ void channel_strip_start(struct channel_strip *strip,
  */
 void channel_strip_stop(struct channel_strip *strip);
 
+/**
+ * @brief Suspends the strip thread.
+ *
+ * Use this instead of k_thread_suspend(): the strip records the state, so
+ * CPU moves (channel_strip_set_cpu_mask(), channel_strip_balance()) leave
+ * a suspended strip suspended. Blocks pushed meanwhile stay queued.
+ *
+ * @param strip Pointer to the channel strip
+ * @return 0 on success, -ESRCH if the strip is not started, -EDEADLK if
+ *         called from the strip thread
+ */
+int channel_strip_suspend(struct channel_strip *strip);
+
+/**
+ * @brief Resumes a strip thread suspended by channel_strip_suspend().
+ *
+ * @param strip Pointer to the channel strip
+ * @return 0 on success, -ESRCH if the strip is not started
+ */
+int channel_strip_resume(struct channel_strip *strip);
+
 /**
  * @brief Processes a single block through the channel strip (non-threaded).
  *
@@ -112,6 +256,237 @@ void channel_strip_stop(struct channel_strip *strip);
 struct audio_block* channel_strip_process_block(struct channel_strip *strip,
                                                  struct audio_block *block);
 
+/**
+ * @brief Processes a batch of blocks through the strip, node by node.
+ *
+ * Each node processes every block of the batch before the next node runs
+ * (node-major order), which keeps a node's code and state in cache and
+ * walks the chain once per batch. Blocks a node drops are removed from
+ * the array; the order of the remaining blocks is preserved.
+ *
+ * @param strip Pointer to the channel strip
+ * @param blocks In: input blocks. Out: output blocks.
+ * @param count Number of input blocks
+ * @return Number of output blocks left in @p blocks
+ */
+size_t channel_strip_process_batch(struct channel_strip *strip,
+                                   struct audio_block **blocks,
+                                   size_t count);
+
+/**
+ * @brief Limits how many queued blocks the strip thread processes per wake.
+ *
+ * Larger batches amortize the per-wake cost, smaller ones bound latency.
+ * Defaults to CONFIG_AUDIO_STRIP_BATCH_MAX.
+ *
+ * @param strip Pointer to the channel strip
+ * @param max_blocks 1 (no batching) to CONFIG_AUDIO_STRIP_BATCH_MAX
+ * @return 0 on success, -EINVAL if out of range
+ */
+int channel_strip_set_batch_limit(struct channel_strip *strip, size_t max_blocks);
+
+/**
+ * @brief Returns the strip's measured processing cost.
+ *
+ * Smoothed cycles per block spent in the node chain of the strip thread.
+ *
+ * @param strip Pointer to the channel strip
+ * @return Cycles per block, 0 if the strip has not processed anything yet
+ */
+uint32_t channel_strip_get_load(const struct channel_strip *strip);
+
+#if defined(CONFIG_AUDIO_SMP_AFFINITY)
+/**
+ * @brief Restricts the strip thread to a set of CPUs.
+ *
+ * May be called before or after channel_strip_start(), but not from the
+ * strip thread itself. A running thread is briefly suspended to move it;
+ * one suspended by channel_strip_suspend() stays suspended.
+ *
+ * @param strip Pointer to the channel strip
+ * @param cpu_mask Bit n allows CPU n; 0 allows all CPUs
+ * @return 0 on success, -EINVAL for CPUs that do not exist, -EDEADLK if
+ *         called from the strip thread
+ */
+int channel_strip_set_cpu_mask(struct channel_strip *strip, uint32_t cpu_mask);
+
+/**
+ * @brief Distributes strips over the CPUs by measured load.
+ *
+ * Greedy longest-processing-time assignment: strips are sorted by
+ * channel_strip_get_load() and each is pinned to the least loaded CPU.
+ * If any strip has not been measured yet (e.g. at startup) all strips are
+ * weighed by node count instead. Call again after reconfiguration or once
+ * the strips have run for a while.
+ *
+ * @param strips Strips to distribute
+ * @param count Number of strips (max CONFIG_AUDIO_SMP_BALANCE_MAX_STRIPS)
+ * @return 0 on success, negative error code otherwise
+ */
+int channel_strip_balance(struct channel_strip **strips, size_t count);
+#endif
+
+#if defined(CONFIG_AUDIO_STRIP_DEADLINE)
+/**
+ * @brief Enables earliest-deadline-first scheduling for the strip.
+ *
+ * On each wake the strip thread sets its deadline to the arrival of the
+ * block plus one block period (data_len / sample rate). Zephyr only orders
+ * threads of equal static priority by deadline, so give all EDF strips the
+ * same priority. Arrival is recorded by channel_strip_push_input().
+ *
+ * @param strip Pointer to the channel strip
+ * @param enable true for EDF, false for fixed priority only
+ */
+void channel_strip_set_deadline_mode(struct channel_strip *strip, bool enable);
+
+/**
+ * @brief Returns how many batches finished after their deadline.
+ *
+ * Counted in both modes, so fixed-priority and EDF setups can be compared.
+ *
+ * @param strip Pointer to the channel strip
+ * @return Number of deadline misses
+ */
+uint32_t channel_strip_get_deadline_misses(const struct channel_strip *strip);
+#endif
+
+#if defined(CONFIG_AUDIO_POOL_RESERVATIONS)
+/**
+ * @brief Charges the strip's block allocations to a reservation class.
+ *
+ * Covers generator output and CoW copies made inside the strip thread.
+ * Can be called before or after channel_strip_start().
+ *
+ * @param strip Pointer to the channel strip
+ * @param cls Class set up with audio_pool_reserve()
+ * @return 0 on success, negative errno from audio_pool_bind_thread()
+ */
+int channel_strip_set_pool_class(struct channel_strip *strip, uint8_t cls);
+#endif
+
+#if defined(CONFIG_AUDIO_IDLE)
+/**
+ * @brief Gets the idle residency of a strip.
+ *
+ * The strip is idle from the moment it has forwarded a block marked
+ * AUDIO_BLOCK_FLAG_IDLE until the next block arrives.
+ *
+ * @param strip Pointer to the channel strip
+ * @param stats Destination
+ */
+void channel_strip_get_idle_stats(struct channel_strip *strip, struct audio_idle_stats *stats);
+#endif
+
+/**
+ * @brief Queues a parameter change for a node of the strip.
+ *
+ * Safe from any thread or ISR. The change is applied by the thread that
+ * processes the strip (strip or mixer thread) before its next block.
+ *
+ * @param strip Pointer to the channel strip
+ * @param node Node index in processing order
+ * @param id Node specific parameter id
+ * @param value New value
+ * @param ramp_samples Ramp length in samples (0 = immediate)
+ * @return 0 on success, -EINVAL for a bad node index, -ENOSPC if the
+ *         command ring is full
+ */
+int channel_strip_set_param(struct channel_strip *strip, uint8_t node, uint32_t id,
+                            float value, uint32_t ramp_samples);
+
+/**
+ * @brief Queues bypassing (or re-enabling) a node.
+ *
+ * @param strip Pointer to the channel strip
+ * @param node Node index, or CHANNEL_STRIP_ALL_NODES
+ * @param bypass true to skip the node
+ * @return 0 on success, negative errno as for channel_strip_set_param()
+ */
+int channel_strip_set_bypass(struct channel_strip *strip, uint8_t node, bool bypass);
+
+/**
+ * @brief Queues a state reset of a node.
+ *
+ * @param strip Pointer to the channel strip
+ * @param node Node index, or CHANNEL_STRIP_ALL_NODES
+ * @return 0 on success, negative errno as for channel_strip_set_param()
+ */
+int channel_strip_reset_node(struct channel_strip *strip, uint8_t node);
+
+/**
+ * @brief Reads a node parameter at the next block boundary.
+ *
+ * Blocks the caller until the processing thread has drained the request,
+ * so the value is consistent with what the audio path uses.
+ *
+ * @param strip Pointer to the channel strip
+ * @param node Node index
+ * @param id Node specific parameter id
+ * @param value Destination
+ * @param timeout How long to wait for the next block boundary
+ * @return 0 on success, -EAGAIN on timeout, -ENOSPC if the ring is full,
+ *         or the node's get_param error
+ */
+int channel_strip_read_param(struct channel_strip *strip, uint8_t node, uint32_t id,
+                             float *value, k_timeout_t timeout);
+
+#if defined(CONFIG_AUDIO_MODULATION)
+/**
+ * @brief Binds a modulation source to a node parameter.
+ *
+ * Queued like any control command. From the next block on, the parameter
+ * follows center + depth * source output, ramped over each block.
+ *
+ * @param strip Pointer to the channel strip
+ * @param binding Caller-owned binding storage, valid until unbound
+ * @param source Source to follow (owned by this strip)
+ * @param node Node index
+ * @param param Node specific parameter id
+ * @param center Parameter value at source output 0
+ * @param depth Parameter change per unit of source output
+ * @return 0 on success, -EINVAL for a bad node index, -ENOSPC if the ring is full
+ */
+int channel_strip_mod_bind(struct channel_strip *strip, struct audio_mod_binding *binding,
+                           struct audio_mod_source *source, uint8_t node, uint32_t param,
+                           float center, float depth);
+
+/**
+ * @brief Removes a binding at the next block boundary.
+ *
+ * The parameter keeps its last modulated value.
+ *
+ * @return 0 on success, -ENOSPC if the ring is full
+ */
+int channel_strip_mod_unbind(struct channel_strip *strip, struct audio_mod_binding *binding);
+
+/**
+ * @brief Advances all bound sources and updates their parameters.
+ *
+ * Called by the strip and mixer threads before each batch/block. Code
+ * that drives a strip manually calls it before channel_strip_process_block().
+ * A source advances at most once per tick, so every strip sharing a source
+ * must be passed the same tick for the same block (the mixer passes one
+ * tick to all its strips).
+ *
+ * @param strip Pointer to the channel strip
+ * @param samples Samples about to be processed
+ * @param tick Block counter of the thread driving the strip, never 0
+ */
+void channel_strip_apply_modulation(struct channel_strip *strip, uint32_t samples,
+                                    uint32_t tick);
+#endif
+
+/**
+ * @brief Executes all queued control commands.
+ *
+ * Called by the strip and mixer threads between blocks. Code that drives
+ * a strip manually with channel_strip_process_block() calls it itself.
+ *
+ * @param strip Pointer to the channel strip
+ */
+void channel_strip_apply_commands(struct channel_strip *strip);
+
 /**
  * @brief Pushes a block to the strip's input FIFO.
  *
@@ -128,6 +503,44 @@ void channel_strip_push_input(struct channel_strip *strip, struct audio_block *b
 
 #define MIXER_MAX_CHANNELS  32  /**< Maximum number of channels in a mixer */
 
+#if defined(CONFIG_AUDIO_MIXER_AUTOMIX)
+/**
+ * @brief Automatic mix (gain sharing) tuning.
+ */
+struct audio_mixer_automix_config {
+    uint16_t attack_ms;     /**< Channel level detector rise time constant */
+    uint16_t release_ms;    /**< Channel level detector fall time constant */
+    float floor_dbfs;       /**< Level every channel counts with at least, RMS dBFS */
+};
+
+/**
+ * @brief Default automix tuning.
+ */
+#define AUDIO_MIXER_AUTOMIX_DEFAULT_CONFIG {    \
+    .attack_ms = 5,                             \
+    .release_ms = 150,                          \
+    .floor_dbfs = -60.0f,                       \
+}
+
+/**
+ * @brief Automix state of a mixer.
+ *
+ * Levels are mean squares of the int16 samples; gains are Q30 so the
+ * per-sample ramp step keeps its resolution over a block.
+ */
+struct audio_mixer_automix {
+    bool enabled;
+    struct audio_mixer_automix_config config;
+    uint32_t attack;                        /**< Per-block smoothing, Q16 */
+    uint32_t release;                       /**< Per-block smoothing, Q16 */
+    uint32_t floor;                         /**< floor_dbfs as a mean square */
+    uint32_t level[MIXER_MAX_CHANNELS];     /**< Smoothed channel levels */
+    uint32_t block_level[MIXER_MAX_CHANNELS];   /**< Mean square of the current block */
+    int32_t gain[MIXER_MAX_CHANNELS];       /**< Gain at the end of the last block */
+    int32_t target[MIXER_MAX_CHANNELS];     /**< Gain the current block ramps to */
+};
+#endif
+
 /**
  * @brief Mixer structure for managing multiple channel strips.
  *
@@ -155,6 +568,49 @@ struct audio_mixer {
 
     /** @brief Thread ID */
     k_tid_t thread_id;
+
+    /** @brief Thread suspended through audio_mixer_suspend() */
+    bool suspended;
+
+    /** @brief Serializes suspend, resume and CPU moves of the thread */
+    struct k_mutex thread_lock;
+
+    /** @brief Sample rate of the mix graph in Hz */
+    uint32_t sample_rate;
+
+    /** @brief Rate change requested while running (0 = none), applied between blocks */
+    atomic_t pending_rate;
+
+    /** @brief Preset queued by audio_mixer_preset_apply() (NULL = none) */
+    atomic_ptr_t pending_preset;
+
+#if defined(CONFIG_AUDIO_MODULATION)
+    /** @brief Modulation block counter shared by all strips of the mixer */
+    uint32_t mod_tick;
+#endif
+
+    /** @brief FIFO item that wakes the mixer thread for its strips' commands alone */
+    struct {
+        void *fifo_reserved;
+    } cmd_wake;
+
+    /** @brief cmd_wake is queued in in_fifo */
+    atomic_t cmd_wake_pending;
+
+#if defined(CONFIG_AUDIO_SMP_AFFINITY)
+    /** @brief CPUs the mixer thread may run on (bit n = CPU n, 0 = any) */
+    uint32_t cpu_mask;
+#endif
+
+#if defined(CONFIG_AUDIO_IDLE)
+    /** @brief Time spent waiting after an idle-marked block */
+    struct audio_idle_residency idle;
+#endif
+
+#if defined(CONFIG_AUDIO_MIXER_AUTOMIX)
+    /** @brief Gain sharing across channels (see audio_mixer_set_automix()) */
+    struct audio_mixer_automix automix;
+#endif
 };
 
 /**
@@ -181,6 +637,77 @@ int audio_mixer_add_channel(struct audio_mixer *mixer, struct channel_strip *str
  */
 void audio_mixer_set_master(struct audio_mixer *mixer, struct channel_strip *master);
 
+/**
+ * @brief Sets the sample rate of the whole mix graph.
+ *
+ * Propagated to every channel strip and the master strip. Channels added
+ * later inherit the mixer's rate. If the mixer thread is running the
+ * change is applied at the next block boundary.
+ *
+ * @param mixer Pointer to the mixer
+ * @param sample_rate Sample rate in Hz
+ * @return 0 on success, -EINVAL if sample_rate is 0, -EBUSY if an earlier
+ *         change is still pending
+ */
+int audio_mixer_set_sample_rate(struct audio_mixer *mixer, uint32_t sample_rate);
+
+#if defined(CONFIG_AUDIO_SMP_AFFINITY)
+/**
+ * @brief Restricts the mixer thread to a set of CPUs.
+ *
+ * Behaves like channel_strip_set_cpu_mask() for the mixer thread.
+ *
+ * @param mixer Pointer to the mixer
+ * @param cpu_mask Bit n allows CPU n; 0 allows all CPUs
+ * @return 0 on success, -EINVAL for CPUs that do not exist, -EDEADLK if
+ *         called from the mixer thread
+ */
+int audio_mixer_set_cpu_mask(struct audio_mixer *mixer, uint32_t cpu_mask);
+#endif
+
+#if defined(CONFIG_AUDIO_IDLE)
+/**
+ * @brief Gets the idle residency of the mixer.
+ *
+ * @param mixer Pointer to the mixer
+ * @param stats Destination
+ */
+void audio_mixer_get_idle_stats(struct audio_mixer *mixer, struct audio_idle_stats *stats);
+#endif
+
+#if defined(CONFIG_AUDIO_MIXER_AUTOMIX)
+/**
+ * @brief Turns automatic gain-sharing mixing on or off.
+ *
+ * Each channel's strip output is summed with gain
+ * sqrt(L_ch / sum(L)), where L is the channel's smoothed mean-square
+ * level (at least the floor). One talker gets unity gain, n equally loud
+ * talkers share the mix at constant total power, and in silence every
+ * channel sits at sqrt(1 / channels), so the ambient level does not
+ * depend on the number of open microphones.
+ *
+ * Levels are measured in the summing loop on the strip outputs, and the
+ * gains of a block follow the levels up to the previous block, ramping
+ * linearly across the block. Call while the mixer thread is not running.
+ *
+ * @param mixer Pointer to the mixer
+ * @param config Tuning, NULL turns automix off
+ * @return 0 on success, -EINVAL for zero time constants
+ */
+int audio_mixer_set_automix(struct audio_mixer *mixer,
+                            const struct audio_mixer_automix_config *config);
+
+/**
+ * @brief Reads the current automix gains.
+ *
+ * @param mixer Pointer to the mixer
+ * @param gains Destination, linear gain per channel
+ * @param count Capacity of @p gains
+ * @return Number of gains written (the channel count at most)
+ */
+size_t audio_mixer_get_automix_gains(struct audio_mixer *mixer, float *gains, size_t count);
+#endif
+
 /**
  * @brief Starts the mixer's synchronized processing thread.
  *
@@ -196,6 +723,23 @@ void audio_mixer_start(struct audio_mixer *mixer,
                        size_t stack_size,
                        int priority);
 
+/**
+ * @brief Suspends the mixer thread, see channel_strip_suspend().
+ *
+ * @param mixer Pointer to the mixer
+ * @return 0 on success, -ESRCH if the mixer is not started, -EDEADLK if
+ *         called from the mixer thread
+ */
+int audio_mixer_suspend(struct audio_mixer *mixer);
+
+/**
+ * @brief Resumes a mixer thread suspended by audio_mixer_suspend().
+ *
+ * @param mixer Pointer to the mixer
+ * @return 0 on success, -ESRCH if the mixer is not started
+ */
+int audio_mixer_resume(struct audio_mixer *mixer);
+
 /**
  * @brief Process a block through all channels synchronously (non-threaded).
  *
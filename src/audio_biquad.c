@@ -0,0 +1,136 @@
+/**
+ * @file audio_biquad.c
+ * @brief Float biquad cascade (transposed direct form II)
+ */
+
+#include "audio_biquad.h"
+#include "audio_placement.h"
+#include <errno.h>
+#include <math.h>
+#include <string.h>
+
+#if (defined(__ARM_ARCH) || defined(__arm__) || defined(__ARM_EABI__)) && defined(CONFIG_CMSIS_DSP)
+#define AUDIO_BIQUAD_CMSIS 1
+#include <arm_math.h>
+#else
+#define AUDIO_BIQUAD_CMSIS 0
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+int audio_biquad_design_peaking(float *coeffs, float freq_hz, float q, float gain_db,
+                                uint32_t sample_rate)
+{
+    if (freq_hz <= 0.0f || freq_hz >= 0.5f * (float)sample_rate || q <= 0.0f) {
+        return -EINVAL;
+    }
+
+    if (gain_db == 0.0f) {
+        coeffs[0] = 1.0f;
+        coeffs[1] = coeffs[2] = coeffs[3] = coeffs[4] = 0.0f;
+        return 0;
+    }
+
+    const float a = powf(10.0f, gain_db / 40.0f);
+    const float w0 = 2.0f * (float)M_PI * freq_hz / (float)sample_rate;
+    const float alpha = sinf(w0) / (2.0f * q);
+    const float cw = cosf(w0);
+    const float a0 = 1.0f + alpha / a;
+
+    coeffs[0] = (1.0f + alpha * a) / a0;
+    coeffs[1] = -2.0f * cw / a0;
+    coeffs[2] = (1.0f - alpha * a) / a0;
+    coeffs[3] = 2.0f * cw / a0;
+    coeffs[4] = -(1.0f - alpha / a) / a0;
+    return 0;
+}
+
+void audio_biquad_init(struct audio_biquad_cascade *bq)
+{
+    bq->stages = 0;
+    audio_biquad_reset(bq);
+}
+
+void audio_biquad_reset(struct audio_biquad_cascade *bq)
+{
+    memset(bq->state, 0, sizeof(bq->state));
+}
+
+int audio_biquad_add_stage(struct audio_biquad_cascade *bq, const float *coeffs)
+{
+    if (bq->stages >= AUDIO_BIQUAD_MAX_STAGES) {
+        return -ENOMEM;
+    }
+
+    size_t s = bq->stages;
+
+    memcpy(&bq->coeffs[AUDIO_BIQUAD_COEFFS * s], coeffs, AUDIO_BIQUAD_COEFFS * sizeof(float));
+    bq->state[2 * s] = 0.0f;
+    bq->state[2 * s + 1] = 0.0f;
+    bq->stages++;
+    return (int)s;
+}
+
+void audio_biquad_set_stage(struct audio_biquad_cascade *bq, size_t stage, const float *coeffs)
+{
+    memcpy(&bq->coeffs[AUDIO_BIQUAD_COEFFS * stage], coeffs, AUDIO_BIQUAD_COEFFS * sizeof(float));
+}
+
+void audio_biquad_remove_stage(struct audio_biquad_cascade *bq, size_t stage)
+{
+    if (stage >= bq->stages) {
+        return;
+    }
+
+    size_t after = bq->stages - stage - 1;
+
+    memmove(&bq->coeffs[AUDIO_BIQUAD_COEFFS * stage], &bq->coeffs[AUDIO_BIQUAD_COEFFS * (stage + 1)],
+            after * AUDIO_BIQUAD_COEFFS * sizeof(float));
+    memmove(&bq->state[2 * stage], &bq->state[2 * (stage + 1)], after * 2 * sizeof(float));
+    bq->stages--;
+}
+
+#if AUDIO_BIQUAD_CMSIS
+
+__audio_hot void audio_biquad_process(struct audio_biquad_cascade *bq, float *data, size_t count)
+{
+    if (bq->stages == 0) {
+        return;
+    }
+
+    arm_biquad_cascade_df2T_instance_f32 inst = {
+        .numStages = bq->stages,
+        .pState = bq->state,
+        .pCoeffs = bq->coeffs,
+    };
+
+    arm_biquad_cascade_df2T_f32(&inst, data, data, count);
+}
+
+#else /* !AUDIO_BIQUAD_CMSIS */
+
+__audio_hot void audio_biquad_process(struct audio_biquad_cascade *bq, float *data, size_t count)
+{
+    for (size_t s = 0; s < bq->stages; s++) {
+        const float *c = &bq->coeffs[AUDIO_BIQUAD_COEFFS * s];
+        const float b0 = c[0], b1 = c[1], b2 = c[2], a1 = c[3], a2 = c[4];
+        float s1 = bq->state[2 * s];
+        float s2 = bq->state[2 * s + 1];
+
+        for (size_t i = 0; i < count; i++) {
+            const float x = data[i];
+            const float y = b0 * x + s1;
+
+            s1 = b1 * x + a1 * y + s2;
+            s2 = b2 * x + a2 * y;
+            data[i] = y;
+        }
+
+        bq->state[2 * s] = s1;
+        bq->state[2 * s + 1] = s2;
+    }
+}
+
+#endif /* AUDIO_BIQUAD_CMSIS */
@@ -0,0 +1,99 @@
+/**
+ * @file audio_cmd.c
+ * @brief Control command ring between control threads and the audio path
+ */
+
+#include "audio_cmd.h"
+#include <errno.h>
+
+void audio_cmd_queue_init(struct audio_cmd_queue *q)
+{
+    atomic_set(&q->head, 0);
+    atomic_set(&q->tail, 0);
+    q->dropped = 0;
+    q->wake = NULL;
+
+    k_mutex_init(&q->read_lock);
+    k_sem_init(&q->read_done, 0, 1);
+    q->read_seq = 0;
+    atomic_set(&q->reply_seq, 0);
+}
+
+int audio_cmd_push(struct audio_cmd_queue *q, const struct audio_cmd *cmd)
+{
+    k_spinlock_key_t key = k_spin_lock(&q->producer_lock);
+    atomic_val_t head = atomic_get(&q->head);
+
+    if ((atomic_val_t)(head - atomic_get(&q->tail)) >= AUDIO_CMD_QUEUE_DEPTH) {
+        q->dropped++;
+        k_spin_unlock(&q->producer_lock, key);
+        return -ENOSPC;
+    }
+
+    q->slots[head & (AUDIO_CMD_QUEUE_DEPTH - 1)] = *cmd;
+
+    // Publish the slot only after it is written
+    atomic_set(&q->head, head + 1);
+
+    k_spin_unlock(&q->producer_lock, key);
+
+    if (q->wake) {
+        q->wake(q);
+    }
+    return 0;
+}
+
+bool audio_cmd_pop(struct audio_cmd_queue *q, struct audio_cmd *cmd)
+{
+    atomic_val_t tail = atomic_get(&q->tail);
+
+    if (tail == atomic_get(&q->head)) {
+        return false;
+    }
+
+    *cmd = q->slots[tail & (AUDIO_CMD_QUEUE_DEPTH - 1)];
+    atomic_set(&q->tail, tail + 1);
+    return true;
+}
+
+void audio_cmd_reply(struct audio_cmd_queue *q, uint32_t seq, int result, float value)
+{
+    q->reply_value = value;
+    q->reply_result = result;
+    atomic_set(&q->reply_seq, (atomic_val_t)seq);
+    k_sem_give(&q->read_done);
+}
+
+int audio_cmd_read(struct audio_cmd_queue *q, struct audio_cmd *cmd, float *value,
+                   k_timeout_t timeout)
+{
+    k_timepoint_t end = sys_timepoint_calc(timeout);
+    int ret;
+
+    k_mutex_lock(&q->read_lock, K_FOREVER);
+
+    // Replies of earlier timed-out reads are recognized by their sequence
+    uint32_t seq = ++q->read_seq;
+    k_sem_reset(&q->read_done);
+
+    cmd->type = AUDIO_CMD_READ_PARAM;
+    cmd->arg = seq;
+
+    ret = audio_cmd_push(q, cmd);
+    while (ret == 0) {
+        if (k_sem_take(&q->read_done, sys_timepoint_timeout(end)) != 0) {
+            ret = -EAGAIN;
+            break;
+        }
+        if ((uint32_t)atomic_get(&q->reply_seq) == seq) {
+            ret = q->reply_result;
+            if (ret == 0) {
+                *value = q->reply_value;
+            }
+            break;
+        }
+    }
+
+    k_mutex_unlock(&q->read_lock);
+    return ret;
+}
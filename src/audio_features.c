@@ -0,0 +1,198 @@
+/**
+ * @file audio_features.c
+ * @brief Spectral classifier features and their frame ring
+ */
+
+#include "audio_features.h"
+#include "audio_placement.h"
+#include <math.h>
+#include <string.h>
+
+#define FEAT_BANDS      CONFIG_AUDIO_FEATURE_MEL_BANDS
+#define FEAT_COEFFS     CONFIG_AUDIO_FEATURE_MFCC_COEFFS
+#define FEAT_RING       CONFIG_AUDIO_FEATURE_RING_FRAMES
+
+BUILD_ASSERT(FEAT_COEFFS <= FEAT_BANDS, "More MFCCs than mel bands");
+BUILD_ASSERT(IS_POWER_OF_TWO(FEAT_RING), "Feature ring size must be a power of two");
+
+#define FEAT_ROLLOFF        0.85f
+#define FEAT_LOG_FLOOR      1e-12f
+#define FEAT_POWER_FLOOR    1e-20f
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static inline float hz_to_mel(float hz)
+{
+    return 2595.0f * log10f(1.0f + hz / 700.0f);
+}
+
+static inline float mel_to_hz(float mel)
+{
+    return 700.0f * (powf(10.0f, mel / 2595.0f) - 1.0f);
+}
+
+static inline audio_feature_t to_feature(float v, float scale)
+{
+#if defined(CONFIG_AUDIO_FEATURE_Q15)
+    return (audio_feature_t)CLAMP(lrintf(v / scale * 32768.0f), INT16_MIN, INT16_MAX);
+#else
+    ARG_UNUSED(scale);
+    return v;
+#endif
+}
+
+int audio_features_init(struct audio_features *fx, size_t fft_size, uint32_t sample_rate)
+{
+    if (!fx || fft_size > CONFIG_AUDIO_FFT_MAX_SIZE || sample_rate == 0) {
+        return -EINVAL;
+    }
+
+    fx->num_bins = fft_size / 2;
+
+    // Triangular bands evenly spaced on the mel scale, edges in bins
+    float top_hz = MIN((float)CONFIG_AUDIO_FEATURE_MEL_MAX_HZ, 0.5f * (float)sample_rate);
+    float top_mel = hz_to_mel(top_hz);
+    for (size_t m = 0; m < FEAT_BANDS + 2; m++) {
+        float hz = mel_to_hz(top_mel * (float)m / (float)(FEAT_BANDS + 1));
+        fx->mel_edges[m] = hz * (float)fft_size / (float)sample_rate;
+    }
+
+    // Orthonormal DCT-II
+    for (size_t i = 0; i < FEAT_COEFFS; i++) {
+        float norm = sqrtf((i == 0 ? 1.0f : 2.0f) / (float)FEAT_BANDS);
+        for (size_t m = 0; m < FEAT_BANDS; m++) {
+            fx->dct[i][m] = norm * cosf((float)M_PI * (float)i * ((float)m + 0.5f) /
+                                        (float)FEAT_BANDS);
+        }
+    }
+
+    audio_features_reset(fx);
+    return 0;
+}
+
+void audio_features_reset(struct audio_features *fx)
+{
+    fx->has_prev = false;
+}
+
+/* Mel band energies from the power spectrum */
+static void mel_bands(struct audio_features *fx, const float *mag)
+{
+    for (size_t m = 0; m < FEAT_BANDS; m++) {
+        const float lo = fx->mel_edges[m];
+        const float mid = fx->mel_edges[m + 1];
+        const float hi = fx->mel_edges[m + 2];
+        const size_t first = (size_t)ceilf(lo);
+        const size_t last = MIN((size_t)hi, fx->num_bins - 1);
+        float energy = 0.0f;
+
+        for (size_t k = first; k <= last; k++) {
+            float pos = (float)k;
+            float w = pos <= mid ? (pos - lo) / (mid - lo) : (hi - pos) / (hi - mid);
+            energy += w * mag[k] * mag[k];
+        }
+        fx->mel[m] = logf(energy + FEAT_LOG_FLOOR);
+    }
+}
+
+__audio_hot void audio_features_compute(struct audio_features *fx, const float *mag)
+{
+    const size_t nb = fx->num_bins;
+    struct audio_feature_frame scratch;
+    struct audio_feature_frame *frame = &scratch;
+
+    atomic_val_t wr = atomic_get(&fx->wr);
+    if (wr - atomic_get(&fx->rd) < FEAT_RING) {
+        frame = &fx->ring[wr & (FEAT_RING - 1)];
+    } else {
+        atomic_inc(&fx->dropped);
+    }
+
+    // Single pass for the moments; flatness as a log2 of a running
+    // mantissa/exponent product instead of one log per bin
+    float sum_mag = 0.0f, weighted = 0.0f, sum_pow = 0.0f, rise = 0.0f;
+    float mant = 1.0f;
+    int exp_sum = 0;
+
+    for (size_t k = 1; k < nb; k++) {
+        const float a = mag[k];
+        const float p = a * a;
+        int e;
+
+        sum_mag += a;
+        weighted += (float)k * a;
+        sum_pow += p;
+
+        mant *= frexpf(p + FEAT_POWER_FLOOR, &e);
+        exp_sum += e;
+        mant = frexpf(mant, &e);
+        exp_sum += e;
+
+        if (fx->has_prev && a > fx->prev_mag[k]) {
+            rise += a - fx->prev_mag[k];
+        }
+    }
+
+    float centroid = 0.0f, rolloff = 0.0f, flatness = 0.0f, flux = 0.0f;
+
+    if (sum_pow > 0.0f) {
+        const float bins = (float)(nb - 1);
+
+        centroid = weighted / sum_mag / (float)nb;
+        flux = rise / sum_mag;
+        flatness = exp2f((log2f(mant) + (float)exp_sum) / bins) / (sum_pow / bins);
+
+        float target = FEAT_ROLLOFF * sum_pow, acc = 0.0f;
+        size_t k = 1;
+        while (k < nb - 1 && (acc += mag[k] * mag[k]) < target) {
+            k++;
+        }
+        rolloff = (float)k / (float)nb;
+    }
+
+    memcpy(fx->prev_mag, mag, nb * sizeof(float));
+    fx->has_prev = true;
+
+    mel_bands(fx, mag);
+    for (size_t i = 0; i < FEAT_COEFFS; i++) {
+        float c = 0.0f;
+        for (size_t m = 0; m < FEAT_BANDS; m++) {
+            c += fx->dct[i][m] * fx->mel[m];
+        }
+        frame->mfcc[i] = to_feature(c, AUDIO_FEATURE_MFCC_Q15_SCALE);
+    }
+
+    frame->sequence = fx->sequence++;
+    frame->centroid = to_feature(centroid, 1.0f);
+    frame->rolloff = to_feature(rolloff, 1.0f);
+    frame->flatness = to_feature(MIN(flatness, 1.0f), 1.0f);
+    frame->flux = to_feature(MIN(flux, 1.0f), 1.0f);
+
+    if (frame != &scratch) {
+        // Publishes the frame after its contents
+        atomic_set(&fx->wr, wr + 1);
+    }
+}
+
+int audio_features_get(struct audio_features *fx, const struct audio_feature_frame **frame)
+{
+    atomic_val_t rd = atomic_get(&fx->rd);
+
+    if (rd == atomic_get(&fx->wr)) {
+        return -EAGAIN;
+    }
+
+    *frame = &fx->ring[rd & (FEAT_RING - 1)];
+    return 0;
+}
+
+void audio_features_release(struct audio_features *fx)
+{
+    atomic_val_t rd = atomic_get(&fx->rd);
+
+    if (rd != atomic_get(&fx->wr)) {
+        atomic_set(&fx->rd, rd + 1);
+    }
+}
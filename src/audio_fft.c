@@ -0,0 +1,210 @@
+/**
+ * @file audio_fft.c
+ * @brief Shared real FFT plans
+ */
+
+#include "audio_fft.h"
+#include "audio_placement.h"
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <math.h>
+#include <string.h>
+
+#if (defined(__ARM_ARCH) || defined(__arm__) || defined(__ARM_EABI__)) && defined(CONFIG_CMSIS_DSP)
+#define AUDIO_FFT_CMSIS 1
+#include <arm_math.h>
+#else
+#define AUDIO_FFT_CMSIS 0
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define FFT_MIN_LOG2    5
+#define FFT_MAX_LOG2    LOG2CEIL(CONFIG_AUDIO_FFT_MAX_SIZE)
+
+BUILD_ASSERT(IS_POWER_OF_TWO(CONFIG_AUDIO_FFT_MAX_SIZE),
+             "AUDIO_FFT_MAX_SIZE must be a power of two");
+
+struct audio_fft {
+    uint16_t size;          /**< 0 until the plan is created */
+#if AUDIO_FFT_CMSIS
+    arm_rfft_fast_instance_f32 rfft;
+#endif
+};
+
+static struct audio_fft plans[FFT_MAX_LOG2 - FFT_MIN_LOG2 + 1];
+static K_MUTEX_DEFINE(plan_lock);
+
+#if !AUDIO_FFT_CMSIS
+// W^k = exp(-2*pi*i*k / MAX_SIZE) for k < MAX_SIZE / 2, strided for smaller sizes
+static float twiddle_re[CONFIG_AUDIO_FFT_MAX_SIZE / 2];
+static float twiddle_im[CONFIG_AUDIO_FFT_MAX_SIZE / 2];
+static bool twiddles_ready;
+
+static void twiddles_init(void)
+{
+    for (size_t k = 0; k < ARRAY_SIZE(twiddle_re); k++) {
+        float angle = -2.0f * (float)M_PI * (float)k / (float)CONFIG_AUDIO_FFT_MAX_SIZE;
+        twiddle_re[k] = cosf(angle);
+        twiddle_im[k] = sinf(angle);
+    }
+    twiddles_ready = true;
+}
+#endif
+
+const struct audio_fft *audio_fft_plan(size_t size)
+{
+    if (size < BIT(FFT_MIN_LOG2) || size > CONFIG_AUDIO_FFT_MAX_SIZE ||
+        !IS_POWER_OF_TWO(size)) {
+        return NULL;
+    }
+
+    struct audio_fft *plan = &plans[LOG2CEIL(size) - FFT_MIN_LOG2];
+
+    k_mutex_lock(&plan_lock, K_FOREVER);
+
+    if (plan->size == 0) {
+#if AUDIO_FFT_CMSIS
+        if (arm_rfft_fast_init_f32(&plan->rfft, size) != ARM_MATH_SUCCESS) {
+            k_mutex_unlock(&plan_lock);
+            return NULL;
+        }
+#else
+        if (!twiddles_ready) {
+            twiddles_init();
+        }
+#endif
+        plan->size = (uint16_t)size;
+    }
+
+    k_mutex_unlock(&plan_lock);
+    return plan;
+}
+
+size_t audio_fft_size(const struct audio_fft *plan)
+{
+    return plan ? plan->size : 0;
+}
+
+#if AUDIO_FFT_CMSIS
+
+__audio_hot void audio_fft_forward(const struct audio_fft *plan, float *in, float *out)
+{
+    arm_rfft_fast_f32((arm_rfft_fast_instance_f32 *)&plan->rfft, in, out, 0);
+}
+
+__audio_hot void audio_fft_inverse(const struct audio_fft *plan, float *in, float *out)
+{
+    arm_rfft_fast_f32((arm_rfft_fast_instance_f32 *)&plan->rfft, in, out, 1);
+}
+
+#else
+
+/* In-place radix-2 complex FFT of m interleaved points, forward or inverse (unscaled) */
+static void cfft(float *z, size_t m, bool inverse)
+{
+    const size_t stride = CONFIG_AUDIO_FFT_MAX_SIZE / m;
+
+    // Bit reversal
+    for (size_t i = 1, j = 0; i < m; i++) {
+        size_t bit = m >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j |= bit;
+
+        if (i < j) {
+            float re = z[2 * i], im = z[2 * i + 1];
+            z[2 * i] = z[2 * j];
+            z[2 * i + 1] = z[2 * j + 1];
+            z[2 * j] = re;
+            z[2 * j + 1] = im;
+        }
+    }
+
+    // Butterflies; W_len^k = W_MAX^(k * MAX / len)
+    for (size_t len = 2; len <= m; len <<= 1) {
+        const size_t half = len >> 1;
+        const size_t step = stride * (m / len);
+
+        for (size_t k = 0; k < half; k++) {
+            float wr = twiddle_re[k * step];
+            float wi = inverse ? -twiddle_im[k * step] : twiddle_im[k * step];
+
+            for (size_t i = k; i < m; i += len) {
+                float *a = &z[2 * i];
+                float *b = &z[2 * (i + half)];
+                float tr = b[0] * wr - b[1] * wi;
+                float ti = b[0] * wi + b[1] * wr;
+
+                b[0] = a[0] - tr;
+                b[1] = a[1] - ti;
+                a[0] += tr;
+                a[1] += ti;
+            }
+        }
+    }
+}
+
+__audio_hot void audio_fft_forward(const struct audio_fft *plan, float *in, float *out)
+{
+    const size_t n = plan->size;
+    const size_t m = n / 2;
+    const size_t stride = CONFIG_AUDIO_FFT_MAX_SIZE / n;
+
+    // Even/odd samples as one complex sequence of half the length
+    cfft(in, m, false);
+
+    out[0] = in[0] + in[1];
+    out[1] = in[0] - in[1];
+
+    for (size_t k = 1; k < m; k++) {
+        float zr = in[2 * k], zi = in[2 * k + 1];
+        float cr = in[2 * (m - k)], ci = -in[2 * (m - k) + 1];
+
+        // E = (Z[k] + conj Z[m-k]) / 2, O = -i (Z[k] - conj Z[m-k]) / 2
+        float er = 0.5f * (zr + cr), ei = 0.5f * (zi + ci);
+        float or_ = 0.5f * (zi - ci), oi = -0.5f * (zr - cr);
+        float wr = twiddle_re[k * stride], wi = twiddle_im[k * stride];
+
+        out[2 * k] = er + or_ * wr - oi * wi;
+        out[2 * k + 1] = ei + or_ * wi + oi * wr;
+    }
+}
+
+__audio_hot void audio_fft_inverse(const struct audio_fft *plan, float *in, float *out)
+{
+    const size_t n = plan->size;
+    const size_t m = n / 2;
+    const size_t stride = CONFIG_AUDIO_FFT_MAX_SIZE / n;
+
+    // Rebuild Z = E + i O from the packed half spectrum
+    out[0] = 0.5f * (in[0] + in[1]);
+    out[1] = 0.5f * (in[0] - in[1]);
+
+    for (size_t k = 1; k < m; k++) {
+        float xr = in[2 * k], xi = in[2 * k + 1];
+        float cr = in[2 * (m - k)], ci = -in[2 * (m - k) + 1];
+
+        float er = 0.5f * (xr + cr), ei = 0.5f * (xi + ci);
+        float dr = 0.5f * (xr - cr), di = 0.5f * (xi - ci);
+        float wr = twiddle_re[k * stride], wi = -twiddle_im[k * stride];
+
+        // O = D * W^-k, Z = E + i O
+        float or_ = dr * wr - di * wi, oi = dr * wi + di * wr;
+
+        out[2 * k] = er - oi;
+        out[2 * k + 1] = ei + or_;
+    }
+
+    cfft(out, m, true);
+
+    const float scale = 1.0f / (float)m;
+    for (size_t i = 0; i < n; i++) {
+        out[i] *= scale;
+    }
+}
+
+#endif /* AUDIO_FFT_CMSIS */
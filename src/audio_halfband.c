@@ -0,0 +1,139 @@
+/**
+ * @file audio_halfband.c
+ * @brief Polyphase half-band FIR interpolator and decimator (Q15)
+ */
+
+#include "audio_halfband.h"
+#include "audio_placement.h"
+#include <zephyr/sys/util.h>
+#include <errno.h>
+#include <math.h>
+#include <string.h>
+
+#if defined(__ARM_FEATURE_SIMD32)
+#include <arm_acle.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+int audio_halfband_design(int16_t *coeffs, size_t taps)
+{
+    float c[AUDIO_HALFBAND_MAX_TAPS];
+    float sum = 0.0f;
+
+    if (taps < 2 || taps > AUDIO_HALFBAND_MAX_TAPS || (taps & 1)) {
+        return -EINVAL;
+    }
+
+    // Branch tap i sits at n = 2i - (taps - 1) of the full filter; the
+    // interpolator gain of 2 cancels the 0.5 of the half-band sinc
+    for (size_t i = 0; i < taps; i++) {
+        float n = (float)(2 * (int)i - (int)(taps - 1));
+        float x = (float)M_PI * n / 2.0f;
+        float w = 0.42f + 0.5f * cosf((float)M_PI * n / (float)taps)
+                        + 0.08f * cosf(2.0f * (float)M_PI * n / (float)taps);
+
+        c[i] = sinf(x) / x * w;
+        sum += c[i];
+    }
+
+    int32_t qsum = 0;
+    for (size_t i = 0; i < taps; i++) {
+        coeffs[i] = (int16_t)lrintf(c[i] / sum * 32768.0f);
+        qsum += coeffs[i];
+    }
+
+    // Put the rounding error on the two center taps for exact unity DC gain
+    int32_t err = 32768 - qsum;
+    coeffs[taps / 2 - 1] += err / 2;
+    coeffs[taps / 2] += err - err / 2;
+
+    return 0;
+}
+
+static inline int32_t branch_dot(const int16_t *x, const int16_t *c, size_t taps)
+{
+    int32_t acc = 0;
+
+#if defined(__ARM_FEATURE_SIMD32)
+    // Two 16x16 MACs per instruction; taps is even
+    for (size_t i = 0; i < taps; i += 2) {
+        int16x2_t xv, cv;
+        memcpy(&xv, &x[i], sizeof(xv));
+        memcpy(&cv, &c[i], sizeof(cv));
+        acc = __smlad(xv, cv, acc);
+    }
+#else
+    for (size_t i = 0; i < taps; i++) {
+        acc += (int32_t)x[i] * c[i];
+    }
+#endif
+
+    return acc;
+}
+
+static inline int16_t sat_q15(int32_t acc)
+{
+    return (int16_t)CLAMP((acc + (1 << 14)) >> 15, INT16_MIN, INT16_MAX);
+}
+
+void audio_halfband_up_init(struct audio_halfband_up *f, const int16_t *coeffs, size_t taps)
+{
+    memset(f, 0, sizeof(*f));
+    f->coeffs = coeffs;
+    f->taps = (uint8_t)taps;
+}
+
+__audio_hot void audio_halfband_up(struct audio_halfband_up *f, const int16_t *in,
+                                   int16_t *out, size_t n)
+{
+    const size_t taps = f->taps;
+    size_t pos = f->pos;
+
+    for (size_t i = 0; i < n; i++) {
+        // Doubled history: hist[pos .. pos + taps) is always contiguous
+        pos = pos ? pos - 1 : taps - 1;
+        f->hist[pos] = in[i];
+        f->hist[pos + taps] = in[i];
+
+        const int16_t *h = &f->hist[pos];
+        out[2 * i] = sat_q15(branch_dot(h, f->coeffs, taps));
+        out[2 * i + 1] = h[taps / 2 - 1];
+    }
+
+    f->pos = (uint8_t)pos;
+}
+
+void audio_halfband_down_init(struct audio_halfband_down *f, const int16_t *coeffs, size_t taps)
+{
+    memset(f, 0, sizeof(*f));
+    f->coeffs = coeffs;
+    f->taps = (uint8_t)taps;
+}
+
+__audio_hot void audio_halfband_down(struct audio_halfband_down *f, const int16_t *in,
+                                     int16_t *out, size_t n)
+{
+    const size_t taps = f->taps;
+    size_t pos = f->pos;
+
+    for (size_t i = 0; i < n; i++) {
+        int16_t even = in[2 * i];
+        int16_t odd = in[2 * i + 1];
+
+        pos = pos ? pos - 1 : taps - 1;
+        f->even[pos] = even;
+        f->even[pos + taps] = even;
+        f->odd[pos] = odd;
+        f->odd[pos + taps] = odd;
+
+        // Branch sum is 1.0, half-band gain is 0.5 on each branch
+        int32_t acc = (branch_dot(&f->even[pos], f->coeffs, taps) >> 1)
+                    + (int32_t)f->odd[pos + taps / 2] * (1 << 14);
+        out[i] = sat_q15(acc);
+    }
+
+    f->pos = (uint8_t)pos;
+}
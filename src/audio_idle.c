@@ -0,0 +1,112 @@
+/**
+ * @file audio_idle.c
+ * @brief Silence detection and idle residency accounting
+ */
+
+#include "audio_idle.h"
+#include <zephyr/logging/log.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(audio_idle, LOG_LEVEL_INF);
+
+void audio_idle_residency_init(struct audio_idle_residency *res)
+{
+    memset(&res->stats, 0, sizeof(res->stats));
+    res->since = 0;
+}
+
+void audio_idle_residency_enter(struct audio_idle_residency *res)
+{
+    k_spinlock_key_t key = k_spin_lock(&res->lock);
+
+    if (!res->stats.idle) {
+        res->stats.idle = true;
+        res->stats.entries++;
+        res->since = k_uptime_get();
+    }
+
+    k_spin_unlock(&res->lock, key);
+}
+
+void audio_idle_residency_leave(struct audio_idle_residency *res)
+{
+    k_spinlock_key_t key = k_spin_lock(&res->lock);
+
+    if (res->stats.idle) {
+        res->stats.idle = false;
+        res->stats.idle_ms += (uint64_t)(k_uptime_get() - res->since);
+    }
+
+    k_spin_unlock(&res->lock, key);
+}
+
+void audio_idle_residency_get(struct audio_idle_residency *res, struct audio_idle_stats *stats)
+{
+    k_spinlock_key_t key = k_spin_lock(&res->lock);
+
+    *stats = res->stats;
+    if (res->stats.idle) {
+        stats->idle_ms += (uint64_t)(k_uptime_get() - res->since);
+    }
+
+    k_spin_unlock(&res->lock, key);
+}
+
+void audio_idle_detector_init(struct audio_idle_detector *det, int16_t threshold,
+                              uint32_t hold_blocks)
+{
+    det->threshold = threshold;
+    det->hold_blocks = MAX(hold_blocks, 1U);
+    det->quiet_blocks = 0;
+    det->idle = false;
+    audio_idle_residency_init(&det->residency);
+}
+
+static __audio_hot int16_t block_peak(const struct audio_block *block)
+{
+    int16_t peak = 0;
+
+    for (size_t i = 0; i < block->data_len; i++) {
+        int16_t val = block->data[i];
+        if (val < 0) {
+            val = (val == INT16_MIN) ? INT16_MAX : -val;
+        }
+        if (val > peak) {
+            peak = val;
+        }
+    }
+
+    return peak;
+}
+
+struct audio_block *audio_idle_gate(struct audio_idle_detector *det, struct audio_block *block)
+{
+    if (!block) {
+        return NULL;
+    }
+
+    if (block_peak(block) > det->threshold) {
+        det->quiet_blocks = 0;
+        if (det->idle) {
+            det->idle = false;
+            audio_idle_residency_leave(&det->residency);
+            LOG_DBG("Source active again");
+        }
+        return block;
+    }
+
+    if (det->idle) {
+        // Nothing downstream needs to wake for more silence
+        audio_block_release(block);
+        return NULL;
+    }
+
+    if (++det->quiet_blocks >= det->hold_blocks) {
+        det->idle = true;
+        audio_idle_residency_enter(&det->residency);
+        block->flags |= AUDIO_BLOCK_FLAG_IDLE;
+        LOG_DBG("Source idle after %u silent blocks", det->quiet_blocks);
+    }
+
+    return block;
+}
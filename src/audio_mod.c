@@ -0,0 +1,98 @@
+/**
+ * @file audio_mod.c
+ * @brief Control-rate modulation sources for node parameters
+ */
+
+#include "audio_mod.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static void source_reset(struct audio_mod_source *src, enum audio_mod_type type)
+{
+    memset(src, 0, sizeof(*src));
+    src->type = type;
+}
+
+void audio_mod_lfo_init(struct audio_mod_source *src, enum audio_mod_type type, float rate_hz)
+{
+    source_reset(src, type);
+    src->rate_hz = rate_hz;
+}
+
+void audio_mod_env_init(struct audio_mod_source *src, float attack_ms, float release_ms)
+{
+    source_reset(src, AUDIO_MOD_ENVELOPE);
+    src->attack_s = attack_ms / 1000.0f;
+    src->release_s = release_ms / 1000.0f;
+}
+
+void audio_mod_env_gate(struct audio_mod_source *src, bool open)
+{
+    atomic_set(&src->gate, open ? 1 : 0);
+}
+
+static float next_random(struct audio_mod_source *src)
+{
+    // xorshift32, mapped to -1..1
+    uint32_t x = src->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    src->rng = x;
+    return ((float)x / (float)UINT32_MAX) * 2.0f - 1.0f;
+}
+
+void audio_mod_random_init(struct audio_mod_source *src, float rate_hz, uint32_t seed)
+{
+    source_reset(src, AUDIO_MOD_RANDOM);
+    src->rate_hz = rate_hz;
+    src->rng = seed ? seed : 1;
+    src->target = next_random(src);
+}
+
+float audio_mod_advance(struct audio_mod_source *src, uint32_t samples, uint32_t sample_rate)
+{
+    float dt = (float)samples / (float)sample_rate;
+
+    switch (src->type) {
+    case AUDIO_MOD_LFO_SINE:
+    case AUDIO_MOD_LFO_TRIANGLE:
+    case AUDIO_MOD_LFO_SQUARE:
+        src->phase += src->rate_hz * dt;
+        src->phase -= floorf(src->phase);
+
+        if (src->type == AUDIO_MOD_LFO_SINE) {
+            src->value = sinf(2.0f * (float)M_PI * src->phase);
+        } else if (src->type == AUDIO_MOD_LFO_TRIANGLE) {
+            src->value = 1.0f - 4.0f * fabsf(src->phase - 0.5f);
+        } else {
+            src->value = (src->phase < 0.5f) ? 1.0f : -1.0f;
+        }
+        break;
+
+    case AUDIO_MOD_ENVELOPE:
+        if (atomic_get(&src->gate)) {
+            src->value = (src->attack_s > 0.0f) ? src->value + dt / src->attack_s : 1.0f;
+        } else {
+            src->value = (src->release_s > 0.0f) ? src->value - dt / src->release_s : 0.0f;
+        }
+        src->value = CLAMP(src->value, 0.0f, 1.0f);
+        break;
+
+    case AUDIO_MOD_RANDOM:
+        src->phase += src->rate_hz * dt;
+        while (src->phase >= 1.0f) {
+            src->phase -= 1.0f;
+            src->start = src->target;
+            src->target = next_random(src);
+        }
+        src->value = src->start + (src->target - src->start) * src->phase;
+        break;
+    }
+
+    return src->value;
+}
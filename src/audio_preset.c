@@ -0,0 +1,143 @@
+/**
+ * @file audio_preset.c
+ * @brief Whole-strip and whole-mixer parameter snapshots
+ */
+
+#include "audio_preset.h"
+#include <zephyr/logging/log.h>
+#include <errno.h>
+
+LOG_MODULE_REGISTER(audio_preset, LOG_LEVEL_INF);
+
+void audio_preset_init(struct audio_preset *preset)
+{
+    atomic_set(&preset->pending, 0);
+    preset->count = 0;
+}
+
+void audio_preset_set_ramp(struct audio_preset *preset, uint32_t ramp_samples)
+{
+    for (size_t i = 0; i < preset->count; i++) {
+        preset->entries[i].ramp_samples = ramp_samples;
+    }
+}
+
+/* Wait for one parameter read from a running strip */
+#define PRESET_READ_TIMEOUT K_MSEC(100)
+
+/* A strip is processed by its own thread or by its mixer's thread */
+static bool strip_is_running(const struct channel_strip *strip)
+{
+    return strip->thread_id || (strip->mixer && strip->mixer->thread_id);
+}
+
+static int capture_strip(struct channel_strip *strip, struct audio_preset *preset,
+                         uint8_t strip_index)
+{
+    const bool running = strip_is_running(strip);
+
+    for (size_t n = 0; n < strip->node_count; n++) {
+        struct audio_node *node = strip->nodes[n];
+        uint8_t params = (node && node->vtable) ? node->vtable->param_count : 0;
+
+        for (uint16_t id = 0; id < params; id++) {
+            float value;
+            int ret;
+
+            // While audio runs, node state belongs to the processing thread
+            if (running) {
+                ret = channel_strip_read_param(strip, (uint8_t)n, id, &value,
+                                               PRESET_READ_TIMEOUT);
+                if (ret == -EAGAIN || ret == -ENOSPC) {
+                    LOG_ERR("Preset: strip '%s' did not answer (%d)", strip->name, ret);
+                    return ret;
+                }
+            } else {
+                ret = audio_node_get_param(node, id, &value);
+            }
+            if (ret != 0) {
+                continue;
+            }
+            if (preset->count >= ARRAY_SIZE(preset->entries)) {
+                LOG_ERR("Preset full at strip '%s' node %zu", strip->name, n);
+                return -ENOMEM;
+            }
+
+            preset->entries[preset->count++] = (struct audio_preset_entry){
+                .strip = strip_index,
+                .node = (uint8_t)n,
+                .id = id,
+                .value = value,
+                .ramp_samples = 0,
+            };
+        }
+    }
+
+    return 0;
+}
+
+int channel_strip_preset_capture(struct channel_strip *strip, struct audio_preset *preset)
+{
+    audio_preset_init(preset);
+    return capture_strip(strip, preset, 0);
+}
+
+int channel_strip_preset_apply(struct channel_strip *strip, struct audio_preset *preset)
+{
+    struct audio_cmd cmd = {
+        .type = AUDIO_CMD_APPLY_PRESET,
+        .ptr = preset,
+    };
+
+    atomic_inc(&preset->pending);
+    int ret = audio_cmd_push(&strip->cmds, &cmd);
+    if (ret != 0) {
+        atomic_dec(&preset->pending);
+    }
+    return ret;
+}
+
+int audio_mixer_preset_capture(struct audio_mixer *mixer, struct audio_preset *preset)
+{
+    int ret = 0;
+
+    audio_preset_init(preset);
+
+    for (size_t ch = 0; ch < mixer->channel_count && ret == 0; ch++) {
+        ret = capture_strip(mixer->channels[ch], preset, (uint8_t)ch);
+    }
+    if (ret == 0 && mixer->master) {
+        ret = capture_strip(mixer->master, preset, AUDIO_PRESET_MASTER);
+    }
+
+    return ret;
+}
+
+int audio_mixer_preset_apply(struct audio_mixer *mixer, struct audio_preset *preset)
+{
+    atomic_inc(&preset->pending);
+
+    if (!atomic_ptr_cas(&mixer->pending_preset, NULL, preset)) {
+        atomic_dec(&preset->pending);
+        return -EBUSY;
+    }
+    return 0;
+}
+
+void audio_preset_apply_to_strip(struct channel_strip *strip, const struct audio_preset *preset,
+                                 uint8_t strip_index)
+{
+    for (size_t i = 0; i < preset->count; i++) {
+        const struct audio_preset_entry *e = &preset->entries[i];
+
+        if (e->strip != strip_index || e->node >= strip->node_count) {
+            continue;
+        }
+
+        int ret = audio_node_set_param(strip->nodes[e->node], e->id, e->value, e->ramp_samples);
+        if (ret != 0) {
+            LOG_WRN("Preset: strip '%s' node %u param %u rejected (%d)",
+                    strip->name, e->node, e->id, ret);
+        }
+    }
+}
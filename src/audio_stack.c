@@ -0,0 +1,209 @@
+/**
+ * @file audio_stack.c
+ * @brief Stack high-water tracking and profile lookup
+ */
+
+#include "audio_stack.h"
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/printk.h>
+#include <string.h>
+#include <errno.h>
+
+LOG_MODULE_REGISTER(audio_stack, LOG_LEVEL_INF);
+
+#if defined(CONFIG_AUDIO_STACK_STATS)
+
+/* Room for the "thread@<address>" name of unnamed threads */
+#define STACK_ANON_LEN 24
+
+struct stack_entry {
+    k_tid_t tid;                /**< NULL once untracked */
+    const char *name;           /**< Caller's name, or anon */
+    char anon[STACK_ANON_LEN];
+    size_t size;
+    size_t used;
+};
+
+static struct stack_entry entries[CONFIG_AUDIO_STACK_STATS_MAX_THREADS];
+static size_t entry_count;
+static struct k_spinlock stack_lock;
+
+/* The stack scan is long, so it runs outside the lock */
+static void sample_entry(size_t index)
+{
+    k_spinlock_key_t key = k_spin_lock(&stack_lock);
+    k_tid_t tid = entries[index].tid;
+    size_t size = entries[index].size;
+    k_spin_unlock(&stack_lock, key);
+
+    size_t unused;
+
+    if (!tid || k_thread_stack_space_get(tid, &unused) != 0) {
+        return;
+    }
+
+    key = k_spin_lock(&stack_lock);
+    struct stack_entry *e = &entries[index];
+    if (e->tid == tid && size - unused > e->used) {
+        e->used = size - unused;
+    }
+    k_spin_unlock(&stack_lock, key);
+}
+
+static size_t recommended_size(size_t used)
+{
+    return ROUND_UP(used + CONFIG_AUDIO_STACK_MARGIN, 64);
+}
+
+int audio_stack_track(k_tid_t tid, const char *name, size_t stack_size)
+{
+    struct stack_entry *e = NULL;
+    struct stack_entry *idle = NULL;
+    k_spinlock_key_t key = k_spin_lock(&stack_lock);
+
+    // A restarted strip gets its old entry back, high-water mark included
+    for (size_t i = 0; i < entry_count; i++) {
+        if (entries[i].tid) {
+            continue;
+        }
+        if (name && strcmp(entries[i].name, name) == 0) {
+            e = &entries[i];
+            break;
+        }
+        if (!idle) {
+            idle = &entries[i];
+        }
+    }
+
+    if (!e) {
+        if (entry_count < ARRAY_SIZE(entries)) {
+            e = &entries[entry_count++];
+        } else {
+            e = idle;
+        }
+        if (e) {
+            e->used = 0;
+        }
+    }
+
+    if (!e) {
+        k_spin_unlock(&stack_lock, key);
+        LOG_WRN("Stack tracking table full, '%s' not tracked", name ? name : "?");
+        return -ENOMEM;
+    }
+
+    if (e->size != stack_size) {
+        e->used = 0;
+    }
+    e->tid = tid;
+    e->size = stack_size;
+    if (name) {
+        e->name = name;
+    } else {
+        snprintf(e->anon, sizeof(e->anon), "thread@%p", (void *)tid);
+        e->name = e->anon;
+    }
+
+    k_spin_unlock(&stack_lock, key);
+    return 0;
+}
+
+void audio_stack_untrack(k_tid_t tid)
+{
+    for (size_t i = 0; i < entry_count; i++) {
+        k_spinlock_key_t key = k_spin_lock(&stack_lock);
+        bool match = entries[i].tid == tid;
+        k_spin_unlock(&stack_lock, key);
+
+        if (!match) {
+            continue;
+        }
+
+        sample_entry(i);
+
+        key = k_spin_lock(&stack_lock);
+        if (entries[i].tid == tid) {
+            entries[i].tid = NULL;
+        }
+        k_spin_unlock(&stack_lock, key);
+    }
+}
+
+int audio_stack_stats_get(size_t index, struct audio_stack_stats *stats)
+{
+    if (!stats) {
+        return -EINVAL;
+    }
+
+    if (index >= entry_count) {
+        return -ENOENT;
+    }
+
+    sample_entry(index);
+
+    k_spinlock_key_t key = k_spin_lock(&stack_lock);
+    struct stack_entry *e = &entries[index];
+
+    stats->name = e->name;
+    stats->size = e->size;
+    stats->used = e->used;
+    stats->recommended = recommended_size(e->used);
+
+    k_spin_unlock(&stack_lock, key);
+    return 0;
+}
+
+void audio_stack_stats_report(void)
+{
+    struct audio_stack_stats stats;
+    size_t total_size = 0;
+    size_t total_recommended = 0;
+
+    LOG_INF("Audio thread stacks (margin %d bytes):", CONFIG_AUDIO_STACK_MARGIN);
+
+    for (size_t i = 0; audio_stack_stats_get(i, &stats) == 0; i++) {
+        LOG_INF("  %-16s size %5zu  used %5zu  recommended %5zu",
+                stats.name, stats.size, stats.used, stats.recommended);
+        total_size += stats.size;
+        total_recommended += stats.recommended;
+    }
+
+    LOG_INF("  total %zu bytes, recommended %zu bytes", total_size, total_recommended);
+
+    /* Paste-ready profile for audio_stack_profile_set() */
+    printk("static const struct audio_stack_profile_entry audio_stack_profile[] = {\n");
+    for (size_t i = 0; audio_stack_stats_get(i, &stats) == 0; i++) {
+        printk("    { \"%s\", %zu },\n", stats.name, stats.recommended);
+    }
+    printk("};\n");
+}
+
+#endif /* CONFIG_AUDIO_STACK_STATS */
+
+#if defined(CONFIG_AUDIO_STACK_PROFILE)
+
+static const struct audio_stack_profile_entry *profile;
+static size_t profile_count;
+
+void audio_stack_profile_set(const struct audio_stack_profile_entry *table, size_t count)
+{
+    profile = table;
+    profile_count = count;
+}
+
+size_t audio_stack_profile_lookup(const char *name, size_t fallback)
+{
+    if (!name) {
+        return fallback;
+    }
+
+    for (size_t i = 0; i < profile_count; i++) {
+        if (profile[i].name && strcmp(profile[i].name, name) == 0) {
+            return profile[i].stack_size;
+        }
+    }
+
+    return fallback;
+}
+
+#endif /* CONFIG_AUDIO_STACK_PROFILE */
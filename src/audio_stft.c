@@ -0,0 +1,130 @@
+/**
+ * @file audio_stft.c
+ * @brief STFT/ISTFT overlap-add base for spectral nodes
+ */
+
+#include "audio_stft.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+int audio_stft_init(struct audio_stft *stft, const struct audio_stft_config *config)
+{
+    if (!stft || !config) {
+        return -EINVAL;
+    }
+
+    const size_t n = config->fft_size;
+    const size_t hop = config->hop_size;
+
+    if (hop == 0 || hop > n || (n % hop) != 0) {
+        return -EINVAL;
+    }
+
+    // Overlap-add needs at least two overlapping frames
+    if (!config->analysis_only && hop > n / 2) {
+        return -EINVAL;
+    }
+
+    stft->fft = audio_fft_plan(n);
+    if (!stft->fft) {
+        return -EINVAL;
+    }
+
+    stft->config = *config;
+    stft->mask = n - 1;
+
+    // Periodic sqrt-Hann: analysis * synthesis is a Hann window
+    for (size_t i = 0; i < n; i++) {
+        stft->window[i] = sqrtf(0.5f * (1.0f - cosf(2.0f * (float)M_PI * (float)i / (float)n)));
+    }
+
+    float sum = 0.0f;
+    for (size_t i = hop / 2; i < n; i += hop) {
+        sum += stft->window[i] * stft->window[i];
+    }
+    stft->ola_scale = 1.0f / sum;
+
+    audio_stft_reset(stft);
+    return 0;
+}
+
+void audio_stft_reset(struct audio_stft *stft)
+{
+    const size_t n = stft->config.fft_size;
+
+    memset(stft->in_ring, 0, n * sizeof(stft->in_ring[0]));
+    memset(stft->out_ring, 0, n * sizeof(stft->out_ring[0]));
+    stft->pos = 0;
+    stft->hop_fill = 0;
+    stft->primed = 0;
+    stft->frames = 0;
+}
+
+/* Analyzes the last fft_size samples (oldest at pos) and overlap-adds the result */
+static __audio_hot void stft_frame(struct audio_stft *stft)
+{
+    const size_t n = stft->config.fft_size;
+    const size_t mask = stft->mask;
+    const size_t pos = stft->pos;
+
+    for (size_t i = 0; i < n; i++) {
+        stft->frame[i] = (float)stft->in_ring[(pos + i) & mask] * (stft->window[i] / 32768.0f);
+    }
+
+    audio_fft_forward(stft->fft, stft->frame, stft->spec);
+
+    if (stft->config.frame) {
+        stft->config.frame(stft, stft->spec, stft->config.user_data);
+    }
+    stft->frames++;
+
+    if (stft->config.analysis_only) {
+        return;
+    }
+
+    audio_fft_inverse(stft->fft, stft->spec, stft->frame);
+
+    const float scale = stft->ola_scale * 32768.0f;
+    for (size_t i = 0; i < n; i++) {
+        stft->out_ring[(pos + i) & mask] += stft->frame[i] * stft->window[i] * scale;
+    }
+}
+
+__audio_hot void audio_stft_process(struct audio_stft *stft, int16_t *samples, size_t count)
+{
+    const size_t n = stft->config.fft_size;
+    const size_t hop = stft->config.hop_size;
+    const bool synth = !stft->config.analysis_only;
+
+    for (size_t i = 0; i < count; i++) {
+        stft->in_ring[stft->pos] = samples[i];
+        stft->pos = (stft->pos + 1) & stft->mask;
+
+        if (stft->primed < n) {
+            stft->primed++;
+        }
+
+        if (++stft->hop_fill == hop) {
+            stft->hop_fill = 0;
+            if (synth || stft->primed == n) {
+                stft_frame(stft);
+            }
+        }
+
+        if (synth) {
+            // The slot just freed holds the completed output fft_size - 1 samples back
+            float y = stft->out_ring[stft->pos];
+            stft->out_ring[stft->pos] = 0.0f;
+            samples[i] = (int16_t)CLAMP(lrintf(y), INT16_MIN, INT16_MAX);
+        }
+    }
+}
+
+uint32_t audio_stft_latency(const struct audio_stft *stft)
+{
+    return stft->config.analysis_only ? 0 : stft->config.fft_size - 1;
+}
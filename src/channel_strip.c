@@ -4,20 +4,86 @@
  */
 
 #include "channel_strip.h"
+#include "audio_preset.h"
 #include <zephyr/logging/log.h>
+#if defined(CONFIG_AUDIO_MIXER_AUTOMIX)
+#include <math.h>
+#include <string.h>
+#if defined(__ARM_FEATURE_SIMD32)
+#include <arm_acle.h>
+#endif
+#endif
 
 LOG_MODULE_REGISTER(channel_strip, LOG_LEVEL_INF);
 
+// How long the mixer waits for a released block before skipping a channel
+#define MIXER_ALLOC_TIMEOUT K_USEC(CONFIG_AUDIO_MIXER_ALLOC_TIMEOUT_US)
+
 // ============================================================================
 // Channel Strip Implementation
 // ============================================================================
 
+static void audio_mixer_wake(struct audio_mixer *mixer);
+
+/**
+ * @brief Wakes a running strip thread for queued commands or a rate change.
+ *
+ * With a silent source (see audio_idle.h) no block arrives, so the thread
+ * also waits for this marker in its input FIFO. It is queued at most once.
+ */
+static void channel_strip_wake(struct channel_strip *strip)
+{
+    if (strip->mixer) {
+        audio_mixer_wake(strip->mixer);
+    } else if (strip->thread_id && atomic_cas(&strip->cmd_wake_pending, 0, 1)) {
+        k_fifo_put(&strip->in_fifo, &strip->cmd_wake);
+    }
+}
+
+static void channel_strip_cmd_wake(struct audio_cmd_queue *q)
+{
+    channel_strip_wake(CONTAINER_OF(q, struct channel_strip, cmds));
+}
+
 void channel_strip_init(struct channel_strip *strip, const char *name)
 {
     strip->node_count = 0;
     strip->out_fifo = NULL;
     strip->thread_id = NULL;
+    strip->suspended = false;
+    k_mutex_init(&strip->thread_lock);
     strip->name = name ? name : "Unnamed";
+    strip->sample_rate = CONFIG_AUDIO_SAMPLE_RATE;
+    strip->batch_max = CONFIG_AUDIO_STRIP_BATCH_MAX;
+    strip->load_cycles = 0;
+    strip->bypass_mask = 0;
+    audio_cmd_queue_init(&strip->cmds);
+    strip->cmds.wake = channel_strip_cmd_wake;
+    atomic_set(&strip->cmd_wake_pending, 0);
+#if defined(CONFIG_AUDIO_MODULATION)
+    sys_slist_init(&strip->mods);
+    strip->mod_tick = 0;
+#endif
+#if defined(CONFIG_AUDIO_IDLE)
+    audio_idle_residency_init(&strip->idle);
+#endif
+#if defined(CONFIG_AUDIO_POOL_RESERVATIONS)
+    strip->pool_class = 0;
+#endif
+#if defined(CONFIG_AUDIO_STRIP_DEADLINE)
+    strip->deadline_mode = false;
+    strip->deadline_misses = 0;
+    atomic_set(&strip->arrival_cycles, 0);
+    atomic_set(&strip->queued_blocks, 0);
+#endif
+#if defined(CONFIG_AUDIO_SMP_AFFINITY)
+    strip->cpu_mask = 0;
+#endif
+    atomic_set(&strip->pending_rate, 0);
+    strip->mixer = NULL;
+#if defined(CONFIG_AUDIO_STACK_PROFILE)
+    strip->dyn_stack = NULL;
+#endif
     k_fifo_init(&strip->in_fifo);
 
     // Clear node array
@@ -33,9 +99,72 @@ int channel_strip_add_node(struct channel_strip *strip, struct audio_node *node)
     }
 
     strip->nodes[strip->node_count++] = node;
+
+    // New nodes start at the pipeline's rate
+    audio_node_set_sample_rate(node, strip->sample_rate);
     return 0;
 }
 
+/**
+ * @brief Applies a sample rate to the strip and all of its nodes.
+ *
+ * Must run between blocks (strip thread or strip not running).
+ */
+static void channel_strip_apply_sample_rate(struct channel_strip *strip, uint32_t sample_rate)
+{
+    if (sample_rate == strip->sample_rate) {
+        return;
+    }
+
+    strip->sample_rate = sample_rate;
+    for (size_t i = 0; i < strip->node_count; i++) {
+        audio_node_set_sample_rate(strip->nodes[i], sample_rate);
+    }
+
+    LOG_INF("Channel strip '%s' now at %u Hz", strip->name, sample_rate);
+}
+
+/**
+ * @brief Applies a rate requested while the strip thread was running.
+ */
+static inline void channel_strip_apply_pending_rate(struct channel_strip *strip)
+{
+    uint32_t rate = (uint32_t)atomic_clear(&strip->pending_rate);
+
+    if (rate) {
+        channel_strip_apply_sample_rate(strip, rate);
+    }
+}
+
+int channel_strip_set_sample_rate(struct channel_strip *strip, uint32_t sample_rate)
+{
+    if (sample_rate == 0) {
+        return -EINVAL;
+    }
+
+    // The mixer thread runs these nodes and sets their rate between blocks
+    if (strip->mixer) {
+        return -EBUSY;
+    }
+
+    if (strip->thread_id) {
+        // One change at a time; the thread has not taken the last one yet
+        if (!atomic_cas(&strip->pending_rate, 0, (atomic_val_t)sample_rate)) {
+            return -EBUSY;
+        }
+        channel_strip_wake(strip);
+    } else {
+        channel_strip_apply_sample_rate(strip, sample_rate);
+    }
+
+    return 0;
+}
+
+uint32_t channel_strip_get_sample_rate(const struct channel_strip *strip)
+{
+    return strip->sample_rate;
+}
+
 void channel_strip_clear(struct channel_strip *strip)
 {
     strip->node_count = 0;
@@ -44,8 +173,8 @@ void channel_strip_clear(struct channel_strip *strip)
     }
 }
 
-struct audio_block* channel_strip_process_block(struct channel_strip *strip,
-                                                 struct audio_block *block)
+__audio_hot struct audio_block* channel_strip_process_block(struct channel_strip *strip,
+                                                             struct audio_block *block)
 {
     if (!block) {
         return NULL;
@@ -53,6 +182,10 @@ struct audio_block* channel_strip_process_block(struct channel_strip *strip,
 
     // Sequential processing through all nodes
     for (size_t i = 0; i < strip->node_count; i++) {
+        if (strip->bypass_mask & BIT(i)) {
+            continue;
+        }
+        audio_block_set_owner(block, strip->name, (int)i);
         block = audio_node_process(strip->nodes[i], block);
 
         // If a node returns NULL, it's dropping the block (e.g., gate/mute)
@@ -64,28 +197,596 @@ struct audio_block* channel_strip_process_block(struct channel_strip *strip,
     return block;
 }
 
+__audio_hot size_t channel_strip_process_batch(struct channel_strip *strip,
+                                              struct audio_block **blocks,
+                                              size_t count)
+{
+    // Node-major: each node runs over the whole batch while its code and
+    // state are hot, instead of walking the chain once per block.
+    for (size_t i = 0; i < strip->node_count && count > 0; i++) {
+        struct audio_node *node = strip->nodes[i];
+        size_t kept = 0;
+
+        if (strip->bypass_mask & BIT(i)) {
+            continue;
+        }
+
+        for (size_t b = 0; b < count; b++) {
+            audio_block_set_owner(blocks[b], strip->name, (int)i);
+            struct audio_block *out = audio_node_process(node, blocks[b]);
+
+            // Dropped blocks are compacted out, order is preserved
+            if (out) {
+                blocks[kept++] = out;
+            }
+        }
+
+        count = kept;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Executes one control command in the processing thread.
+ */
+static void channel_strip_exec_command(struct channel_strip *strip, const struct audio_cmd *cmd)
+{
+    bool all = (cmd->node == CHANNEL_STRIP_ALL_NODES);
+    struct audio_node *node = (cmd->node < strip->node_count) ? strip->nodes[cmd->node] : NULL;
+    float value = 0.0f;
+    int ret;
+
+    switch (cmd->type) {
+    case AUDIO_CMD_SET_PARAM:
+        ret = audio_node_set_param(node, cmd->id, cmd->value, cmd->arg);
+        if (ret != 0) {
+            LOG_WRN("Channel strip '%s': node %u param %u rejected (%d)",
+                    strip->name, cmd->node, cmd->id, ret);
+        }
+        break;
+
+    case AUDIO_CMD_BYPASS: {
+        uint32_t mask = all ? BIT_MASK(CHANNEL_STRIP_MAX_NODES) : BIT(cmd->node);
+        if (cmd->arg) {
+            strip->bypass_mask |= mask;
+        } else {
+            strip->bypass_mask &= ~mask;
+        }
+        break;
+    }
+
+    case AUDIO_CMD_RESET:
+        for (size_t i = 0; i < strip->node_count; i++) {
+            if (all || i == cmd->node) {
+                audio_node_reset(strip->nodes[i]);
+            }
+        }
+        break;
+
+    case AUDIO_CMD_READ_PARAM:
+        ret = audio_node_get_param(node, cmd->id, &value);
+        audio_cmd_reply(&strip->cmds, cmd->arg, ret, value);
+        break;
+
+#if defined(CONFIG_AUDIO_MODULATION)
+    case AUDIO_CMD_MOD_BIND:
+        sys_slist_append(&strip->mods, &((struct audio_mod_binding *)cmd->ptr)->snode);
+        break;
+
+    case AUDIO_CMD_MOD_UNBIND:
+        sys_slist_find_and_remove(&strip->mods, &((struct audio_mod_binding *)cmd->ptr)->snode);
+        break;
+#endif
+
+    case AUDIO_CMD_APPLY_PRESET: {
+        struct audio_preset *preset = cmd->ptr;
+        audio_preset_apply_to_strip(strip, preset, 0);
+        atomic_dec(&preset->pending);
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+void channel_strip_apply_commands(struct channel_strip *strip)
+{
+    struct audio_cmd cmd;
+
+    while (audio_cmd_pop(&strip->cmds, &cmd)) {
+        channel_strip_exec_command(strip, &cmd);
+    }
+}
+
+static int channel_strip_queue(struct channel_strip *strip, uint8_t type, uint8_t node,
+                               uint32_t id, float value, uint32_t arg)
+{
+    if (node >= CHANNEL_STRIP_MAX_NODES && node != CHANNEL_STRIP_ALL_NODES) {
+        return -EINVAL;
+    }
+
+    struct audio_cmd cmd = {
+        .type = type,
+        .node = node,
+        .id = id,
+        .value = value,
+        .arg = arg,
+    };
+
+    return audio_cmd_push(&strip->cmds, &cmd);
+}
+
+int channel_strip_set_param(struct channel_strip *strip, uint8_t node, uint32_t id,
+                            float value, uint32_t ramp_samples)
+{
+    if (node == CHANNEL_STRIP_ALL_NODES) {
+        return -EINVAL;
+    }
+    return channel_strip_queue(strip, AUDIO_CMD_SET_PARAM, node, id, value, ramp_samples);
+}
+
+int channel_strip_set_bypass(struct channel_strip *strip, uint8_t node, bool bypass)
+{
+    return channel_strip_queue(strip, AUDIO_CMD_BYPASS, node, 0, 0.0f, bypass);
+}
+
+int channel_strip_reset_node(struct channel_strip *strip, uint8_t node)
+{
+    return channel_strip_queue(strip, AUDIO_CMD_RESET, node, 0, 0.0f, 0);
+}
+
+int channel_strip_read_param(struct channel_strip *strip, uint8_t node, uint32_t id,
+                             float *value, k_timeout_t timeout)
+{
+    if (node >= CHANNEL_STRIP_MAX_NODES || !value) {
+        return -EINVAL;
+    }
+
+    struct audio_cmd cmd = {
+        .node = node,
+        .id = id,
+    };
+
+    return audio_cmd_read(&strip->cmds, &cmd, value, timeout);
+}
+
+#if defined(CONFIG_AUDIO_MODULATION)
+int channel_strip_mod_bind(struct channel_strip *strip, struct audio_mod_binding *binding,
+                           struct audio_mod_source *source, uint8_t node, uint32_t param,
+                           float center, float depth)
+{
+    if (node >= CHANNEL_STRIP_MAX_NODES || !binding || !source) {
+        return -EINVAL;
+    }
+
+    binding->source = source;
+    binding->node = node;
+    binding->param = param;
+    binding->center = center;
+    binding->depth = depth;
+
+    struct audio_cmd cmd = {
+        .type = AUDIO_CMD_MOD_BIND,
+        .ptr = binding,
+    };
+
+    return audio_cmd_push(&strip->cmds, &cmd);
+}
+
+int channel_strip_mod_unbind(struct channel_strip *strip, struct audio_mod_binding *binding)
+{
+    struct audio_cmd cmd = {
+        .type = AUDIO_CMD_MOD_UNBIND,
+        .ptr = binding,
+    };
+
+    return audio_cmd_push(&strip->cmds, &cmd);
+}
+
+void channel_strip_apply_modulation(struct channel_strip *strip, uint32_t samples,
+                                    uint32_t tick)
+{
+    struct audio_mod_binding *binding;
+
+    SYS_SLIST_FOR_EACH_CONTAINER(&strip->mods, binding, snode) {
+        struct audio_mod_source *src = binding->source;
+
+        // Shared sources advance once per block
+        if (src->tick != tick) {
+            src->tick = tick;
+            audio_mod_advance(src, samples, strip->sample_rate);
+        }
+
+        if (binding->node < strip->node_count) {
+            // Ramp over the block: nodes interpolate between control points
+            audio_node_set_param(strip->nodes[binding->node], binding->param,
+                                 binding->center + binding->depth * src->value, samples);
+        }
+    }
+}
+#endif /* CONFIG_AUDIO_MODULATION */
+
+int channel_strip_set_batch_limit(struct channel_strip *strip, size_t max_blocks)
+{
+    if (max_blocks == 0 || max_blocks > CONFIG_AUDIO_STRIP_BATCH_MAX) {
+        return -EINVAL;
+    }
+
+    strip->batch_max = max_blocks;
+    return 0;
+}
+
+/**
+ * @brief Updates the strip's smoothed processing cost per block.
+ */
+static inline void channel_strip_account_load(struct channel_strip *strip,
+                                              uint32_t cycles, size_t blocks)
+{
+    uint32_t per_block = cycles / blocks;
+
+    if (strip->load_cycles == 0) {
+        strip->load_cycles = per_block;
+    } else {
+        // EWMA, alpha = 1/8
+        strip->load_cycles = strip->load_cycles - (strip->load_cycles >> 3) + (per_block >> 3);
+    }
+}
+
+uint32_t channel_strip_get_load(const struct channel_strip *strip)
+{
+    return strip->load_cycles;
+}
+
+/**
+ * @brief Suspends or resumes a strip or mixer thread and records the state.
+ */
+static int set_thread_suspended(k_tid_t tid, struct k_mutex *lock, bool *suspended,
+                                bool suspend)
+{
+    if (!tid) {
+        return -ESRCH;
+    }
+
+    if (suspend && tid == k_current_get()) {
+        return -EDEADLK;
+    }
+
+    k_mutex_lock(lock, K_FOREVER);
+    if (suspend && !*suspended) {
+        k_thread_suspend(tid);
+    } else if (!suspend && *suspended) {
+        k_thread_resume(tid);
+    }
+    *suspended = suspend;
+    k_mutex_unlock(lock);
+
+    return 0;
+}
+
+int channel_strip_suspend(struct channel_strip *strip)
+{
+    return set_thread_suspended(strip->thread_id, &strip->thread_lock, &strip->suspended, true);
+}
+
+int channel_strip_resume(struct channel_strip *strip)
+{
+    return set_thread_suspended(strip->thread_id, &strip->thread_lock, &strip->suspended, false);
+}
+
+int audio_mixer_suspend(struct audio_mixer *mixer)
+{
+    return set_thread_suspended(mixer->thread_id, &mixer->thread_lock, &mixer->suspended, true);
+}
+
+int audio_mixer_resume(struct audio_mixer *mixer)
+{
+    return set_thread_suspended(mixer->thread_id, &mixer->thread_lock, &mixer->suspended, false);
+}
+
+#if defined(CONFIG_AUDIO_SMP_AFFINITY)
+/**
+ * @brief Restricts a thread to the CPUs in mask (0 = all CPUs).
+ *
+ * The thread must not be runnable (created with K_FOREVER or suspended).
+ */
+static int apply_cpu_mask(k_tid_t tid, uint32_t mask)
+{
+    int ret;
+
+    if (mask == 0) {
+        return k_thread_cpu_mask_enable_all(tid);
+    }
+
+    ret = k_thread_cpu_mask_clear(tid);
+    for (unsigned int cpu = 0; ret == 0 && cpu < arch_num_cpus(); cpu++) {
+        if (mask & BIT(cpu)) {
+            ret = k_thread_cpu_mask_enable(tid, cpu);
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Applies a new mask to a thread that may already be running.
+ *
+ * A running thread is suspended for the change and resumes on one of
+ * the allowed CPUs. A thread suspended through the strip/mixer API stays
+ * suspended; lock keeps that state stable meanwhile. The thread cannot
+ * move itself this way.
+ */
+static int update_cpu_mask(k_tid_t tid, struct k_mutex *lock, const bool *suspended,
+                           uint32_t mask)
+{
+    if (!tid) {
+        return 0;  // Applied at start
+    }
+
+    if (tid == k_current_get()) {
+        return -EDEADLK;
+    }
+
+    k_mutex_lock(lock, K_FOREVER);
+    if (!*suspended) {
+        k_thread_suspend(tid);
+    }
+    int ret = apply_cpu_mask(tid, mask);
+    if (!*suspended) {
+        k_thread_resume(tid);
+    }
+    k_mutex_unlock(lock);
+
+    return ret;
+}
+
+int channel_strip_set_cpu_mask(struct channel_strip *strip, uint32_t cpu_mask)
+{
+    if (cpu_mask & ~BIT_MASK(arch_num_cpus())) {
+        return -EINVAL;
+    }
+
+    int ret = update_cpu_mask(strip->thread_id, &strip->thread_lock, &strip->suspended,
+                              cpu_mask);
+    if (ret == 0) {
+        strip->cpu_mask = cpu_mask;
+    }
+    return ret;
+}
+
+int audio_mixer_set_cpu_mask(struct audio_mixer *mixer, uint32_t cpu_mask)
+{
+    if (cpu_mask & ~BIT_MASK(arch_num_cpus())) {
+        return -EINVAL;
+    }
+
+    int ret = update_cpu_mask(mixer->thread_id, &mixer->thread_lock, &mixer->suspended,
+                              cpu_mask);
+    if (ret == 0) {
+        mixer->cpu_mask = cpu_mask;
+    }
+    return ret;
+}
+
+int channel_strip_balance(struct channel_strip **strips, size_t count)
+{
+    uint32_t cpu_load[CONFIG_MP_MAX_NUM_CPUS] = { 0 };
+    uint8_t order[CONFIG_AUDIO_SMP_BALANCE_MAX_STRIPS];
+    unsigned int num_cpus = arch_num_cpus();
+    bool measured = true;
+
+    if (count > ARRAY_SIZE(order)) {
+        return -EINVAL;
+    }
+
+    // Strips that never ran have no load yet; weigh everyone by node count then
+    for (size_t i = 0; i < count; i++) {
+        if (strips[i]->load_cycles == 0) {
+            measured = false;
+        }
+    }
+
+#define STRIP_WEIGHT(s) (measured ? (s)->load_cycles : (uint32_t)(s)->node_count)
+
+    // Longest-processing-time first: sort by weight, descending
+    for (size_t i = 0; i < count; i++) {
+        size_t j = i;
+        order[i] = (uint8_t)i;
+        while (j > 0 && STRIP_WEIGHT(strips[order[j - 1]]) < STRIP_WEIGHT(strips[order[j]])) {
+            uint8_t tmp = order[j - 1];
+            order[j - 1] = order[j];
+            order[j] = tmp;
+            j--;
+        }
+    }
+
+    // Put each strip on the currently least loaded CPU
+    for (size_t i = 0; i < count; i++) {
+        struct channel_strip *strip = strips[order[i]];
+        unsigned int best = 0;
+
+        for (unsigned int cpu = 1; cpu < num_cpus; cpu++) {
+            if (cpu_load[cpu] < cpu_load[best]) {
+                best = cpu;
+            }
+        }
+
+        cpu_load[best] += STRIP_WEIGHT(strip);
+
+        int ret = channel_strip_set_cpu_mask(strip, BIT(best));
+        if (ret) {
+            return ret;
+        }
+
+        LOG_INF("Channel strip '%s' -> CPU %u (load %u)", strip->name, best,
+                STRIP_WEIGHT(strip));
+    }
+
+#undef STRIP_WEIGHT
+
+    return 0;
+}
+#endif /* CONFIG_AUDIO_SMP_AFFINITY */
+
+#if defined(CONFIG_AUDIO_STRIP_DEADLINE)
+/**
+ * @brief Duration of one block at the strip's rate, in hardware cycles.
+ */
+static inline uint32_t channel_strip_block_period(const struct channel_strip *strip,
+                                                  const struct audio_block *block)
+{
+    return (uint32_t)(((uint64_t)block->data_len * sys_clock_hw_cycles_per_sec()) /
+                      strip->sample_rate);
+}
+
+/**
+ * @brief Sets the thread deadline for the batch that just woke the strip.
+ *
+ * The deadline is the arrival of the first block plus one block period.
+ *
+ * @return The block period in cycles
+ */
+static uint32_t channel_strip_deadline_begin(struct channel_strip *strip,
+                                             const struct audio_block *first)
+{
+    uint32_t period = channel_strip_block_period(strip, first);
+
+    if (strip->deadline_mode) {
+        uint32_t elapsed = k_cycle_get_32() - (uint32_t)atomic_get(&strip->arrival_cycles);
+        int32_t remaining = (int32_t)(period - elapsed);
+
+        // Already late: earliest possible deadline
+        k_thread_deadline_set(k_current_get(), MAX(remaining, 1));
+    }
+
+    return period;
+}
+
+/**
+ * @brief Counts a miss if the batch finished after its deadline.
+ */
+static void channel_strip_deadline_end(struct channel_strip *strip,
+                                       uint32_t period, size_t blocks)
+{
+    uint32_t arrival = (uint32_t)atomic_get(&strip->arrival_cycles);
+
+    if ((k_cycle_get_32() - arrival) > period) {
+        strip->deadline_misses++;
+    }
+
+    // Blocks still queued arrived while we were busy; assume periodic arrival
+    if (atomic_get(&strip->queued_blocks) != 0) {
+        atomic_set(&strip->arrival_cycles, (atomic_val_t)(arrival + period * blocks));
+    }
+}
+
+void channel_strip_set_deadline_mode(struct channel_strip *strip, bool enable)
+{
+    strip->deadline_mode = enable;
+}
+
+uint32_t channel_strip_get_deadline_misses(const struct channel_strip *strip)
+{
+    return strip->deadline_misses;
+}
+#endif /* CONFIG_AUDIO_STRIP_DEADLINE */
+
 /**
  * @brief Thread entry point for channel strip processing.
  */
 static void channel_strip_thread_entry(void *p1, void *p2, void *p3)
 {
     struct channel_strip *strip = (struct channel_strip *)p1;
+    struct audio_block *batch[CONFIG_AUDIO_STRIP_BATCH_MAX];
 
     LOG_INF("Channel strip '%s' thread started", strip->name);
 
     while (1) {
-        // Block waiting for input
-        struct audio_block *block = k_fifo_get(&strip->in_fifo, K_FOREVER);
+        // Block waiting for input, then drain whatever else is queued
+        size_t count = 0;
+        void *item = k_fifo_get(&strip->in_fifo, K_FOREVER);
+
+        // Woken for control alone: apply it without waiting for a block
+        if (item == &strip->cmd_wake) {
+            atomic_clear(&strip->cmd_wake_pending);
+            channel_strip_apply_pending_rate(strip);
+            channel_strip_apply_commands(strip);
+            continue;
+        }
+        batch[count++] = item;
+
+        while (count < strip->batch_max) {
+            void *next = k_fifo_get(&strip->in_fifo, K_NO_WAIT);
+            if (!next) {
+                break;
+            }
+            // Commands are applied below, before this batch
+            if (next == &strip->cmd_wake) {
+                atomic_clear(&strip->cmd_wake_pending);
+                continue;
+            }
+            batch[count++] = next;
+        }
+
+#if defined(CONFIG_AUDIO_STRIP_DEADLINE)
+        atomic_sub(&strip->queued_blocks, (atomic_val_t)count);
+#endif
+
+#if defined(CONFIG_AUDIO_IDLE)
+        audio_idle_residency_leave(&strip->idle);
+        bool goes_idle = (batch[count - 1]->flags & AUDIO_BLOCK_FLAG_IDLE) != 0;
+#endif
+
+        // Rate changes and control commands take effect on a batch boundary
+        channel_strip_apply_pending_rate(strip);
+        channel_strip_apply_commands(strip);
+
+#if defined(CONFIG_AUDIO_MODULATION)
+        // One control point per batch, ramped across all of its samples
+        uint32_t batch_samples = 0;
+        for (size_t b = 0; b < count; b++) {
+            batch_samples += batch[b]->data_len;
+        }
+        // Tick 0 is what sources start with, skip it on wrap
+        if (++strip->mod_tick == 0) {
+            strip->mod_tick = 1;
+        }
+        channel_strip_apply_modulation(strip, batch_samples, strip->mod_tick);
+#endif
+
+#if defined(CONFIG_AUDIO_STRIP_DEADLINE)
+        uint32_t period = channel_strip_deadline_begin(strip, batch[0]);
+#endif
 
         // Process through all nodes sequentially
-        block = channel_strip_process_block(strip, block);
+        uint32_t start = k_cycle_get_32();
+        size_t in_count = count;
+
+        count = channel_strip_process_batch(strip, batch, count);
+
+        channel_strip_account_load(strip, k_cycle_get_32() - start, in_count);
+
+#if defined(CONFIG_AUDIO_STRIP_DEADLINE)
+        channel_strip_deadline_end(strip, period, in_count);
+#endif
+
+#if defined(CONFIG_AUDIO_IDLE)
+        // Nodes may have replaced the block, carry the marker over
+        if (goes_idle) {
+            if (count > 0) {
+                batch[count - 1]->flags |= AUDIO_BLOCK_FLAG_IDLE;
+            }
+            audio_idle_residency_enter(&strip->idle);
+        }
+#endif
 
         // Push to output or release
-        if (block) {
+        for (size_t b = 0; b < count; b++) {
             if (strip->out_fifo) {
-                k_fifo_put(strip->out_fifo, block);
+                k_fifo_put(strip->out_fifo, batch[b]);
             } else {
-                audio_block_release(block);
+                audio_block_release(batch[b]);
             }
         }
     }
@@ -103,24 +804,102 @@ void channel_strip_start(struct channel_strip *strip,
                                        strip, NULL, NULL,
                                        priority,
                                        0,
-                                       K_NO_WAIT);
+                                       K_FOREVER);
+
+#if defined(CONFIG_AUDIO_SMP_AFFINITY)
+    // CPU mask can only be changed before the thread becomes runnable
+    if (apply_cpu_mask(strip->thread_id, strip->cpu_mask) != 0) {
+        LOG_WRN("Channel strip '%s': CPU mask 0x%x not applied", strip->name, strip->cpu_mask);
+    }
+#endif
 
     // Set thread name for debugging
     char thread_name[16];
     snprintf(thread_name, sizeof(thread_name), "strip_%s", strip->name);
     k_thread_name_set(strip->thread_id, thread_name);
+
+    audio_stack_track(strip->thread_id, strip->name, stack_size);
+
+#if defined(CONFIG_AUDIO_POOL_RESERVATIONS)
+    if (strip->pool_class != 0 &&
+        audio_pool_bind_thread(strip->thread_id, strip->pool_class) != 0) {
+        LOG_WRN("Channel strip '%s': pool class %u not bound", strip->name, strip->pool_class);
+    }
+#endif
+
+    k_thread_start(strip->thread_id);
 }
 
+#if defined(CONFIG_AUDIO_STACK_PROFILE)
+int channel_strip_start_profiled(struct channel_strip *strip, int priority)
+{
+    size_t stack_size = audio_stack_profile_lookup(strip->name,
+                                                   CONFIG_AUDIO_THREAD_STACK_SIZE);
+
+    strip->dyn_stack = k_thread_stack_alloc(stack_size, 0);
+    if (!strip->dyn_stack) {
+        LOG_ERR("No stack for strip '%s' (%zu bytes)", strip->name, stack_size);
+        return -ENOMEM;
+    }
+
+    channel_strip_start(strip, strip->dyn_stack, stack_size, priority);
+    return 0;
+}
+#endif
+
 void channel_strip_stop(struct channel_strip *strip)
 {
     if (strip->thread_id) {
+        audio_stack_untrack(strip->thread_id);
+#if defined(CONFIG_AUDIO_POOL_RESERVATIONS)
+        audio_pool_unbind_thread(strip->thread_id);
+#endif
         k_thread_abort(strip->thread_id);
         strip->thread_id = NULL;
+        strip->suspended = false;
+    }
+
+#if defined(CONFIG_AUDIO_STACK_PROFILE)
+    if (strip->dyn_stack) {
+        k_thread_stack_free(strip->dyn_stack);
+        strip->dyn_stack = NULL;
     }
+#endif
+}
+
+#if defined(CONFIG_AUDIO_POOL_RESERVATIONS)
+int channel_strip_set_pool_class(struct channel_strip *strip, uint8_t cls)
+{
+    if (cls >= CONFIG_AUDIO_POOL_CLASSES) {
+        return -EINVAL;
+    }
+
+    strip->pool_class = cls;
+
+    if (strip->thread_id) {
+        return audio_pool_bind_thread(strip->thread_id, cls);
+    }
+    return 0;
 }
+#endif
+
+#if defined(CONFIG_AUDIO_IDLE)
+void channel_strip_get_idle_stats(struct channel_strip *strip, struct audio_idle_stats *stats)
+{
+    audio_idle_residency_get(&strip->idle, stats);
+}
+#endif
 
 void channel_strip_push_input(struct channel_strip *strip, struct audio_block *block)
 {
+#if defined(CONFIG_AUDIO_STRIP_DEADLINE)
+    // Arrival of the block that will wake the strip starts its deadline.
+    // Counted rather than k_fifo_is_empty(): a cmd_wake marker is no block.
+    if (atomic_inc(&strip->queued_blocks) == 0) {
+        atomic_set(&strip->arrival_cycles, (atomic_val_t)k_cycle_get_32());
+    }
+#endif
+    audio_block_set_owner(block, strip->name, AUDIO_BLOCK_OWNER_NO_NODE);
     k_fifo_put(&strip->in_fifo, block);
 }
 
@@ -128,12 +907,44 @@ void channel_strip_push_input(struct channel_strip *strip, struct audio_block *b
 // Mixer Implementation
 // ============================================================================
 
+/**
+ * @brief Wakes a running mixer thread for its strips' queued commands.
+ *
+ * Mixer channels and the master have no thread of their own; their
+ * commands are drained by the mixer thread, which this wakes like
+ * channel_strip_wake() wakes a strip thread.
+ */
+static void audio_mixer_wake(struct audio_mixer *mixer)
+{
+    if (mixer->thread_id && atomic_cas(&mixer->cmd_wake_pending, 0, 1)) {
+        k_fifo_put(&mixer->in_fifo, &mixer->cmd_wake);
+    }
+}
+
 void audio_mixer_init(struct audio_mixer *mixer)
 {
     mixer->channel_count = 0;
     mixer->master = NULL;
     mixer->out_fifo = NULL;
     mixer->thread_id = NULL;
+    mixer->suspended = false;
+    k_mutex_init(&mixer->thread_lock);
+    mixer->sample_rate = CONFIG_AUDIO_SAMPLE_RATE;
+#if defined(CONFIG_AUDIO_SMP_AFFINITY)
+    mixer->cpu_mask = 0;
+#endif
+    atomic_set(&mixer->pending_rate, 0);
+    atomic_ptr_set(&mixer->pending_preset, NULL);
+    atomic_set(&mixer->cmd_wake_pending, 0);
+#if defined(CONFIG_AUDIO_MODULATION)
+    mixer->mod_tick = 0;
+#endif
+#if defined(CONFIG_AUDIO_IDLE)
+    audio_idle_residency_init(&mixer->idle);
+#endif
+#if defined(CONFIG_AUDIO_MIXER_AUTOMIX)
+    mixer->automix.enabled = false;
+#endif
     k_fifo_init(&mixer->in_fifo);
 
     for (size_t i = 0; i < MIXER_MAX_CHANNELS; i++) {
@@ -148,63 +959,298 @@ int audio_mixer_add_channel(struct audio_mixer *mixer, struct channel_strip *str
     }
 
     mixer->channels[mixer->channel_count] = strip;
+    strip->mixer = mixer;
+    channel_strip_apply_sample_rate(strip, mixer->sample_rate);
     return mixer->channel_count++;
 }
 
 void audio_mixer_set_master(struct audio_mixer *mixer, struct channel_strip *master)
 {
+    if (mixer->master) {
+        mixer->master->mixer = NULL;
+    }
+
     mixer->master = master;
+    if (master) {
+        master->mixer = mixer;
+        channel_strip_apply_sample_rate(master, mixer->sample_rate);
+    }
 }
 
-struct audio_block* audio_mixer_process_block(struct audio_mixer *mixer,
-                                               struct audio_block *block)
+#if defined(CONFIG_AUDIO_MIXER_AUTOMIX)
+
+// Unity automix gain, Q30
+#define AUTOMIX_UNITY (1 << 30)
+
+/* Per-block level smoothing for a time constant, Q16 */
+static uint32_t automix_coeff(uint32_t sample_rate, uint16_t tau_ms)
+{
+    float block_ms = 1000.0f * CONFIG_AUDIO_BLOCK_SAMPLES / (float)sample_rate;
+
+    return (uint32_t)lrintf((1.0f - expf(-block_ms / (float)tau_ms)) * 65536.0f);
+}
+
+static void automix_update_timing(struct audio_mixer *mixer)
+{
+    struct audio_mixer_automix *am = &mixer->automix;
+
+    am->attack = automix_coeff(mixer->sample_rate, am->config.attack_ms);
+    am->release = automix_coeff(mixer->sample_rate, am->config.release_ms);
+}
+
+int audio_mixer_set_automix(struct audio_mixer *mixer,
+                            const struct audio_mixer_automix_config *config)
+{
+    struct audio_mixer_automix *am = &mixer->automix;
+
+    if (!config) {
+        am->enabled = false;
+        return 0;
+    }
+
+    if (config->attack_ms == 0 || config->release_ms == 0) {
+        return -EINVAL;
+    }
+
+    // Full scale is a mean square of 2^30; at least 1 keeps silence shared
+    float rms = 32768.0f * powf(10.0f, config->floor_dbfs / 20.0f);
+
+    am->config = *config;
+    am->floor = (uint32_t)CLAMP(rms * rms, 1.0f, (float)(1U << 30));
+    automix_update_timing(mixer);
+
+    // Channels fade in over the first block
+    memset(am->level, 0, sizeof(am->level));
+    memset(am->gain, 0, sizeof(am->gain));
+    am->enabled = true;
+    return 0;
+}
+
+size_t audio_mixer_get_automix_gains(struct audio_mixer *mixer, float *gains, size_t count)
+{
+    count = MIN(count, mixer->channel_count);
+
+    for (size_t ch = 0; ch < count; ch++) {
+        gains[ch] = (float)mixer->automix.gain[ch] / (float)AUTOMIX_UNITY;
+    }
+    return count;
+}
+
+/**
+ * @brief Gain-sharing targets from the levels up to the previous block.
+ */
+static void automix_targets(struct audio_mixer_automix *am, size_t channels)
+{
+    uint64_t total = 0;
+
+    for (size_t ch = 0; ch < channels; ch++) {
+        total += (uint64_t)am->level[ch] + am->floor;
+    }
+
+    const float inv = 1.0f / (float)total;
+
+    for (size_t ch = 0; ch < channels; ch++) {
+        float share = (float)((uint64_t)am->level[ch] + am->floor) * inv;
+
+        am->target[ch] = (int32_t)(sqrtf(share) * (float)AUTOMIX_UNITY);
+        am->block_level[ch] = 0;
+    }
+}
+
+/**
+ * @brief Smooths the block levels into the channel levels.
+ *
+ * Skipped channels count as silent for the block.
+ */
+static void automix_levels(struct audio_mixer_automix *am, size_t channels)
+{
+    for (size_t ch = 0; ch < channels; ch++) {
+        uint32_t level = am->level[ch];
+        uint32_t x = am->block_level[ch];
+
+        if (x > level) {
+            level += (uint32_t)(((uint64_t)(x - level) * am->attack) >> 16);
+        } else {
+            level -= (uint32_t)(((uint64_t)(level - x) * am->release) >> 16);
+        }
+
+        am->level[ch] = level;
+        am->gain[ch] = am->target[ch];
+    }
+}
+
+/**
+ * @brief Sums one channel into the mix on a gain ramp and measures its level.
+ *
+ * One pass per channel: the envelope accumulates in the same loop that
+ * scales and sums the samples.
+ */
+static __audio_hot void automix_sum(struct audio_mixer_automix *am, size_t ch,
+                                    int16_t *mix, const int16_t *in, size_t len)
+{
+    if (len == 0) {
+        return;
+    }
+
+    int32_t g = am->gain[ch];
+    const int32_t step = (am->target[ch] - g) / (int32_t)len;
+    int64_t energy = 0;
+    size_t i = 0;
+
+#if defined(__ARM_FEATURE_SIMD32)
+    // Two samples per step: dual 16-bit MAC for the level, saturating
+    // dual add into the mix, one gain per pair
+    for (; i + 1 < len; i += 2) {
+        int16x2_t x, m;
+        memcpy(&x, &in[i], sizeof(x));
+        memcpy(&m, &mix[i], sizeof(m));
+
+        energy = __smlald(x, x, energy);
+
+        int32_t g15 = g >> 15;
+        int32_t lo = ((int32_t)(int16_t)x * g15) >> 15;
+        int32_t hi = ((x >> 16) * g15) >> 15;
+
+        m = __qadd16(m, (int16x2_t)((uint16_t)lo | ((uint32_t)hi << 16)));
+        memcpy(&mix[i], &m, sizeof(m));
+        g += 2 * step;
+    }
+#endif
+
+    for (; i < len; i++) {
+        int32_t x = in[i];
+        int32_t sum = (int32_t)mix[i] + ((x * (g >> 15)) >> 15);
+
+        energy += x * x;
+        // Simple clipping
+        if (sum > INT16_MAX) sum = INT16_MAX;
+        if (sum < INT16_MIN) sum = INT16_MIN;
+        mix[i] = (int16_t)sum;
+        g += step;
+    }
+
+    am->block_level[ch] = (uint32_t)(energy / (int64_t)len);
+}
+
+#endif /* CONFIG_AUDIO_MIXER_AUTOMIX */
+
+/**
+ * @brief Applies a sample rate to every strip of the mix graph.
+ *
+ * Must run between blocks (mixer thread or mixer not running).
+ */
+static void audio_mixer_apply_sample_rate(struct audio_mixer *mixer, uint32_t sample_rate)
+{
+    mixer->sample_rate = sample_rate;
+
+    for (size_t ch = 0; ch < mixer->channel_count; ch++) {
+        channel_strip_apply_sample_rate(mixer->channels[ch], sample_rate);
+    }
+
+    if (mixer->master) {
+        channel_strip_apply_sample_rate(mixer->master, sample_rate);
+    }
+
+#if defined(CONFIG_AUDIO_MIXER_AUTOMIX)
+    if (mixer->automix.enabled) {
+        automix_update_timing(mixer);
+    }
+#endif
+}
+
+int audio_mixer_set_sample_rate(struct audio_mixer *mixer, uint32_t sample_rate)
+{
+    if (sample_rate == 0) {
+        return -EINVAL;
+    }
+
+    if (mixer->thread_id) {
+        if (!atomic_cas(&mixer->pending_rate, 0, (atomic_val_t)sample_rate)) {
+            return -EBUSY;
+        }
+        audio_mixer_wake(mixer);
+    } else {
+        audio_mixer_apply_sample_rate(mixer, sample_rate);
+    }
+
+    return 0;
+}
+
+__audio_hot struct audio_block* audio_mixer_process_block(struct audio_mixer *mixer,
+                                                           struct audio_block *block)
 {
     if (!block || mixer->channel_count == 0) {
         return block;
     }
 
+    // One allocation budget per mixer block, shared by all channels
+    k_timepoint_t alloc_end = sys_timepoint_calc(MIXER_ALLOC_TIMEOUT);
+
     // Allocate a mix buffer for summing
-    struct audio_block *mix_block = audio_block_alloc();
+    struct audio_block *mix_block = audio_block_alloc_timeout(sys_timepoint_timeout(alloc_end));
     if (!mix_block) {
         audio_block_release(block);
         return NULL;
     }
 
-    // Zero the mix buffer
-    for (size_t i = 0; i < mix_block->data_len; i++) {
-        mix_block->data[i] = 0;
+    // Zero the mix buffer (aligned payload, whole vectors)
+    int16_t *mix = AUDIO_BLOCK_ASSUME_ALIGNED(mix_block->data);
+    size_t mix_len = AUDIO_BLOCK_PADDED_LEN(mix_block->data_len);
+    for (size_t i = 0; i < mix_len; i++) {
+        mix[i] = 0;
+    }
+
+#if defined(CONFIG_AUDIO_MIXER_AUTOMIX)
+    const bool automix = mixer->automix.enabled;
+    if (automix) {
+        automix_targets(&mixer->automix, mixer->channel_count);
     }
+#endif
 
     // Process each channel and sum results
     for (size_t ch = 0; ch < mixer->channel_count; ch++) {
         // Create a copy for this channel (each channel needs its own block)
-        struct audio_block *ch_block = audio_block_alloc();
+        struct audio_block *ch_block = audio_block_alloc_timeout(sys_timepoint_timeout(alloc_end));
         if (!ch_block) {
-            continue;  // Skip this channel on allocation failure
+            continue;  // Skip this channel, counted in audio_block_wait_stats_get()
         }
 
-        // Copy input data
-        for (size_t i = 0; i < block->data_len; i++) {
-            ch_block->data[i] = block->data[i];
-        }
-        ch_block->data_len = block->data_len;
+        // Copy input data and metadata
+        audio_block_copy(ch_block, block);
 
         // Process through channel strip
         ch_block = channel_strip_process_block(mixer->channels[ch], ch_block);
 
         // Sum into mix buffer
         if (ch_block) {
-            for (size_t i = 0; i < ch_block->data_len && i < mix_block->data_len; i++) {
-                int32_t sum = (int32_t)mix_block->data[i] + (int32_t)ch_block->data[i];
+#if defined(CONFIG_AUDIO_MIXER_AUTOMIX)
+            if (automix) {
+                automix_sum(&mixer->automix, ch, mix, ch_block->data,
+                            MIN(ch_block->data_len, mix_block->data_len));
+                audio_block_release(ch_block);
+                continue;
+            }
+#endif
+            // Valid samples only: channel nodes may leave anything in the padding
+            const int16_t *ch = AUDIO_BLOCK_ASSUME_ALIGNED(ch_block->data);
+            size_t sum_len = MIN(ch_block->data_len, mix_block->data_len);
+            for (size_t i = 0; i < sum_len; i++) {
+                int32_t sum = (int32_t)mix[i] + (int32_t)ch[i];
                 // Simple clipping
                 if (sum > INT16_MAX) sum = INT16_MAX;
                 if (sum < INT16_MIN) sum = INT16_MIN;
-                mix_block->data[i] = (int16_t)sum;
+                mix[i] = (int16_t)sum;
             }
             audio_block_release(ch_block);
         }
     }
 
+#if defined(CONFIG_AUDIO_MIXER_AUTOMIX)
+    if (automix) {
+        automix_levels(&mixer->automix, mixer->channel_count);
+    }
+#endif
+
     // Release original input block
     audio_block_release(block);
 
@@ -227,11 +1273,78 @@ static void audio_mixer_thread_entry(void *p1, void *p2, void *p3)
 
     while (1) {
         // Block waiting for input
-        struct audio_block *block = k_fifo_get(&mixer->in_fifo, K_FOREVER);
+        void *item = k_fifo_get(&mixer->in_fifo, K_FOREVER);
+        bool control_only = (item == &mixer->cmd_wake);
+        struct audio_block *block = control_only ? NULL : item;
+
+        if (control_only) {
+            atomic_clear(&mixer->cmd_wake_pending);
+        }
+
+#if defined(CONFIG_AUDIO_IDLE)
+        if (!control_only) {
+            audio_idle_residency_leave(&mixer->idle);
+        }
+        bool goes_idle = block && (block->flags & AUDIO_BLOCK_FLAG_IDLE) != 0;
+#endif
+
+        // Rate changes take effect on a block boundary, for all channels at once
+        uint32_t rate = (uint32_t)atomic_clear(&mixer->pending_rate);
+        if (rate) {
+            audio_mixer_apply_sample_rate(mixer, rate);
+        }
+
+        // Control commands of all strips driven by this thread
+        for (size_t ch = 0; ch < mixer->channel_count; ch++) {
+            channel_strip_apply_commands(mixer->channels[ch]);
+        }
+        if (mixer->master) {
+            channel_strip_apply_commands(mixer->master);
+        }
+
+        // A mixer preset changes every strip at this one boundary
+        struct audio_preset *preset = atomic_ptr_clear(&mixer->pending_preset);
+        if (preset) {
+            for (size_t ch = 0; ch < mixer->channel_count; ch++) {
+                audio_preset_apply_to_strip(mixer->channels[ch], preset, (uint8_t)ch);
+            }
+            if (mixer->master) {
+                audio_preset_apply_to_strip(mixer->master, preset, AUDIO_PRESET_MASTER);
+            }
+            atomic_dec(&preset->pending);
+        }
+
+        // Woken for control alone: nothing to process until the next block
+        if (control_only) {
+            continue;
+        }
+
+#if defined(CONFIG_AUDIO_MODULATION)
+        // One tick for all strips, so shared sources advance once per block
+        if (++mixer->mod_tick == 0) {
+            mixer->mod_tick = 1;
+        }
+        for (size_t ch = 0; ch < mixer->channel_count; ch++) {
+            channel_strip_apply_modulation(mixer->channels[ch], block->data_len,
+                                           mixer->mod_tick);
+        }
+        if (mixer->master) {
+            channel_strip_apply_modulation(mixer->master, block->data_len, mixer->mod_tick);
+        }
+#endif
 
         // Process through all channels in lockstep
         block = audio_mixer_process_block(mixer, block);
 
+#if defined(CONFIG_AUDIO_IDLE)
+        if (goes_idle) {
+            if (block) {
+                block->flags |= AUDIO_BLOCK_FLAG_IDLE;
+            }
+            audio_idle_residency_enter(&mixer->idle);
+        }
+#endif
+
         // Push to output or release
         if (block) {
             if (mixer->out_fifo) {
@@ -243,6 +1356,13 @@ static void audio_mixer_thread_entry(void *p1, void *p2, void *p3)
     }
 }
 
+#if defined(CONFIG_AUDIO_IDLE)
+void audio_mixer_get_idle_stats(struct audio_mixer *mixer, struct audio_idle_stats *stats)
+{
+    audio_idle_residency_get(&mixer->idle, stats);
+}
+#endif
+
 void audio_mixer_start(struct audio_mixer *mixer,
                        k_thread_stack_t *stack,
                        size_t stack_size,
@@ -255,7 +1375,17 @@ void audio_mixer_start(struct audio_mixer *mixer,
                                        mixer, NULL, NULL,
                                        priority,
                                        0,
-                                       K_NO_WAIT);
+                                       K_FOREVER);
+
+#if defined(CONFIG_AUDIO_SMP_AFFINITY)
+    if (apply_cpu_mask(mixer->thread_id, mixer->cpu_mask) != 0) {
+        LOG_WRN("Mixer: CPU mask 0x%x not applied", mixer->cpu_mask);
+    }
+#endif
 
     k_thread_name_set(mixer->thread_id, "audio_mixer");
+
+    audio_stack_track(mixer->thread_id, "audio_mixer", stack_size);
+
+    k_thread_start(mixer->thread_id);
 }
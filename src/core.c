@@ -1,14 +1,323 @@
 #include "audio_fw.h"
+#include "audio_stack.h"
 #include <zephyr/logging/log.h>
 #include <string.h>
 #include <errno.h>
 
 LOG_MODULE_REGISTER(audio_core, LOG_LEVEL_INF);
 
-K_MEM_SLAB_DEFINE(audio_data_slab, AUDIO_BLOCK_SIZE_BYTES, CONFIG_AUDIO_MEM_SLAB_COUNT, 4);
-K_MEM_SLAB_DEFINE(audio_block_slab, sizeof(struct audio_block), CONFIG_AUDIO_MEM_SLAB_COUNT, 4);
+/* Payloads and headers are padded to AUDIO_BLOCK_ALIGN so no two blocks share a cache line */
+#define AUDIO_HEADER_STRIDE_BYTES ROUND_UP(sizeof(struct audio_block), AUDIO_BLOCK_ALIGN)
 
-struct audio_block *audio_block_alloc(void) {
+K_MEM_SLAB_DEFINE_IN_SECT(audio_data_slab, __audio_pool, AUDIO_BLOCK_STRIDE_BYTES,
+                          CONFIG_AUDIO_MEM_SLAB_COUNT, AUDIO_BLOCK_ALIGN);
+K_MEM_SLAB_DEFINE_IN_SECT(audio_block_slab, __audio_pool, AUDIO_HEADER_STRIDE_BYTES,
+                          CONFIG_AUDIO_MEM_SLAB_COUNT, AUDIO_BLOCK_ALIGN);
+
+#if defined(CONFIG_AUDIO_BLOCK_TRACKING)
+
+/* Owner record per header slot, indexed like audio_block_slab */
+struct block_track {
+    const char *owner;
+    int16_t node;
+    bool live;
+    int64_t since;      /* Uptime at which the current owner took the block */
+    int64_t allocated;  /* Uptime at allocation */
+};
+
+static struct block_track block_tracks[CONFIG_AUDIO_MEM_SLAB_COUNT];
+static struct k_spinlock track_lock;
+
+static struct block_track *track_of(const struct audio_block *block) {
+    size_t index = ((const char *)block - audio_block_slab.buffer) / AUDIO_HEADER_STRIDE_BYTES;
+
+    return (index < ARRAY_SIZE(block_tracks)) ? &block_tracks[index] : NULL;
+}
+
+static void track_alloc(const struct audio_block *block) {
+    struct block_track *t = track_of(block);
+    const char *owner = NULL;
+
+#if defined(CONFIG_THREAD_NAME)
+    if (!k_is_in_isr()) {
+        owner = k_thread_name_get(k_current_get());
+    }
+#endif
+
+    if (t) {
+        k_spinlock_key_t key = k_spin_lock(&track_lock);
+        t->owner = owner ? owner : "?";
+        t->node = AUDIO_BLOCK_OWNER_NO_NODE;
+        t->live = true;
+        t->allocated = k_uptime_get();
+        t->since = t->allocated;
+        k_spin_unlock(&track_lock, key);
+    }
+}
+
+static void track_free(const struct audio_block *block) {
+    struct block_track *t = track_of(block);
+
+    if (t) {
+        t->live = false;
+    }
+}
+
+void audio_block_set_owner(const struct audio_block *block, const char *owner, int node) {
+    struct block_track *t = block ? track_of(block) : NULL;
+
+    if (!t) {
+        return;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&track_lock);
+    if (t->owner != owner || t->node != node) {
+        t->owner = owner ? owner : "?";
+        t->node = (int16_t)node;
+        t->since = k_uptime_get();
+    }
+    k_spin_unlock(&track_lock, key);
+}
+
+size_t audio_block_outstanding(void) {
+    return k_mem_slab_num_used_get(&audio_block_slab);
+}
+
+size_t audio_block_dump_stale(uint32_t periods, uint32_t sample_rate) {
+    if (sample_rate == 0) {
+        sample_rate = CONFIG_AUDIO_SAMPLE_RATE;
+    }
+
+    int64_t limit_ms = ((int64_t)periods * CONFIG_AUDIO_BLOCK_SAMPLES * 1000) / sample_rate;
+    int64_t now = k_uptime_get();
+    size_t listed = 0;
+
+    for (size_t i = 0; i < ARRAY_SIZE(block_tracks); i++) {
+        k_spinlock_key_t key = k_spin_lock(&track_lock);
+        struct block_track t = block_tracks[i];
+        k_spin_unlock(&track_lock, key);
+
+        if (!t.live || (now - t.since) < limit_ms) {
+            continue;
+        }
+
+        const struct audio_block *block = (const struct audio_block *)
+            (audio_block_slab.buffer + i * AUDIO_HEADER_STRIDE_BYTES);
+
+        LOG_WRN("Block %p held by %s node %d for %lld ms (allocated %lld ms ago, refs %ld)",
+                block, t.owner, t.node, (long long)(now - t.since),
+                (long long)(now - t.allocated),
+                atomic_get(&block->ref_count));
+        listed++;
+    }
+
+    if (listed) {
+        LOG_WRN("%zu of %zu outstanding blocks older than %u periods at %u Hz",
+                listed, audio_block_outstanding(), periods, sample_rate);
+    }
+
+    return listed;
+}
+
+#else
+#define track_alloc(block)
+#define track_free(block)
+#endif /* CONFIG_AUDIO_BLOCK_TRACKING */
+
+#if defined(CONFIG_AUDIO_POOL_RESERVATIONS)
+
+struct pool_class {
+    size_t reserved;    /* Guaranteed blocks */
+    size_t used;
+    size_t peak;
+    uint32_t denials;
+};
+
+struct pool_binding {
+    k_tid_t tid;
+    uint8_t cls;
+};
+
+static struct pool_class pool_classes[CONFIG_AUDIO_POOL_CLASSES];
+static struct pool_binding pool_bindings[CONFIG_AUDIO_POOL_MAX_BINDINGS];
+static size_t pool_reserved_total;
+static size_t pool_overflow_used;   /* Blocks in use beyond their class reservation */
+static struct k_spinlock pool_lock;
+
+int audio_pool_reserve(uint8_t cls, size_t min_blocks) {
+    if (cls >= CONFIG_AUDIO_POOL_CLASSES) {
+        return -EINVAL;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&pool_lock);
+    struct pool_class *c = &pool_classes[cls];
+    int ret = 0;
+
+    size_t total = pool_reserved_total - c->reserved + min_blocks;
+
+    if (c->used != 0) {
+        ret = -EBUSY;
+    } else if (total > CONFIG_AUDIO_MEM_SLAB_COUNT ||
+               pool_overflow_used > CONFIG_AUDIO_MEM_SLAB_COUNT - total) {
+        // Overflow blocks in use cannot be turned into reserved ones
+        ret = -ENOMEM;
+    } else {
+        pool_reserved_total = total;
+        c->reserved = min_blocks;
+    }
+
+    k_spin_unlock(&pool_lock, key);
+    return ret;
+}
+
+int audio_pool_bind_thread(k_tid_t tid, uint8_t cls) {
+    struct pool_binding *free_slot = NULL;
+    int ret = -ENOMEM;
+
+    if (cls >= CONFIG_AUDIO_POOL_CLASSES) {
+        return -EINVAL;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&pool_lock);
+
+    for (size_t i = 0; i < ARRAY_SIZE(pool_bindings); i++) {
+        if (pool_bindings[i].tid == tid) {
+            free_slot = &pool_bindings[i];
+            break;
+        }
+        if (!pool_bindings[i].tid && !free_slot) {
+            free_slot = &pool_bindings[i];
+        }
+    }
+
+    if (free_slot) {
+        free_slot->tid = tid;
+        free_slot->cls = cls;
+        ret = 0;
+    }
+
+    k_spin_unlock(&pool_lock, key);
+    return ret;
+}
+
+void audio_pool_unbind_thread(k_tid_t tid) {
+    k_spinlock_key_t key = k_spin_lock(&pool_lock);
+
+    for (size_t i = 0; i < ARRAY_SIZE(pool_bindings); i++) {
+        if (pool_bindings[i].tid == tid) {
+            pool_bindings[i].tid = NULL;
+        }
+    }
+
+    k_spin_unlock(&pool_lock, key);
+}
+
+int audio_pool_stats_get(uint8_t cls, struct audio_pool_stats *stats) {
+    if (cls >= CONFIG_AUDIO_POOL_CLASSES || !stats) {
+        return -EINVAL;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&pool_lock);
+    struct pool_class *c = &pool_classes[cls];
+
+    stats->reserved = c->reserved;
+    stats->used = c->used;
+    stats->peak = c->peak;
+    stats->denials = c->denials;
+    stats->shared_free = CONFIG_AUDIO_MEM_SLAB_COUNT - pool_reserved_total - pool_overflow_used;
+
+    k_spin_unlock(&pool_lock, key);
+    return 0;
+}
+
+void audio_pool_stats_report(void) {
+    struct audio_pool_stats stats;
+
+    for (uint8_t cls = 0; cls < CONFIG_AUDIO_POOL_CLASSES; cls++) {
+        audio_pool_stats_get(cls, &stats);
+        LOG_INF("Pool class %u: reserved %zu used %zu peak %zu denials %u",
+                cls, stats.reserved, stats.used, stats.peak, stats.denials);
+    }
+    LOG_INF("Pool shared overflow free: %zu", stats.shared_free);
+}
+
+/* Class of the calling thread, 0 for unbound threads and ISRs */
+static uint8_t pool_class_of_current(void) {
+    uint8_t cls = 0;
+
+    if (k_is_in_isr()) {
+        return 0;
+    }
+
+    k_tid_t self = k_current_get();
+    k_spinlock_key_t key = k_spin_lock(&pool_lock);
+
+    for (size_t i = 0; i < ARRAY_SIZE(pool_bindings); i++) {
+        if (pool_bindings[i].tid == self) {
+            cls = pool_bindings[i].cls;
+            break;
+        }
+    }
+
+    k_spin_unlock(&pool_lock, key);
+    return cls;
+}
+
+/* Charges one block to a class: own reservation first, then the shared overflow */
+static bool pool_admit(uint8_t cls) {
+    k_spinlock_key_t key = k_spin_lock(&pool_lock);
+    struct pool_class *c = &pool_classes[cls];
+    bool ok = true;
+
+    if (c->used >= c->reserved) {
+        if (pool_overflow_used + pool_reserved_total < CONFIG_AUDIO_MEM_SLAB_COUNT) {
+            pool_overflow_used++;
+        } else {
+            c->denials++;
+            ok = false;
+        }
+    }
+
+    if (ok) {
+        c->used++;
+        c->peak = MAX(c->peak, c->used);
+    }
+
+    k_spin_unlock(&pool_lock, key);
+    return ok;
+}
+
+static void pool_uncharge(uint8_t cls) {
+    k_spinlock_key_t key = k_spin_lock(&pool_lock);
+    struct pool_class *c = &pool_classes[cls];
+
+    if (c->used > c->reserved) {
+        pool_overflow_used--;
+    }
+    c->used--;
+
+    k_spin_unlock(&pool_lock, key);
+}
+
+#endif /* CONFIG_AUDIO_POOL_RESERVATIONS */
+
+/* Wakes blocked allocators on release; count only matters while someone waits */
+K_SEM_DEFINE(pool_avail, 0, K_SEM_MAX_LIMIT);
+static atomic_t pool_waiters;
+
+static struct audio_alloc_wait_stats wait_stats;
+static struct k_spinlock wait_lock;
+
+/* Clock for wait times, 64 bits so that K_FOREVER waits never wrap */
+static uint64_t wait_clock_us(void) {
+#if defined(CONFIG_TIMER_HAS_64BIT_CYCLE_COUNTER)
+    return k_cyc_to_us_floor64(k_cycle_get_64());
+#else
+    return k_ticks_to_us_floor64(k_uptime_ticks());
+#endif
+}
+
+static __audio_hot struct audio_block *block_alloc_slabs(void) {
     struct audio_block *block;
 
     if (k_mem_slab_alloc(&audio_block_slab, (void **)&block, K_NO_WAIT) != 0) {
@@ -16,9 +325,15 @@ struct audio_block *audio_block_alloc(void) {
     }
 
     if (k_mem_slab_alloc(&audio_data_slab, (void **)&block->data, K_NO_WAIT) == 0) {
-        memset(block->data, 0, AUDIO_BLOCK_SIZE_BYTES);
+        /* Clear the padding too, padded kernels may read it */
+        memset(AUDIO_BLOCK_ASSUME_ALIGNED(block->data), 0, AUDIO_BLOCK_STRIDE_BYTES);
         block->data_len = CONFIG_AUDIO_BLOCK_SAMPLES;
+        block->flags = 0;
         atomic_set(&block->ref_count, 1);
+#if defined(CONFIG_AUDIO_COW_ELISION)
+        atomic_set(&block->readers, 0);
+#endif
+        track_alloc(block);
         return block;
     }
     
@@ -26,7 +341,72 @@ struct audio_block *audio_block_alloc(void) {
     return NULL;
 }
 
-void audio_block_release(struct audio_block *block) {
+#if defined(CONFIG_AUDIO_POOL_RESERVATIONS)
+struct audio_block *audio_block_alloc_class(uint8_t cls) {
+    if (cls >= CONFIG_AUDIO_POOL_CLASSES || !pool_admit(cls)) {
+        return NULL;
+    }
+
+    struct audio_block *block = block_alloc_slabs();
+    if (!block) {
+        pool_uncharge(cls);
+        return NULL;
+    }
+
+    block->pool_class = cls;
+    return block;
+}
+#endif
+
+__audio_hot struct audio_block *audio_block_alloc(void) {
+#if defined(CONFIG_AUDIO_POOL_RESERVATIONS)
+    return audio_block_alloc_class(pool_class_of_current());
+#else
+    return block_alloc_slabs();
+#endif
+}
+
+struct audio_block *audio_block_alloc_timeout(k_timeout_t timeout) {
+    struct audio_block *block = audio_block_alloc();
+
+    if (block || K_TIMEOUT_EQ(timeout, K_NO_WAIT) || k_is_in_isr()) {
+        return block;
+    }
+
+    k_timepoint_t end = sys_timepoint_calc(timeout);
+    uint64_t start = wait_clock_us();
+
+    while (!block) {
+        /* Register before retrying so a release in between is not missed */
+        atomic_inc(&pool_waiters);
+        block = audio_block_alloc();
+        if (!block && k_sem_take(&pool_avail, sys_timepoint_timeout(end)) != 0) {
+            atomic_dec(&pool_waiters);
+            break;
+        }
+        atomic_dec(&pool_waiters);
+    }
+
+    uint64_t waited_us = wait_clock_us() - start;
+    k_spinlock_key_t key = k_spin_lock(&wait_lock);
+    wait_stats.waits++;
+    wait_stats.total_wait_us += waited_us;
+    wait_stats.max_wait_us = MAX(wait_stats.max_wait_us, (uint32_t)MIN(waited_us, UINT32_MAX));
+    if (!block) {
+        wait_stats.timeouts++;
+    }
+    k_spin_unlock(&wait_lock, key);
+
+    return block;
+}
+
+void audio_block_wait_stats_get(struct audio_alloc_wait_stats *stats) {
+    k_spinlock_key_t key = k_spin_lock(&wait_lock);
+    *stats = wait_stats;
+    k_spin_unlock(&wait_lock, key);
+}
+
+__audio_hot void audio_block_release(struct audio_block *block) {
     if (!block) return;
 
     atomic_val_t old_count = atomic_dec(&block->ref_count);
@@ -37,14 +417,93 @@ void audio_block_release(struct audio_block *block) {
             k_mem_slab_free(&audio_data_slab, (void *)block->data);
             block->data = NULL;
         }
+        track_free(block);
+#if defined(CONFIG_AUDIO_POOL_RESERVATIONS)
+        pool_uncharge(block->pool_class);
+#endif
         k_mem_slab_free(&audio_block_slab, (void *)block); 
+
+#if defined(CONFIG_AUDIO_POOL_RESERVATIONS)
+        /*
+         * Wake every waiter: the highest-priority one may belong to a class
+         * that is still over its reservation, while a lower one could now
+         * be admitted. Those denied go back to sleep.
+         */
+        for (atomic_val_t n = atomic_get(&pool_waiters); n > 0; n--) {
+            k_sem_give(&pool_avail);
+        }
+#else
+        /* The wait queue hands this to the highest-priority waiter */
+        if (atomic_get(&pool_waiters) > 0) {
+            k_sem_give(&pool_avail);
+        }
+#endif
     }
 }
 
-int audio_block_get_writable(struct audio_block **block_ptr) {
+static atomic_t cow_copies;
+static atomic_t cow_avoided;
+
+#if defined(CONFIG_AUDIO_COW_ELISION)
+/*
+ * All other references belong to declared readers: give them a chance to
+ * finish (they run at our priority or on another CPU) instead of copying.
+ */
+static bool cow_wait_for_readers(struct audio_block *block) {
+    if (k_is_in_isr()) {
+        return false;
+    }
+
+    for (int i = 0; i < CONFIG_AUDIO_COW_ELISION_YIELDS; i++) {
+        atomic_val_t refs = atomic_get(&block->ref_count);
+
+        if (refs == 1) {
+            return true;
+        }
+        /* Someone else may still write, the copy is unavoidable */
+        if (refs - 1 > atomic_get(&block->readers)) {
+            return false;
+        }
+        k_yield();
+    }
+
+    return atomic_get(&block->ref_count) == 1;
+}
+
+void audio_block_begin_read(struct audio_block *block) {
+    atomic_inc(&block->readers);
+}
+
+void audio_block_end_read(struct audio_block *block) {
+    atomic_dec(&block->readers);
+}
+
+void audio_block_release_read(struct audio_block *block) {
+    if (!block) return;
+
+    /* Drop the declaration first, the release may free the block */
+    atomic_dec(&block->readers);
+    audio_block_release(block);
+}
+#endif /* CONFIG_AUDIO_COW_ELISION */
+
+void audio_cow_stats_get(struct audio_cow_stats *stats) {
+    stats->copies = (uint32_t)atomic_get(&cow_copies);
+    stats->avoided = (uint32_t)atomic_get(&cow_avoided);
+}
+
+__audio_hot int audio_block_get_writable(struct audio_block **block_ptr) {
     struct audio_block *block = *block_ptr;
     if (!block) return -EINVAL;
 
+#if defined(CONFIG_AUDIO_COW_ELISION)
+    if (atomic_get(&block->ref_count) > 1 && cow_wait_for_readers(block)) {
+        atomic_inc(&cow_avoided);
+        LOG_DBG("CoW elided: %p", block);
+        return 0;
+    }
+#endif
+
     if (atomic_get(&block->ref_count) > 1) {
         struct audio_block *new_block = audio_block_alloc();
         if (!new_block) {
@@ -53,9 +512,9 @@ int audio_block_get_writable(struct audio_block **block_ptr) {
         }
 
         LOG_DBG("CoW executed: %p -> %p", block, new_block);
+        atomic_inc(&cow_copies);
 
-        memcpy(new_block->data, block->data, AUDIO_BLOCK_SIZE_BYTES);
-        new_block->data_len = block->data_len;
+        audio_block_copy(new_block, block);
 
         audio_block_release(block);
         *block_ptr = new_block;
@@ -73,13 +532,42 @@ static void node_thread_entry(void *p1, void *p2, void *p3) {
 }
 
 void audio_node_start(struct audio_node *node, k_thread_stack_t *stack) {
+    audio_node_start_named(node, stack, CONFIG_AUDIO_THREAD_STACK_SIZE, NULL);
+}
+
+void audio_node_start_named(struct audio_node *node, k_thread_stack_t *stack,
+                            size_t stack_size, const char *name) {
     node->thread_id = k_thread_create(&node->thread_data, stack, 
-                    CONFIG_AUDIO_THREAD_STACK_SIZE,
+                    stack_size,
                     node_thread_entry, node, NULL, NULL,
                     CONFIG_AUDIO_THREAD_PRIORITY, 0, K_NO_WAIT);
+
+    if (name) {
+        k_thread_name_set(node->thread_id, name);
+    }
+    audio_stack_track(node->thread_id, name, stack_size);
+}
+
+#if defined(CONFIG_AUDIO_STACK_PROFILE)
+int audio_node_start_profiled(struct audio_node *node, const char *name) {
+    size_t stack_size = audio_stack_profile_lookup(name, CONFIG_AUDIO_THREAD_STACK_SIZE);
+
+    k_thread_stack_t *stack = k_thread_stack_alloc(stack_size, 0);
+    if (!stack) {
+        LOG_ERR("No stack for node '%s' (%zu bytes)", name, stack_size);
+        return -ENOMEM;
+    }
+
+    audio_node_start_named(node, stack, stack_size, name);
+    return 0;
 }
+#endif
 
 void audio_node_push_output(struct audio_node *self, struct audio_block *block) {
+#if defined(CONFIG_AUDIO_BLOCK_TRACKING) && defined(CONFIG_THREAD_NAME)
+    /* Consumer unknown here, attribute the block to the queue's producer */
+    audio_block_set_owner(block, k_thread_name_get(k_current_get()), AUDIO_BLOCK_OWNER_NO_NODE);
+#endif
     if (self->out_fifo) {
         k_fifo_put(self->out_fifo, block);
     } else {
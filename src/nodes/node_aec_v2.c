@@ -0,0 +1,439 @@
+/**
+ * @file node_aec_v2.c
+ * @brief Acoustic echo canceller - Sequential Processing Version
+ *
+ * Partitioned block frequency-domain adaptive filter (overlap-save,
+ * partition length B = CONFIG_AUDIO_AEC_PARTITION_SAMPLES, FFT size 2B).
+ * The echo path of B * CONFIG_AUDIO_AEC_PARTITIONS taps is modelled as
+ * that many B-tap partitions, each filtered with one complex multiply
+ * per bin against the matching past reference spectrum. The update is
+ * normalized per bin by the smoothed reference power; the gradient
+ * constraint (zeroing the circular half) is applied to one partition per
+ * step, round-robin, which keeps two extra FFTs per step instead of 2 * P.
+ *
+ * A Geigel detector freezes adaptation while the near end talks: when the
+ * mic peak exceeds threshold times the reference peak over the echo tail,
+ * adaptation stops for hold_partitions steps.
+ *
+ * The reference (speaker feed) enters through a tap node in the speaker
+ * strip or node_aec_push_reference(), into a single-producer ring.
+ */
+
+#include "audio_fw_v2.h"
+#include "audio_fft.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define AEC_B       CONFIG_AUDIO_AEC_PARTITION_SAMPLES
+#define AEC_N       (2 * AEC_B)
+#define AEC_P       CONFIG_AUDIO_AEC_PARTITIONS
+#define AEC_RING    CONFIG_AUDIO_AEC_REF_BUFFER_SAMPLES
+
+BUILD_ASSERT(IS_POWER_OF_TWO(AEC_B) && AEC_N <= CONFIG_AUDIO_FFT_MAX_SIZE,
+             "AEC partition must be a power of two, 2 * partition <= AUDIO_FFT_MAX_SIZE");
+BUILD_ASSERT(IS_POWER_OF_TWO(AEC_RING), "AEC reference buffer must be a power of two");
+
+/* Reference power smoothing and regularization (relative to full scale) */
+#define AEC_POWER_ALPHA     0.9f
+#define AEC_POWER_FLOOR     1e-3f
+#define AEC_ERLE_ALPHA      0.99f
+
+/**
+ * @brief Private context for the echo canceller
+ */
+struct aec_ctx {
+    struct aec_config config;
+    const struct audio_fft *fft;
+
+    // Adaptive filter
+    float x_spec[AEC_P][AEC_N];     /**< Past reference spectra, x_spec[head] newest */
+    float w_spec[AEC_P][AEC_N];     /**< Filter partitions */
+    float x_power[AEC_B + 1];       /**< Smoothed |X|^2 per bin */
+    float x_prev[AEC_B];            /**< Previous reference partition (overlap) */
+    size_t head;
+    size_t constrain_next;
+
+    // Working buffers
+    float time[AEC_N];
+    float spec[AEC_N];
+
+    // Geigel double-talk detector
+    int16_t ref_peak[AEC_P];        /**< Reference peak per partition, ring with head */
+    uint32_t hold_left;
+
+    // Echo return loss enhancement estimate
+    float mic_energy;
+    float err_energy;
+
+    struct aec_stats stats;
+
+    // Reference ring (single producer: tap/push, single consumer: process)
+    int16_t ref[AEC_RING];
+    atomic_t ref_wr;
+    atomic_t ref_rd;
+};
+
+/* Packed spectra: [0] DC and [1] Nyquist are real, then (re, im) pairs */
+static inline void spec_mac(float *acc, const float *a, const float *b)
+{
+    acc[0] += a[0] * b[0];
+    acc[1] += a[1] * b[1];
+    for (size_t k = 2; k < AEC_N; k += 2) {
+        acc[k] += a[k] * b[k] - a[k + 1] * b[k + 1];
+        acc[k + 1] += a[k] * b[k + 1] + a[k + 1] * b[k];
+    }
+}
+
+/* acc += conj(a) * b */
+static inline void spec_mac_conj(float *acc, const float *a, const float *b)
+{
+    acc[0] += a[0] * b[0];
+    acc[1] += a[1] * b[1];
+    for (size_t k = 2; k < AEC_N; k += 2) {
+        acc[k] += a[k] * b[k] + a[k + 1] * b[k + 1];
+        acc[k + 1] += a[k] * b[k + 1] - a[k + 1] * b[k];
+    }
+}
+
+static size_t ref_read(struct aec_ctx *ctx, float *out, size_t n)
+{
+    atomic_val_t wr = atomic_get(&ctx->ref_wr);
+    atomic_val_t rd = atomic_get(&ctx->ref_rd);
+    size_t avail = MIN((size_t)(wr - rd), n);
+
+    for (size_t i = 0; i < avail; i++) {
+        out[i] = (float)ctx->ref[(rd + i) & (AEC_RING - 1)] / 32768.0f;
+    }
+    for (size_t i = avail; i < n; i++) {
+        out[i] = 0.0f;
+    }
+
+    atomic_set(&ctx->ref_rd, rd + avail);
+    return avail;
+}
+
+static void ref_write(struct aec_ctx *ctx, const int16_t *samples, size_t n)
+{
+    atomic_val_t wr = atomic_get(&ctx->ref_wr);
+    atomic_val_t rd = atomic_get(&ctx->ref_rd);
+    size_t space = AEC_RING - (size_t)(wr - rd);
+
+    if (n > space) {
+        ctx->stats.ref_overruns++;
+        n = space;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        ctx->ref[(wr + i) & (AEC_RING - 1)] = samples[i];
+    }
+
+    atomic_set(&ctx->ref_wr, wr + n);
+}
+
+static bool double_talk(struct aec_ctx *ctx, const int16_t *mic)
+{
+    int16_t ref_max = 0;
+    int16_t mic_max = 0;
+
+    for (size_t p = 0; p < AEC_P; p++) {
+        ref_max = MAX(ref_max, ctx->ref_peak[p]);
+    }
+    for (size_t i = 0; i < AEC_B; i++) {
+        mic_max = MAX(mic_max, (int16_t)MIN(abs(mic[i]), INT16_MAX));
+    }
+
+    if ((float)mic_max > ctx->config.dt_threshold * (float)ref_max) {
+        ctx->hold_left = ctx->config.dt_hold_partitions;
+    } else if (ctx->hold_left) {
+        ctx->hold_left--;
+    }
+
+    return ctx->hold_left != 0;
+}
+
+/* Runs one partition of B samples in place */
+static __audio_hot void aec_partition(struct aec_ctx *ctx, int16_t *mic)
+{
+    float *time = ctx->time;
+    float *spec = ctx->spec;
+
+    // New reference spectrum from [previous B, new B]
+    ctx->head = ctx->head ? ctx->head - 1 : AEC_P - 1;
+    memcpy(time, ctx->x_prev, sizeof(ctx->x_prev));
+    if (ref_read(ctx, &time[AEC_B], AEC_B) < AEC_B) {
+        ctx->stats.ref_underruns++;
+    }
+    memcpy(ctx->x_prev, &time[AEC_B], sizeof(ctx->x_prev));
+
+    int16_t peak = 0;
+    for (size_t i = 0; i < AEC_B; i++) {
+        peak = MAX(peak, (int16_t)MIN(fabsf(ctx->x_prev[i]) * 32768.0f, (float)INT16_MAX));
+    }
+    ctx->ref_peak[ctx->head] = peak;
+
+    float *x_new = ctx->x_spec[ctx->head];
+    audio_fft_forward(ctx->fft, time, x_new);
+
+    ctx->x_power[0] = AEC_POWER_ALPHA * ctx->x_power[0] + (1.0f - AEC_POWER_ALPHA) * x_new[0] * x_new[0];
+    ctx->x_power[AEC_B] = AEC_POWER_ALPHA * ctx->x_power[AEC_B] + (1.0f - AEC_POWER_ALPHA) * x_new[1] * x_new[1];
+    for (size_t k = 1; k < AEC_B; k++) {
+        float re = x_new[2 * k], im = x_new[2 * k + 1];
+        ctx->x_power[k] = AEC_POWER_ALPHA * ctx->x_power[k] + (1.0f - AEC_POWER_ALPHA) * (re * re + im * im);
+    }
+
+    // Echo estimate: sum over partitions, last B samples are linear convolution
+    memset(spec, 0, sizeof(ctx->spec));
+    for (size_t p = 0; p < AEC_P; p++) {
+        spec_mac(spec, ctx->w_spec[p], ctx->x_spec[(ctx->head + p) % AEC_P]);
+    }
+    audio_fft_inverse(ctx->fft, spec, time);
+
+    // Error = mic - echo, which is also the output
+    bool frozen = double_talk(ctx, mic);
+    float *err = &time[AEC_B];
+
+    for (size_t i = 0; i < AEC_B; i++) {
+        float d = (float)mic[i] / 32768.0f;
+        float e = d - err[i];
+
+        err[i] = e;
+        ctx->mic_energy = AEC_ERLE_ALPHA * ctx->mic_energy + (1.0f - AEC_ERLE_ALPHA) * d * d;
+        ctx->err_energy = AEC_ERLE_ALPHA * ctx->err_energy + (1.0f - AEC_ERLE_ALPHA) * e * e;
+        mic[i] = (int16_t)CLAMP(lrintf(e * 32768.0f), INT16_MIN, INT16_MAX);
+    }
+
+    if (frozen) {
+        ctx->stats.double_talk_partitions++;
+        return;
+    }
+
+    // Normalized gradient from E = FFT([0, e])
+    memset(time, 0, AEC_B * sizeof(float));
+    audio_fft_forward(ctx->fft, time, spec);
+
+    const float floor = AEC_POWER_FLOOR * (float)(AEC_N * AEC_N) / 4.0f;
+    // All partitions adapt on the same error: step_size 1.0 is near the stability edge
+    const float mu = ctx->config.step_size * 4.0f / (float)AEC_P;
+
+    spec[0] *= mu / (ctx->x_power[0] + floor);
+    spec[1] *= mu / (ctx->x_power[AEC_B] + floor);
+    for (size_t k = 1; k < AEC_B; k++) {
+        float g = mu / (ctx->x_power[k] + floor);
+        spec[2 * k] *= g;
+        spec[2 * k + 1] *= g;
+    }
+
+    for (size_t p = 0; p < AEC_P; p++) {
+        spec_mac_conj(ctx->w_spec[p], ctx->x_spec[(ctx->head + p) % AEC_P], spec);
+    }
+
+    // Constrain one partition to B causal taps (drops the circular part)
+    float *w = ctx->w_spec[ctx->constrain_next];
+    audio_fft_inverse(ctx->fft, w, time);
+    memset(&time[AEC_B], 0, AEC_B * sizeof(float));
+    audio_fft_forward(ctx->fft, time, w);
+    ctx->constrain_next = (ctx->constrain_next + 1) % AEC_P;
+}
+
+/**
+ * @brief Sequential processing function for the echo canceller (mic path)
+ */
+static struct audio_block* aec_process(struct audio_node *self, struct audio_block *in)
+{
+    if (!in) {
+        return NULL;
+    }
+
+    struct aec_ctx *ctx = (struct aec_ctx *)self->ctx;
+    size_t whole = in->data_len - (in->data_len % AEC_B);
+
+    for (size_t off = 0; off < whole; off += AEC_B) {
+        aec_partition(ctx, &in->data[off]);
+    }
+
+    if (whole < in->data_len) {
+        // Short block (init rejects full blocks that leave a tail): keep the
+        // reference aligned, leave the mic untouched
+        float discard[AEC_B];
+        ref_read(ctx, discard, in->data_len - whole);
+    }
+
+    if (ctx->err_energy > 0.0f && ctx->mic_energy > 0.0f) {
+        ctx->stats.erle_db = 10.0f * log10f(ctx->mic_energy / ctx->err_energy);
+    }
+
+    return in;
+}
+
+static void aec_reset(struct audio_node *self)
+{
+    struct aec_ctx *ctx = (struct aec_ctx *)self->ctx;
+
+    memset(ctx->x_spec, 0, sizeof(ctx->x_spec));
+    memset(ctx->w_spec, 0, sizeof(ctx->w_spec));
+    memset(ctx->x_power, 0, sizeof(ctx->x_power));
+    memset(ctx->x_prev, 0, sizeof(ctx->x_prev));
+    memset(ctx->ref_peak, 0, sizeof(ctx->ref_peak));
+    memset(&ctx->stats, 0, sizeof(ctx->stats));
+    ctx->head = 0;
+    ctx->constrain_next = 0;
+    ctx->hold_left = 0;
+    ctx->mic_energy = 0.0f;
+    ctx->err_energy = 0.0f;
+
+    // Drop stale reference so the echo path starts aligned
+    atomic_set(&ctx->ref_rd, atomic_get(&ctx->ref_wr));
+}
+
+/* Shared by set_param and init; written to reject NaN */
+static inline bool aec_step_valid(float step_size)
+{
+    return step_size >= 0.0f && step_size <= 1.0f;
+}
+
+static inline bool aec_dt_threshold_valid(float dt_threshold)
+{
+    return dt_threshold > 0.0f;
+}
+
+static int aec_set_param(struct audio_node *self, uint32_t id, float value, uint32_t ramp_samples)
+{
+    struct aec_ctx *ctx = (struct aec_ctx *)self->ctx;
+
+    switch (id) {
+    case NODE_AEC_PARAM_STEP:
+        if (!aec_step_valid(value)) {
+            return -EINVAL;
+        }
+        ctx->config.step_size = value;
+        return 0;
+
+    case NODE_AEC_PARAM_DT_THRESHOLD:
+        if (!aec_dt_threshold_valid(value)) {
+            return -EINVAL;
+        }
+        ctx->config.dt_threshold = value;
+        return 0;
+
+    default:
+        return -EINVAL;
+    }
+}
+
+static int aec_get_param(struct audio_node *self, uint32_t id, float *value)
+{
+    struct aec_ctx *ctx = (struct aec_ctx *)self->ctx;
+
+    switch (id) {
+    case NODE_AEC_PARAM_STEP:
+        *value = ctx->config.step_size;
+        return 0;
+
+    case NODE_AEC_PARAM_DT_THRESHOLD:
+        *value = ctx->config.dt_threshold;
+        return 0;
+
+    default:
+        return -EINVAL;
+    }
+}
+
+static const struct audio_node_api aec_api = {
+    .process = aec_process,
+    .reset = aec_reset,
+    .set_param = aec_set_param,
+    .get_param = aec_get_param,
+    .param_count = 2,
+};
+
+/**
+ * @brief Reference tap: copies the speaker feed into the canceller, passes it on
+ */
+static struct audio_block* aec_ref_process(struct audio_node *self, struct audio_block *in)
+{
+    if (in) {
+        ref_write((struct aec_ctx *)self->ctx, in->data, in->data_len);
+    }
+    return in;
+}
+
+static const struct audio_node_api aec_ref_api = {
+    .process = aec_ref_process,
+};
+
+static struct aec_ctx __audio_node_state aec_contexts[CONFIG_AUDIO_AEC_MAX_NODES];
+static size_t aec_ctx_index = 0;
+
+int node_aec_init(struct audio_node *node, const struct aec_config *config)
+{
+    if (!node) {
+        return -EINVAL;
+    }
+
+    if (config && (!aec_step_valid(config->step_size) ||
+                   !aec_dt_threshold_valid(config->dt_threshold))) {
+        return -EINVAL;
+    }
+
+    // A block tail shorter than a partition could not be cancelled
+    if (CONFIG_AUDIO_BLOCK_SAMPLES % AEC_B != 0) {
+        return -EINVAL;
+    }
+
+    if (aec_ctx_index >= ARRAY_SIZE(aec_contexts)) {
+        return -ENOMEM;
+    }
+
+    const struct audio_fft *fft = audio_fft_plan(AEC_N);
+    if (!fft) {
+        return -EINVAL;
+    }
+
+    struct aec_ctx *ctx = &aec_contexts[aec_ctx_index++];
+
+    if (config) {
+        ctx->config = *config;
+    } else {
+        struct aec_config default_config = AEC_DEFAULT_CONFIG;
+        ctx->config = default_config;
+    }
+    ctx->fft = fft;
+
+    node->vtable = &aec_api;
+    node->ctx = ctx;
+
+    aec_reset(node);
+    return 0;
+}
+
+int node_aec_ref_init(struct audio_node *tap, struct audio_node *aec)
+{
+    if (!tap || !aec || aec->vtable != &aec_api) {
+        return -EINVAL;
+    }
+
+    tap->vtable = &aec_ref_api;
+    tap->ctx = aec->ctx;
+    return 0;
+}
+
+int node_aec_push_reference(struct audio_node *aec, const int16_t *samples, size_t count)
+{
+    if (!aec || aec->vtable != &aec_api || !samples) {
+        return -EINVAL;
+    }
+
+    ref_write((struct aec_ctx *)aec->ctx, samples, count);
+    return 0;
+}
+
+int node_aec_get_stats(struct audio_node *aec, struct aec_stats *stats)
+{
+    if (!aec || aec->vtable != &aec_api || !stats) {
+        return -EINVAL;
+    }
+
+    *stats = ((struct aec_ctx *)aec->ctx)->stats;
+    return 0;
+}
@@ -21,6 +21,9 @@ void analyzer_process(struct audio_node *self) {
     struct audio_block *block = k_fifo_get(&self->in_fifo, K_FOREVER);
     if (!block) return;
 
+    /* Read-only until forwarded, a sibling writer may take the block over */
+    audio_block_begin_read(block);
+
     /* Analysis Phase */
     float sum_sq = 0.0f;
     int16_t peak_abs = 0;
@@ -60,6 +63,7 @@ void analyzer_process(struct audio_node *self) {
     k_spin_unlock(&ctx->lock, key);
 
     /* Pass-Through: Send to output or release */
+    audio_block_end_read(block);
     audio_node_push_output(self, block);
 }
 
@@ -0,0 +1,409 @@
+/**
+ * @file node_beamformer_v2.c
+ * @brief Delay-and-sum beamformer - Sequential Processing Version
+ *
+ * The input block holds interleaved frames of config.mics channels. Each
+ * block is first split into one history line per mic, behind the last
+ * BF_KEEP samples of the previous block, which makes every steering delay
+ * a plain offset into that line. The block buffer is then free and takes
+ * the output, frames of config.beams interleaved beams, in place.
+ *
+ * Every beam owns one path per mic: a whole-sample offset and a 4-tap
+ * Lagrange fractional delay with the mic weight folded into its Q15
+ * coefficients. A beam sample is therefore one 4-tap dot product per
+ * mic, two SMLALD per mic on cores with the DSP extension, accumulated in
+ * 64 bits, so no weighting can overflow before the final saturation.
+ *
+ * The interpolator is evaluated for fractional delays of 1 .. 2 samples,
+ * where its response is flattest, so every path carries one sample more
+ * than its steering delay.
+ *
+ * Steering with a ramp keeps the previous paths and crossfades from their
+ * output to the new one, since sliding the delays themselves would sweep
+ * the pitch. Only the frames of the fade compute both.
+ */
+
+#include "audio_fw_v2.h"
+#include <zephyr/logging/log.h>
+#include <math.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(audio_beamformer, LOG_LEVEL_INF);
+
+#if defined(__ARM_FEATURE_SIMD32)
+#include <arm_acle.h>
+#endif
+
+#define BF_MICS     CONFIG_AUDIO_BEAMFORMER_MAX_MICS
+#define BF_BEAMS    CONFIG_AUDIO_BEAMFORMER_MAX_BEAMS
+#define BF_DELAY    CONFIG_AUDIO_BEAMFORMER_MAX_DELAY
+#define BF_TAPS     4
+
+/* History carried across blocks, and the most frames a block holds (two mics) */
+#define BF_KEEP     (BF_DELAY + BF_TAPS - 1)
+#define BF_FRAMES   (CONFIG_AUDIO_BLOCK_SAMPLES / 2)
+
+#define BF_SPEED_OF_SOUND   343.0f
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/**
+ * @brief One mic of one beam
+ */
+struct bf_path {
+    int16_t coeffs[BF_TAPS];    /**< Weighted interpolator, oldest tap first, Q15 */
+    uint16_t offset;            /**< Whole samples of delay */
+};
+
+/**
+ * @brief One steered beam
+ */
+struct bf_beam {
+    struct bf_path paths[BF_MICS];
+    struct bf_path prev[BF_MICS];   /**< Paths faded out by a ramped steer */
+    uint32_t fade_len;          /**< Crossfade length in frames */
+    uint32_t fade_remaining;    /**< Frames left in the crossfade */
+    float azimuth_deg;          /**< NAN when set through node_beamformer_set_beam() */
+};
+
+/**
+ * @brief Private context for the beamformer
+ */
+struct bf_ctx {
+    struct beamformer_config config;
+    uint32_t sample_rate;
+    struct bf_beam beams[BF_BEAMS];
+    int16_t history[BF_MICS][BF_KEEP + BF_FRAMES];
+};
+
+static void bf_design_path(struct bf_path *path, float delay, float weight)
+{
+    const float whole = floorf(delay);
+    const float d = delay - whole + 1.0f;
+
+    // Lagrange taps for x[n], x[n-1], x[n-2], x[n-3] at delay d
+    const float h[BF_TAPS] = {
+        -(d - 1.0f) * (d - 2.0f) * (d - 3.0f) / 6.0f,
+        d * (d - 2.0f) * (d - 3.0f) / 2.0f,
+        -d * (d - 1.0f) * (d - 3.0f) / 2.0f,
+        d * (d - 1.0f) * (d - 2.0f) / 6.0f,
+    };
+
+    for (size_t k = 0; k < BF_TAPS; k++) {
+        float c = h[BF_TAPS - 1 - k] * weight * 32768.0f;
+
+        if (c > INT16_MAX) c = INT16_MAX;
+        if (c < INT16_MIN) c = INT16_MIN;
+        path->coeffs[k] = (int16_t)lrintf(c);
+    }
+    path->offset = (uint16_t)whole;
+}
+
+/* Samples of delay per millimetre of path difference */
+static float bf_samples_per_mm(const struct bf_ctx *ctx)
+{
+    return (float)ctx->sample_rate / (1000.0f * ctx->config.speed_of_sound);
+}
+
+/**
+ * @brief Designs the paths of a beam for an azimuth.
+ *
+ * At rates above the one the aperture was checked at, a delay may exceed
+ * BF_DELAY; it is clamped, which widens the beam, and a warning logged.
+ */
+static void bf_steer(struct bf_ctx *ctx, size_t beam, float azimuth_deg)
+{
+    const float rad = azimuth_deg * (float)M_PI / 180.0f;
+    const float ux = cosf(rad);
+    const float uy = sinf(rad);
+    const float scale = bf_samples_per_mm(ctx);
+    const float weight = 1.0f / ctx->config.mics;
+    float lead[BF_MICS];
+    float last = INFINITY;
+
+    // The wavefront reaches mics further along the direction first;
+    // they wait for the one it reaches last
+    for (size_t m = 0; m < ctx->config.mics; m++) {
+        lead[m] = ctx->config.positions[m].x_mm * ux + ctx->config.positions[m].y_mm * uy;
+        last = MIN(last, lead[m]);
+    }
+
+    bool clamped = false;
+
+    for (size_t m = 0; m < ctx->config.mics; m++) {
+        float delay = (lead[m] - last) * scale;
+
+        if (delay > (float)BF_DELAY) {
+            delay = (float)BF_DELAY;
+            clamped = true;
+        }
+        bf_design_path(&ctx->beams[beam].paths[m], delay, weight);
+    }
+    ctx->beams[beam].azimuth_deg = azimuth_deg;
+
+    if (clamped) {
+        LOG_WRN("Beam %u at %u Hz needs more than %d samples of delay, clamped",
+                (unsigned int)beam, ctx->sample_rate, BF_DELAY);
+    }
+}
+
+/* First tap of every path of a beam in the history lines */
+static inline void bf_taps(struct bf_ctx *ctx, const struct bf_path *paths,
+                           const int16_t *taps[BF_MICS])
+{
+    for (size_t m = 0; m < ctx->config.mics; m++) {
+        taps[m] = &ctx->history[m][BF_KEEP - (BF_TAPS - 1) - paths[m].offset];
+    }
+}
+
+/* Sum over all mics of one frame, Q30 before rounding */
+static inline int64_t bf_dot(const struct bf_path *paths, const int16_t *const taps[BF_MICS],
+                             size_t mics, size_t n)
+{
+    int64_t acc = 0;
+
+#if defined(__ARM_FEATURE_SIMD32)
+    // Two taps per SMLALD, 64-bit accumulator
+    for (size_t m = 0; m < mics; m++) {
+        int16x2_t x01, x23, c01, c23;
+        memcpy(&x01, &taps[m][n], sizeof(x01));
+        memcpy(&x23, &taps[m][n + 2], sizeof(x23));
+        memcpy(&c01, &paths[m].coeffs[0], sizeof(c01));
+        memcpy(&c23, &paths[m].coeffs[2], sizeof(c23));
+        acc = __smlald(x01, c01, acc);
+        acc = __smlald(x23, c23, acc);
+    }
+#else
+    for (size_t m = 0; m < mics; m++) {
+        const int16_t *x = &taps[m][n];
+        const int16_t *c = paths[m].coeffs;
+
+        acc += (int64_t)x[0] * c[0] + (int64_t)x[1] * c[1] +
+               (int64_t)x[2] * c[2] + (int64_t)x[3] * c[3];
+    }
+#endif
+
+    return acc;
+}
+
+static inline int16_t bf_saturate(int64_t acc)
+{
+    if (acc > INT16_MAX) acc = INT16_MAX;
+    if (acc < INT16_MIN) acc = INT16_MIN;
+    return (int16_t)acc;
+}
+
+static __audio_hot struct audio_block *bf_process(struct audio_node *self, struct audio_block *in)
+{
+    if (!in) {
+        return NULL;
+    }
+
+    struct bf_ctx *ctx = (struct bf_ctx *)self->ctx;
+    const size_t mics = ctx->config.mics;
+    const size_t beams = ctx->config.beams;
+    const size_t frames = in->data_len / mics;
+
+    // Split the frames into the per-mic lines, after the kept history
+    for (size_t m = 0; m < mics; m++) {
+        int16_t *line = &ctx->history[m][BF_KEEP];
+        const int16_t *x = &in->data[m];
+
+        for (size_t n = 0; n < frames; n++) {
+            line[n] = x[n * mics];
+        }
+    }
+
+    // beams <= mics, so the output fits the input frames in place
+    int16_t *out = in->data;
+
+    for (size_t b = 0; b < beams; b++) {
+        struct bf_beam *beam = &ctx->beams[b];
+        const int16_t *taps[BF_MICS];
+        size_t n = 0;
+
+        bf_taps(ctx, beam->paths, taps);
+
+        // Ramped steer: linear crossfade from the previous paths
+        if (beam->fade_remaining) {
+            const int16_t *prev_taps[BF_MICS];
+            const size_t fade = MIN(frames, beam->fade_remaining);
+            const float step = 1.0f / (float)beam->fade_len;
+            float g = (float)(beam->fade_len - beam->fade_remaining) * step;
+
+            bf_taps(ctx, beam->prev, prev_taps);
+            for (; n < fade; n++) {
+                g += step;
+                float y = (float)bf_dot(beam->prev, prev_taps, mics, n) * (1.0f - g) +
+                          (float)bf_dot(beam->paths, taps, mics, n) * g;
+
+                out[n * beams + b] = bf_saturate(lrintf(y * (1.0f / 32768.0f)));
+            }
+            beam->fade_remaining -= fade;
+        }
+
+        for (; n < frames; n++) {
+            int64_t acc = (bf_dot(beam->paths, taps, mics, n) + (1 << 14)) >> 15;
+
+            out[n * beams + b] = bf_saturate(acc);
+        }
+    }
+
+    for (size_t m = 0; m < mics; m++) {
+        memmove(&ctx->history[m][0], &ctx->history[m][frames], BF_KEEP * sizeof(int16_t));
+    }
+
+    in->data_len = frames * beams;
+    return in;
+}
+
+static void bf_reset(struct audio_node *self)
+{
+    struct bf_ctx *ctx = (struct bf_ctx *)self->ctx;
+
+    memset(ctx->history, 0, sizeof(ctx->history));
+    for (size_t b = 0; b < BF_BEAMS; b++) {
+        ctx->beams[b].fade_remaining = 0;
+    }
+}
+
+static void bf_set_sample_rate(struct audio_node *self, uint32_t sample_rate)
+{
+    struct bf_ctx *ctx = (struct bf_ctx *)self->ctx;
+
+    ctx->sample_rate = sample_rate;
+
+    // Beams set in samples keep their delays; fades between old-rate paths end
+    for (size_t b = 0; b < ctx->config.beams; b++) {
+        ctx->beams[b].fade_remaining = 0;
+        if (!isnan(ctx->beams[b].azimuth_deg)) {
+            bf_steer(ctx, b, ctx->beams[b].azimuth_deg);
+        }
+    }
+}
+
+static int bf_set_param(struct audio_node *self, uint32_t id, float value, uint32_t ramp_samples)
+{
+    struct bf_ctx *ctx = (struct bf_ctx *)self->ctx;
+
+    if (id >= ctx->config.beams || !isfinite(value)) {
+        return -EINVAL;
+    }
+
+    struct bf_beam *beam = &ctx->beams[id];
+
+    // A fade still running restarts from its target paths
+    beam->fade_remaining = 0;
+    if (ramp_samples) {
+        memcpy(beam->prev, beam->paths, sizeof(beam->prev));
+        beam->fade_len = ramp_samples;
+        beam->fade_remaining = ramp_samples;
+    }
+
+    bf_steer(ctx, id, value);
+    return 0;
+}
+
+static int bf_get_param(struct audio_node *self, uint32_t id, float *value)
+{
+    struct bf_ctx *ctx = (struct bf_ctx *)self->ctx;
+
+    if (id >= ctx->config.beams) {
+        return -EINVAL;
+    }
+
+    *value = ctx->beams[id].azimuth_deg;
+    return 0;
+}
+
+static const struct audio_node_api bf_api = {
+    .process = bf_process,
+    .reset = bf_reset,
+    .set_sample_rate = bf_set_sample_rate,
+    .set_param = bf_set_param,
+    .get_param = bf_get_param,
+    .param_count = BF_BEAMS,
+};
+
+static struct bf_ctx __audio_node_state bf_contexts[CONFIG_AUDIO_BEAMFORMER_MAX_NODES];
+static size_t bf_ctx_index = 0;
+
+int node_beamformer_init(struct audio_node *node, const struct beamformer_config *config)
+{
+    if (!node || !config) {
+        return -EINVAL;
+    }
+
+    struct beamformer_config cfg = *config;
+
+    if (cfg.speed_of_sound == 0.0f) {
+        cfg.speed_of_sound = BF_SPEED_OF_SOUND;
+    }
+
+    if (cfg.mics < 2 || cfg.mics > BF_MICS || cfg.beams == 0 || cfg.beams > BF_BEAMS ||
+        cfg.beams > cfg.mics || cfg.speed_of_sound < 0.0f) {
+        return -EINVAL;
+    }
+
+    // Any direction delays by at most the widest mic spacing
+    float aperture = 0.0f;
+
+    for (size_t i = 0; i < cfg.mics; i++) {
+        for (size_t j = i + 1; j < cfg.mics; j++) {
+            aperture = MAX(aperture, hypotf(cfg.positions[i].x_mm - cfg.positions[j].x_mm,
+                                            cfg.positions[i].y_mm - cfg.positions[j].y_mm));
+        }
+    }
+
+    if (aperture * CONFIG_AUDIO_SAMPLE_RATE / (1000.0f * cfg.speed_of_sound) > BF_DELAY) {
+        return -EINVAL;
+    }
+
+    if (bf_ctx_index >= ARRAY_SIZE(bf_contexts)) {
+        return -ENOMEM;
+    }
+
+    struct bf_ctx *ctx = &bf_contexts[bf_ctx_index++];
+
+    ctx->config = cfg;
+    ctx->sample_rate = CONFIG_AUDIO_SAMPLE_RATE;
+    for (size_t b = 0; b < cfg.beams; b++) {
+        bf_steer(ctx, b, 0.0f);
+    }
+
+    node->vtable = &bf_api;
+    node->ctx = ctx;
+    bf_reset(node);
+    return 0;
+}
+
+int node_beamformer_set_beam(struct audio_node *node, uint8_t beam, const float *delays,
+                             const float *weights)
+{
+    if (!node || !delays || node->vtable != &bf_api) {
+        return -EINVAL;
+    }
+
+    struct bf_ctx *ctx = (struct bf_ctx *)node->ctx;
+
+    if (beam >= ctx->config.beams) {
+        return -EINVAL;
+    }
+
+    for (size_t m = 0; m < ctx->config.mics; m++) {
+        if (!(delays[m] >= 0.0f && delays[m] <= BF_DELAY) ||
+            (weights && !(fabsf(weights[m]) <= 1.0f))) {
+            return -EINVAL;
+        }
+    }
+
+    for (size_t m = 0; m < ctx->config.mics; m++) {
+        bf_design_path(&ctx->beams[beam].paths[m], delays[m],
+                       weights ? weights[m] : 1.0f / ctx->config.mics);
+    }
+    ctx->beams[beam].azimuth_deg = NAN;
+    ctx->beams[beam].fade_remaining = 0;
+    return 0;
+}
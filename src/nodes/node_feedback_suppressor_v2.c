@@ -0,0 +1,518 @@
+/**
+ * @file node_feedback_suppressor_v2.c
+ * @brief Acoustic feedback suppressor - Sequential Processing Version
+ *
+ * Detection runs on an analysis-only audio_stft of the input (Hann window,
+ * CONFIG_AUDIO_FBS_FFT_SIZE, half overlap). Per frame every local maximum
+ * of the power spectrum is a feedback candidate when it is
+ *
+ * - above min_level_dbfs,
+ * - threshold_db above the mean power of its neighbourhood (the bins
+ *   FBS_NEAR + 1 .. FBS_FAR away on either side, i.e. outside the Hann
+ *   main lobe), which rejects broadband content.
+ *
+ * Candidates are tracked across frames within one bin. A track that keeps
+ * its peak for detect_ms acts at its interpolated frequency: it deploys a
+ * notch (a peaking biquad at -depth_step_db) or, when a notch already
+ * covers the frequency, deepens that one by depth_step_db up to
+ * max_depth_db. Notches not retriggered for hold_ms ramp back towards
+ * 0 dB over release_ms and are then removed from the cascade. With all
+ * max_notches in use, the notch idle the longest is retuned.
+ *
+ * Since the analysis sees the input, a notch that breaks the loop makes
+ * its peak decay and stop retriggering; persistent pure tones in the
+ * programme look like feedback too, which is why the notches are narrow
+ * and released again.
+ *
+ * Notches are the leading stages of one audio_biquad cascade, run over the
+ * block in float; with no notch deployed the audio passes untouched. The
+ * node adds no latency.
+ */
+
+#include "audio_fw_v2.h"
+#include "audio_stft.h"
+#include "audio_biquad.h"
+#include <math.h>
+#include <string.h>
+
+#define FBS_N       CONFIG_AUDIO_FBS_FFT_SIZE
+#define FBS_HOP     (FBS_N / 2)
+#define FBS_BINS    (FBS_N / 2)
+
+BUILD_ASSERT(IS_POWER_OF_TWO(FBS_N) && FBS_N >= 256 && FBS_N <= CONFIG_AUDIO_FFT_MAX_SIZE,
+             "AUDIO_FBS_FFT_SIZE must be a power of two, 256 .. AUDIO_FFT_MAX_SIZE");
+
+/* Neighbourhood of a peak in bins: main lobe half width and outer edge */
+#define FBS_NEAR            2
+#define FBS_FAR             10
+
+/* Candidate tracks, and frames a track survives without its peak */
+#define FBS_TRACKS          8
+#define FBS_TRACK_MISSES    1
+
+/* Keeps the log of empty bins finite */
+#define FBS_POWER_EPSILON   1e-20f
+
+/**
+ * @brief A candidate peak followed across frames
+ */
+struct fbs_track {
+    float bin;                  /**< Interpolated bin, < 0 when free */
+    uint16_t frames;            /**< Consecutive frames with the peak */
+    uint8_t missed;
+    bool seen;
+};
+
+/**
+ * @brief A deployed notch, stage i of the cascade
+ */
+struct fbs_notch {
+    float frequency_hz;
+    float depth_db;
+    uint32_t idle_frames;       /**< Frames since the last detection */
+};
+
+/**
+ * @brief Private context for the feedback suppressor
+ */
+struct fbs_ctx {
+    struct feedback_suppressor_config config;
+    uint32_t sample_rate;
+
+    // Frame-rate dependent timing
+    uint16_t detect_frames;
+    uint32_t hold_frames;
+    float release_step_db;      /**< Depth regained per frame while releasing */
+
+    // Detection
+    struct audio_stft stft;
+    float min_power;            /**< min_level_dbfs as bin power of a sine */
+    float ratio;                /**< threshold_db as a power ratio */
+    float power[FBS_BINS];
+    float cum[FBS_BINS + 1];    /**< cum[k] = sum of power[0 .. k - 1] */
+    struct fbs_track tracks[FBS_TRACKS];
+
+    // Removal
+    struct audio_biquad_cascade bq;
+    struct fbs_notch notches[AUDIO_BIQUAD_MAX_STAGES];
+    float buf[CONFIG_AUDIO_BLOCK_SAMPLES];
+
+    struct feedback_suppressor_stats stats;
+};
+
+static void fbs_design(struct fbs_ctx *ctx, size_t i)
+{
+    float coeffs[AUDIO_BIQUAD_COEFFS];
+
+    audio_biquad_design_peaking(coeffs, ctx->notches[i].frequency_hz, ctx->config.notch_q,
+                                -ctx->notches[i].depth_db, ctx->sample_rate);
+    audio_biquad_set_stage(&ctx->bq, i, coeffs);
+}
+
+static void fbs_remove(struct fbs_ctx *ctx, size_t i)
+{
+    audio_biquad_remove_stage(&ctx->bq, i);
+    memmove(&ctx->notches[i], &ctx->notches[i + 1],
+            (ctx->bq.stages - i) * sizeof(ctx->notches[0]));
+}
+
+/* A track held its peak for detect_ms: deploy, deepen or retune a notch */
+static void fbs_act(struct fbs_ctx *ctx, float freq)
+{
+    const struct feedback_suppressor_config *cfg = &ctx->config;
+    const float bin_hz = (float)ctx->sample_rate / (float)FBS_N;
+    const size_t active = ctx->bq.stages;
+    size_t idlest = 0;
+
+    for (size_t i = 0; i < active; i++) {
+        struct fbs_notch *notch = &ctx->notches[i];
+        float reach = MAX(0.5f * notch->frequency_hz / cfg->notch_q, bin_hz);
+
+        if (fabsf(freq - notch->frequency_hz) <= reach) {
+            notch->depth_db = MIN(notch->depth_db + cfg->depth_step_db, cfg->max_depth_db);
+            notch->idle_frames = 0;
+            fbs_design(ctx, i);
+            return;
+        }
+        if (notch->idle_frames > ctx->notches[idlest].idle_frames) {
+            idlest = i;
+        }
+    }
+
+    if (freq >= 0.5f * (float)ctx->sample_rate) {
+        return;
+    }
+
+    size_t i = idlest;
+
+    if (active < cfg->max_notches) {
+        float unity[AUDIO_BIQUAD_COEFFS] = { 1.0f };
+
+        i = (size_t)audio_biquad_add_stage(&ctx->bq, unity);
+    }
+
+    ctx->notches[i] = (struct fbs_notch) {
+        .frequency_hz = freq,
+        .depth_db = MIN(cfg->depth_step_db, cfg->max_depth_db),
+    };
+    fbs_design(ctx, i);
+    ctx->stats.deployed++;
+}
+
+/* Matches a peak to a track within one bin, or starts a new track */
+static void fbs_track_peak(struct fbs_ctx *ctx, float bin)
+{
+    struct fbs_track *free_track = NULL;
+
+    for (size_t t = 0; t < FBS_TRACKS; t++) {
+        struct fbs_track *track = &ctx->tracks[t];
+
+        if (track->bin < 0.0f) {
+            free_track = free_track ? free_track : track;
+        } else if (!track->seen && fabsf(track->bin - bin) <= 1.0f) {
+            track->bin = bin;
+            track->frames++;
+            track->missed = 0;
+            track->seen = true;
+            return;
+        }
+    }
+
+    // More candidates than tracks: the extra ones wait for a free track
+    if (free_track) {
+        *free_track = (struct fbs_track) { .bin = bin, .frames = 1, .seen = true };
+    }
+}
+
+static __audio_hot void fbs_frame(struct audio_stft *stft, float *spec, void *user_data)
+{
+    struct fbs_ctx *ctx = (struct fbs_ctx *)user_data;
+    float *power = ctx->power;
+    float *cum = ctx->cum;
+
+    power[0] = spec[0] * spec[0];
+    cum[0] = 0.0f;
+    cum[1] = power[0];
+    for (size_t k = 1; k < FBS_BINS; k++) {
+        power[k] = spec[2 * k] * spec[2 * k] + spec[2 * k + 1] * spec[2 * k + 1];
+        cum[k + 1] = cum[k] + power[k];
+    }
+
+    for (size_t t = 0; t < FBS_TRACKS; t++) {
+        ctx->tracks[t].seen = false;
+    }
+
+    for (size_t k = FBS_NEAR + 2; k < FBS_BINS - FBS_NEAR - 1; k++) {
+        const float p = power[k];
+
+        if (p < ctx->min_power || p <= power[k - 1] || p < power[k + 1]) {
+            continue;
+        }
+
+        // Mean power of the bins beside the main lobe, one-sided at the edges
+        size_t lo = k > FBS_FAR ? k - FBS_FAR : 1;
+        size_t hi = MIN(k + FBS_FAR, FBS_BINS - 1);
+        float side = (cum[k - FBS_NEAR] - cum[lo]) + (cum[hi + 1] - cum[k + FBS_NEAR + 1]);
+        size_t count = (k - FBS_NEAR - lo) + (hi - k - FBS_NEAR);
+
+        if (count == 0 || p * (float)count < side * ctx->ratio) {
+            continue;
+        }
+
+        // Parabolic interpolation on the log spectrum
+        float a = logf(power[k - 1] + FBS_POWER_EPSILON);
+        float b = logf(p + FBS_POWER_EPSILON);
+        float c = logf(power[k + 1] + FBS_POWER_EPSILON);
+        float den = a - 2.0f * b + c;
+        float delta = den < 0.0f ? CLAMP(0.5f * (a - c) / den, -0.5f, 0.5f) : 0.0f;
+
+        fbs_track_peak(ctx, (float)k + delta);
+    }
+
+    const float bin_hz = (float)ctx->sample_rate / (float)FBS_N;
+
+    for (size_t t = 0; t < FBS_TRACKS; t++) {
+        struct fbs_track *track = &ctx->tracks[t];
+
+        if (track->bin < 0.0f) {
+            continue;
+        }
+        if (!track->seen && ++track->missed > FBS_TRACK_MISSES) {
+            track->bin = -1.0f;
+            continue;
+        }
+        if (track->frames >= ctx->detect_frames) {
+            track->frames = 0;
+            fbs_act(ctx, track->bin * bin_hz);
+        }
+    }
+
+    // Release: after the hold, ramp towards 0 dB, then drop the stage
+    for (size_t i = 0; i < ctx->bq.stages;) {
+        struct fbs_notch *notch = &ctx->notches[i];
+
+        if (++notch->idle_frames <= ctx->hold_frames) {
+            i++;
+            continue;
+        }
+
+        notch->depth_db -= ctx->release_step_db;
+        if (notch->depth_db <= 0.0f) {
+            fbs_remove(ctx, i);
+            continue;
+        }
+        fbs_design(ctx, i);
+        i++;
+    }
+
+    ctx->stats.active_notches = ctx->bq.stages;
+    ctx->stats.frames++;
+}
+
+static __audio_hot struct audio_block* fbs_process(struct audio_node *self, struct audio_block *in)
+{
+    if (!in) {
+        return NULL;
+    }
+
+    struct fbs_ctx *ctx = (struct fbs_ctx *)self->ctx;
+    int16_t *data = in->data;
+    const size_t len = in->data_len;
+
+    audio_stft_process(&ctx->stft, data, len);
+
+    if (ctx->bq.stages == 0) {
+        return in;
+    }
+
+    float *buf = ctx->buf;
+
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = (float)data[i];
+    }
+
+    audio_biquad_process(&ctx->bq, buf, len);
+
+    for (size_t i = 0; i < len; i++) {
+        float sample = buf[i];
+
+        if (sample > INT16_MAX) sample = INT16_MAX;
+        if (sample < INT16_MIN) sample = INT16_MIN;
+
+        data[i] = (int16_t)sample;
+    }
+
+    return in;
+}
+
+/* Frame-rate dependent timing and detection levels */
+static void fbs_update_timing(struct fbs_ctx *ctx)
+{
+    const struct feedback_suppressor_config *cfg = &ctx->config;
+    const float hop_ms = 1000.0f * FBS_HOP / (float)ctx->sample_rate;
+
+    ctx->detect_frames = MAX(1U, (uint16_t)ceilf((float)cfg->detect_ms / hop_ms));
+    ctx->hold_frames = (uint32_t)((float)cfg->hold_ms / hop_ms);
+    ctx->release_step_db = cfg->release_ms ?
+        cfg->max_depth_db * hop_ms / (float)cfg->release_ms : cfg->max_depth_db;
+}
+
+static void fbs_update_levels(struct fbs_ctx *ctx)
+{
+    // A full-scale sine peaks at |X| = sum(window) / 2
+    float wsum = 0.0f;
+    for (size_t i = 0; i < FBS_N; i++) {
+        wsum += ctx->stft.window[i];
+    }
+
+    float amp = powf(10.0f, ctx->config.min_level_dbfs / 20.0f) * 0.5f * wsum;
+
+    ctx->min_power = amp * amp;
+    ctx->ratio = powf(10.0f, ctx->config.threshold_db / 10.0f);
+}
+
+static void fbs_clear_tracks(struct fbs_ctx *ctx)
+{
+    for (size_t t = 0; t < FBS_TRACKS; t++) {
+        ctx->tracks[t].bin = -1.0f;
+    }
+}
+
+static void fbs_reset(struct audio_node *self)
+{
+    struct fbs_ctx *ctx = (struct fbs_ctx *)self->ctx;
+
+    audio_stft_reset(&ctx->stft);
+    audio_biquad_init(&ctx->bq);
+    fbs_clear_tracks(ctx);
+    memset(&ctx->stats, 0, sizeof(ctx->stats));
+}
+
+/**
+ * @brief Sample rate change: notches stay at their frequencies in Hz
+ */
+static void fbs_set_sample_rate(struct audio_node *self, uint32_t sample_rate)
+{
+    struct fbs_ctx *ctx = (struct fbs_ctx *)self->ctx;
+
+    ctx->sample_rate = sample_rate;
+    fbs_update_timing(ctx);
+
+    audio_stft_reset(&ctx->stft);
+    fbs_clear_tracks(ctx);
+
+    for (size_t i = 0; i < ctx->bq.stages;) {
+        if (ctx->notches[i].frequency_hz >= 0.5f * (float)sample_rate) {
+            fbs_remove(ctx, i);
+            continue;
+        }
+        fbs_design(ctx, i++);
+    }
+    audio_biquad_reset(&ctx->bq);
+    ctx->stats.active_notches = ctx->bq.stages;
+}
+
+static int fbs_set_param(struct audio_node *self, uint32_t id, float value, uint32_t ramp_samples)
+{
+    struct fbs_ctx *ctx = (struct fbs_ctx *)self->ctx;
+
+    switch (id) {
+    case NODE_FBS_PARAM_THRESHOLD:
+        // Written so that NaN fails too
+        if (!(value > 0.0f)) {
+            return -EINVAL;
+        }
+        ctx->config.threshold_db = value;
+        fbs_update_levels(ctx);
+        return 0;
+    case NODE_FBS_PARAM_MAX_DEPTH:
+        if (!(value > 0.0f)) {
+            return -EINVAL;
+        }
+        ctx->config.max_depth_db = value;
+        fbs_update_timing(ctx);
+        // Deeper notches than allowed now come up right away
+        for (size_t i = 0; i < ctx->bq.stages; i++) {
+            if (ctx->notches[i].depth_db > value) {
+                ctx->notches[i].depth_db = value;
+                fbs_design(ctx, i);
+            }
+        }
+        return 0;
+    default:
+        return -EINVAL;
+    }
+}
+
+static int fbs_get_param(struct audio_node *self, uint32_t id, float *value)
+{
+    struct fbs_ctx *ctx = (struct fbs_ctx *)self->ctx;
+
+    switch (id) {
+    case NODE_FBS_PARAM_THRESHOLD:
+        *value = ctx->config.threshold_db;
+        return 0;
+    case NODE_FBS_PARAM_MAX_DEPTH:
+        *value = ctx->config.max_depth_db;
+        return 0;
+    default:
+        return -EINVAL;
+    }
+}
+
+static const struct audio_node_api fbs_api = {
+    .process = fbs_process,
+    .reset = fbs_reset,
+    .set_sample_rate = fbs_set_sample_rate,
+    .set_param = fbs_set_param,
+    .get_param = fbs_get_param,
+    .param_count = 2,
+};
+
+static struct fbs_ctx __audio_node_state fbs_contexts[CONFIG_AUDIO_FBS_MAX_NODES];
+static size_t fbs_ctx_index = 0;
+
+int node_feedback_suppressor_init(struct audio_node *node,
+                                  const struct feedback_suppressor_config *config)
+{
+    if (!node) {
+        return -EINVAL;
+    }
+
+    struct feedback_suppressor_config cfg = FEEDBACK_SUPPRESSOR_DEFAULT_CONFIG;
+    if (config) {
+        cfg = *config;
+    }
+
+    if (cfg.max_notches == 0 || cfg.max_notches > AUDIO_BIQUAD_MAX_STAGES ||
+        !(cfg.notch_q > 0.0f) || !(cfg.max_depth_db > 0.0f) || !(cfg.depth_step_db > 0.0f) ||
+        !(cfg.threshold_db > 0.0f) || !isfinite(cfg.min_level_dbfs) || cfg.detect_ms == 0) {
+        return -EINVAL;
+    }
+
+    if (fbs_ctx_index >= ARRAY_SIZE(fbs_contexts)) {
+        return -ENOMEM;
+    }
+
+    struct fbs_ctx *ctx = &fbs_contexts[fbs_ctx_index];
+    struct audio_stft_config stft_config = {
+        .fft_size = FBS_N,
+        .hop_size = FBS_HOP,
+        .analysis_only = true,
+        .frame = fbs_frame,
+        .user_data = ctx,
+    };
+
+    int ret = audio_stft_init(&ctx->stft, &stft_config);
+    if (ret) {
+        return ret;
+    }
+
+    // Hann (the square of the default sqrt-Hann) for a low-leakage peak search
+    for (size_t i = 0; i < FBS_N; i++) {
+        ctx->stft.window[i] *= ctx->stft.window[i];
+    }
+
+    fbs_ctx_index++;
+    ctx->config = cfg;
+    ctx->sample_rate = CONFIG_AUDIO_SAMPLE_RATE;
+    fbs_update_timing(ctx);
+    fbs_update_levels(ctx);
+
+    node->vtable = &fbs_api;
+    node->ctx = ctx;
+    fbs_reset(node);
+    return 0;
+}
+
+int node_feedback_suppressor_get_notches(struct audio_node *node,
+                                         struct feedback_suppressor_notch *notches,
+                                         size_t max_notches)
+{
+    if (!node || (!notches && max_notches) || node->vtable != &fbs_api) {
+        return -EINVAL;
+    }
+
+    struct fbs_ctx *ctx = (struct fbs_ctx *)node->ctx;
+    size_t count = MIN((size_t)ctx->bq.stages, max_notches);
+
+    for (size_t i = 0; i < count; i++) {
+        notches[i].frequency_hz = ctx->notches[i].frequency_hz;
+        notches[i].depth_db = ctx->notches[i].depth_db;
+    }
+
+    return (int)count;
+}
+
+int node_feedback_suppressor_get_stats(struct audio_node *node,
+                                       struct feedback_suppressor_stats *stats)
+{
+    if (!node || !stats || node->vtable != &fbs_api) {
+        return -EINVAL;
+    }
+
+    struct fbs_ctx *ctx = (struct fbs_ctx *)node->ctx;
+
+    *stats = ctx->stats;
+    return 0;
+}
@@ -7,6 +7,8 @@ void log_sink_process(struct audio_node *self) {
     struct audio_block *block = k_fifo_get(&self->in_fifo, K_FOREVER);
     if (!block) return;
 
+    audio_block_begin_read(block);
+
     int16_t max_val = 0;
     if (block->data) {
         for(size_t i = 0; i < block->data_len; i++) {
@@ -17,7 +19,7 @@ void log_sink_process(struct audio_node *self) {
     }
     LOG_INF("SINK [%p]: Peak=%d | RefCount=%ld", block, max_val, atomic_get(&block->ref_count));
 
-    audio_block_release(block);
+    audio_block_release_read(block);
 }
 
 const struct audio_node_api log_sink_api = {
@@ -0,0 +1,352 @@
+/**
+ * @file node_noise_suppressor_v2.c
+ * @brief Spectral-subtraction noise suppressor - Sequential Processing Version
+ *
+ * Runs on an audio_stft with sqrt-Hann frames of CONFIG_AUDIO_NS_FFT_SIZE
+ * and half overlap. Per frame and bin:
+ *
+ * - Noise tracking (minimum statistics): the recursively smoothed
+ *   periodogram is searched for its minimum over noise_window_ms, split
+ *   into NS_SUBWINDOWS sub-windows so the search costs one compare per
+ *   bin and frame plus one pass over the sub-window minima per sub-window.
+ *   The minimum is biased low relative to the mean and is scaled back up.
+ * - Gain: power spectral subtraction with oversubtraction,
+ *   g^2 = 1 - oversubtraction * noise / power, floored at the maximum
+ *   attenuation.
+ * - Musical-noise mitigation: the floor keeps isolated residual peaks from
+ *   standing out of silence, the raw gains are smoothed across
+ *   neighbouring bins, and then over time with a fast attack (speech
+ *   onsets) and a slow release (random gain dips in the noise).
+ */
+
+#include "audio_fw_v2.h"
+#include "audio_stft.h"
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#define NS_N        CONFIG_AUDIO_NS_FFT_SIZE
+#define NS_HOP      (NS_N / 2)
+#define NS_BINS     (NS_N / 2 + 1)
+
+BUILD_ASSERT(IS_POWER_OF_TWO(NS_N) && NS_N >= 32 && NS_N <= CONFIG_AUDIO_FFT_MAX_SIZE,
+             "AUDIO_NS_FFT_SIZE must be a power of two, 32 .. AUDIO_FFT_MAX_SIZE");
+
+/*
+ * Minimum statistics: sub-window count, periodogram smoothing time constant
+ * and the bias of the minimum at that smoothing. The gain works on a more
+ * lightly smoothed periodogram. Time constants keep the statistics the
+ * same at every rate.
+ */
+#define NS_SUBWINDOWS       8
+#define NS_POWER_TAU_MS     50.0f
+#define NS_MIN_BIAS         1.9f
+#define NS_GAIN_TAU_MS      12.0f
+
+/* Attack coefficient relative to the configured release */
+#define NS_ATTACK_RATIO     0.25f
+
+/* Keeps the subtraction finite in digital silence */
+#define NS_POWER_EPSILON    1e-12f
+
+/**
+ * @brief Private context for the noise suppressor
+ */
+struct ns_ctx {
+    struct noise_suppressor_config config;
+    uint32_t sample_rate;
+    float gain_floor;               /**< From max_attenuation_db */
+    float power_alpha;              /**< Per-frame smoothing for noise tracking */
+    float gain_alpha;               /**< Per-frame smoothing for the gain */
+
+    struct audio_stft stft;
+
+    // Minimum statistics
+    float smooth_power[NS_BINS];    /**< Smoothed periodogram */
+    float gain_power[NS_BINS];      /**< Lightly smoothed periodogram for the gain */
+    float cur_min[NS_BINS];         /**< Minimum of the running sub-window */
+    float sub_min[NS_SUBWINDOWS][NS_BINS];
+    float win_min[NS_BINS];         /**< Minimum over the stored sub-windows */
+    float noise[NS_BINS];           /**< Bias-corrected noise power */
+    uint32_t sub_frames;            /**< Frames per sub-window at this rate */
+    uint32_t sub_fill;
+    size_t sub_next;
+    bool primed;                    /**< smooth_power holds a first frame */
+
+    // Gains
+    float raw_gain[NS_BINS];
+    float gain[NS_BINS];
+
+    struct noise_suppressor_stats stats;
+};
+
+static inline float bin_power(const float *spec, size_t k)
+{
+    if (k == 0) {
+        return spec[0] * spec[0];
+    }
+    if (k == NS_BINS - 1) {
+        return spec[1] * spec[1];
+    }
+    return spec[2 * k] * spec[2 * k] + spec[2 * k + 1] * spec[2 * k + 1];
+}
+
+/* Closes a sub-window: stores its minimum and refreshes the window minimum */
+static void ns_rotate_subwindow(struct ns_ctx *ctx)
+{
+    memcpy(ctx->sub_min[ctx->sub_next], ctx->cur_min, sizeof(ctx->cur_min));
+    ctx->sub_next = (ctx->sub_next + 1) % NS_SUBWINDOWS;
+
+    for (size_t k = 0; k < NS_BINS; k++) {
+        float m = ctx->sub_min[0][k];
+        for (size_t u = 1; u < NS_SUBWINDOWS; u++) {
+            m = MIN(m, ctx->sub_min[u][k]);
+        }
+        ctx->win_min[k] = m;
+        ctx->cur_min[k] = FLT_MAX;
+    }
+}
+
+static __audio_hot void ns_frame(struct audio_stft *stft, float *spec, void *user_data)
+{
+    struct ns_ctx *ctx = (struct ns_ctx *)user_data;
+    const float over = ctx->config.oversubtraction;
+    const float floor = ctx->gain_floor;
+    const float floor2 = floor * floor;
+    const float pa = ctx->power_alpha;
+    const float ga = ctx->gain_alpha;
+
+    if (!ctx->primed) {
+        for (size_t k = 0; k < NS_BINS; k++) {
+            ctx->smooth_power[k] = bin_power(spec, k);
+            ctx->gain_power[k] = ctx->smooth_power[k];
+        }
+        ctx->primed = true;
+    }
+
+    for (size_t k = 0; k < NS_BINS; k++) {
+        const float p = bin_power(spec, k);
+        const float s = pa * ctx->smooth_power[k] + (1.0f - pa) * p;
+
+        ctx->smooth_power[k] = s;
+        ctx->cur_min[k] = MIN(ctx->cur_min[k], s);
+        ctx->noise[k] = NS_MIN_BIAS * MIN(ctx->win_min[k], ctx->cur_min[k]);
+
+        const float pg = ga * ctx->gain_power[k] + (1.0f - ga) * p;
+        ctx->gain_power[k] = pg;
+
+        const float g2 = 1.0f - over * ctx->noise[k] / (pg + NS_POWER_EPSILON);
+        ctx->raw_gain[k] = g2 > floor2 ? sqrtf(g2) : floor;
+    }
+
+    if (++ctx->sub_fill >= ctx->sub_frames) {
+        ctx->sub_fill = 0;
+        ns_rotate_subwindow(ctx);
+    }
+
+    // Frequency smoothing [1 2 1] / 4, then asymmetric smoothing over time
+    const float release = ctx->config.gain_smoothing;
+    const float attack = release * NS_ATTACK_RATIO;
+    float gain_sum = 0.0f;
+
+    for (size_t k = 0; k < NS_BINS; k++) {
+        const float lo = ctx->raw_gain[k > 0 ? k - 1 : k + 1];
+        const float hi = ctx->raw_gain[k < NS_BINS - 1 ? k + 1 : k - 1];
+        const float g = 0.25f * (lo + hi) + 0.5f * ctx->raw_gain[k];
+        const float a = g > ctx->gain[k] ? attack : release;
+
+        ctx->gain[k] = a * ctx->gain[k] + (1.0f - a) * g;
+        gain_sum += ctx->gain[k];
+    }
+
+    spec[0] *= ctx->gain[0];
+    spec[1] *= ctx->gain[NS_BINS - 1];
+    for (size_t k = 1; k < NS_BINS - 1; k++) {
+        spec[2 * k] *= ctx->gain[k];
+        spec[2 * k + 1] *= ctx->gain[k];
+    }
+
+    ctx->stats.gain_db = 20.0f * log10f(gain_sum / (float)NS_BINS);
+    ctx->stats.frames++;
+}
+
+static struct audio_block* ns_process(struct audio_node *self, struct audio_block *in)
+{
+    if (!in) {
+        return NULL;
+    }
+
+    struct ns_ctx *ctx = (struct ns_ctx *)self->ctx;
+
+    audio_stft_process(&ctx->stft, in->data, in->data_len);
+    return in;
+}
+
+/* Frame-rate dependent smoothing and sub-window length */
+static void ns_update_timing(struct ns_ctx *ctx)
+{
+    const float hop_ms = 1000.0f * NS_HOP / (float)ctx->sample_rate;
+
+    ctx->power_alpha = expf(-hop_ms / NS_POWER_TAU_MS);
+    ctx->gain_alpha = expf(-hop_ms / NS_GAIN_TAU_MS);
+
+    uint32_t window_frames = (uint32_t)ctx->config.noise_window_ms * ctx->sample_rate /
+                             (1000U * NS_HOP);
+
+    ctx->sub_frames = MAX(1U, window_frames / NS_SUBWINDOWS);
+}
+
+static void ns_reset(struct audio_node *self)
+{
+    struct ns_ctx *ctx = (struct ns_ctx *)self->ctx;
+
+    audio_stft_reset(&ctx->stft);
+
+    for (size_t k = 0; k < NS_BINS; k++) {
+        ctx->cur_min[k] = FLT_MAX;
+        ctx->win_min[k] = FLT_MAX;
+        ctx->gain[k] = 1.0f;
+        for (size_t u = 0; u < NS_SUBWINDOWS; u++) {
+            ctx->sub_min[u][k] = FLT_MAX;
+        }
+    }
+    memset(ctx->smooth_power, 0, sizeof(ctx->smooth_power));
+    memset(ctx->gain_power, 0, sizeof(ctx->gain_power));
+    memset(ctx->noise, 0, sizeof(ctx->noise));
+    memset(&ctx->stats, 0, sizeof(ctx->stats));
+    ctx->sub_fill = 0;
+    ctx->sub_next = 0;
+    ctx->primed = false;
+}
+
+/**
+ * @brief Sample rate change: the search window is defined in time
+ */
+static void ns_set_sample_rate(struct audio_node *self, uint32_t sample_rate)
+{
+    struct ns_ctx *ctx = (struct ns_ctx *)self->ctx;
+
+    ctx->sample_rate = sample_rate;
+    ns_update_timing(ctx);
+}
+
+static int ns_set_param(struct audio_node *self, uint32_t id, float value, uint32_t ramp_samples)
+{
+    struct ns_ctx *ctx = (struct ns_ctx *)self->ctx;
+
+    switch (id) {
+    case NODE_NS_PARAM_MAX_ATTENUATION:
+        // Also rejects NaN, which every comparison lets through
+        if (!isfinite(value) || value < 0.0f) {
+            return -EINVAL;
+        }
+        ctx->config.max_attenuation_db = value;
+        ctx->gain_floor = powf(10.0f, -value / 20.0f);
+        return 0;
+    case NODE_NS_PARAM_OVERSUBTRACTION:
+        if (!isfinite(value) || value < 0.0f) {
+            return -EINVAL;
+        }
+        ctx->config.oversubtraction = value;
+        return 0;
+    default:
+        return -EINVAL;
+    }
+}
+
+static int ns_get_param(struct audio_node *self, uint32_t id, float *value)
+{
+    struct ns_ctx *ctx = (struct ns_ctx *)self->ctx;
+
+    switch (id) {
+    case NODE_NS_PARAM_MAX_ATTENUATION:
+        *value = ctx->config.max_attenuation_db;
+        return 0;
+    case NODE_NS_PARAM_OVERSUBTRACTION:
+        *value = ctx->config.oversubtraction;
+        return 0;
+    default:
+        return -EINVAL;
+    }
+}
+
+static const struct audio_node_api ns_api = {
+    .process = ns_process,
+    .reset = ns_reset,
+    .set_sample_rate = ns_set_sample_rate,
+    .set_param = ns_set_param,
+    .get_param = ns_get_param,
+    .param_count = 2,
+};
+
+static struct ns_ctx __audio_node_state ns_contexts[CONFIG_AUDIO_NS_MAX_NODES];
+static size_t ns_ctx_index = 0;
+
+int node_noise_suppressor_init(struct audio_node *node,
+                               const struct noise_suppressor_config *config)
+{
+    if (!node) {
+        return -EINVAL;
+    }
+
+    if (ns_ctx_index >= ARRAY_SIZE(ns_contexts)) {
+        return -ENOMEM;
+    }
+
+    struct noise_suppressor_config cfg = NOISE_SUPPRESSOR_DEFAULT_CONFIG;
+    if (config) {
+        cfg = *config;
+    }
+
+    if (!isfinite(cfg.max_attenuation_db) || cfg.max_attenuation_db < 0.0f ||
+        !isfinite(cfg.oversubtraction) || cfg.oversubtraction < 0.0f ||
+        !(cfg.gain_smoothing >= 0.0f && cfg.gain_smoothing < 1.0f) ||
+        cfg.noise_window_ms == 0) {
+        return -EINVAL;
+    }
+
+    struct ns_ctx *ctx = &ns_contexts[ns_ctx_index];
+    struct audio_stft_config stft_config = {
+        .fft_size = NS_N,
+        .hop_size = NS_HOP,
+        .frame = ns_frame,
+        .user_data = ctx,
+    };
+
+    int ret = audio_stft_init(&ctx->stft, &stft_config);
+    if (ret) {
+        return ret;
+    }
+
+    ns_ctx_index++;
+    ctx->config = cfg;
+    ctx->gain_floor = powf(10.0f, -cfg.max_attenuation_db / 20.0f);
+    ctx->sample_rate = CONFIG_AUDIO_SAMPLE_RATE;
+    ns_update_timing(ctx);
+
+    node->vtable = &ns_api;
+    node->ctx = ctx;
+    ns_reset(node);
+    return 0;
+}
+
+int node_noise_suppressor_get_stats(struct audio_node *node,
+                                    struct noise_suppressor_stats *stats)
+{
+    if (!node || !stats || node->vtable != &ns_api) {
+        return -EINVAL;
+    }
+
+    struct ns_ctx *ctx = (struct ns_ctx *)node->ctx;
+
+    *stats = ctx->stats;
+
+    // White noise of variance v gives E|X|^2 = v * sum(w^2) = v * N / 2
+    float sum = 0.0f;
+    for (size_t k = 0; k < NS_BINS; k++) {
+        sum += ctx->noise[k];
+    }
+    stats->noise_dbfs = sum > 0.0f ?
+        10.0f * log10f(sum / (float)NS_BINS / (0.5f * NS_N)) : -INFINITY;
+    return 0;
+}
@@ -0,0 +1,219 @@
+/**
+ * @file node_oversample_v2.c
+ * @brief Oversampling wrapper for nonlinear nodes - Sequential Processing Version
+ *
+ * Runs an inner node at 2x or 4x the pipeline rate. Each block is split
+ * into chunks of CONFIG_AUDIO_BLOCK_SAMPLES / factor samples; a chunk is
+ * upsampled into a pool block, processed by the inner node and decimated
+ * back in place. 4x cascades two half-band stages, the second one (at 2x)
+ * with the shorter CONFIG_AUDIO_OVERSAMPLE_STAGE2_TAPS filter.
+ */
+
+#include "audio_fw_v2.h"
+#include "audio_halfband.h"
+#include <string.h>
+
+BUILD_ASSERT((CONFIG_AUDIO_OVERSAMPLE_TAPS % 2) == 0 &&
+             (CONFIG_AUDIO_OVERSAMPLE_STAGE2_TAPS % 2) == 0,
+             "Half-band branch lengths must be even");
+BUILD_ASSERT((CONFIG_AUDIO_BLOCK_SAMPLES % 4) == 0,
+             "Oversampling needs a block size divisible by 4");
+
+/**
+ * @brief Private context for the oversampling wrapper
+ */
+struct oversample_ctx {
+    struct audio_node_api api;      /**< Wrapper vtable, param_count taken from the inner node */
+    struct audio_node *inner;       /**< Wrapped node, runs at factor * sample rate */
+    uint8_t factor;                 /**< 2 or 4 */
+
+    struct audio_halfband_up up1;   /**< Base rate -> 2x */
+    struct audio_halfband_down down1;
+    struct audio_halfband_up up2;   /**< 2x -> 4x (factor 4 only) */
+    struct audio_halfband_down down2;
+    int16_t pad;                    /**< One 2x sample of delay, keeps 4x latency whole */
+
+    int16_t mid[CONFIG_AUDIO_BLOCK_SAMPLES / 2];   /**< 2x intermediate for factor 4 */
+};
+
+static int16_t stage1_coeffs[CONFIG_AUDIO_OVERSAMPLE_TAPS];
+static int16_t stage2_coeffs[CONFIG_AUDIO_OVERSAMPLE_STAGE2_TAPS];
+static bool coeffs_ready;
+
+/* Decimator input for chunks the inner node dropped */
+static const int16_t silence[CONFIG_AUDIO_BLOCK_SAMPLES];
+
+/* Base rate -> factor x, n base-rate samples */
+static void oversample_up(struct oversample_ctx *ctx, const int16_t *in, int16_t *out, size_t n)
+{
+    if (ctx->factor == 2) {
+        audio_halfband_up(&ctx->up1, in, out, n);
+    } else {
+        audio_halfband_up(&ctx->up1, in, ctx->mid, n);
+        audio_halfband_up(&ctx->up2, ctx->mid, out, 2 * n);
+    }
+}
+
+/* factor x -> base rate, n base-rate samples */
+static void oversample_down(struct oversample_ctx *ctx, const int16_t *in, int16_t *out, size_t n)
+{
+    if (ctx->factor == 2) {
+        audio_halfband_down(&ctx->down1, in, out, n);
+        return;
+    }
+
+    audio_halfband_down(&ctx->down2, in, ctx->mid, 2 * n);
+
+    for (size_t i = 0; i < 2 * n; i++) {
+        int16_t s = ctx->mid[i];
+        ctx->mid[i] = ctx->pad;
+        ctx->pad = s;
+    }
+
+    audio_halfband_down(&ctx->down1, ctx->mid, out, n);
+}
+
+/**
+ * @brief Sequential processing function for the oversampling wrapper
+ */
+static struct audio_block* oversample_process(struct audio_node *self, struct audio_block *in)
+{
+    if (!in) {
+        return NULL;
+    }
+
+    struct oversample_ctx *ctx = (struct oversample_ctx *)self->ctx;
+    const size_t chunk = CONFIG_AUDIO_BLOCK_SAMPLES / ctx->factor;
+    struct audio_block *work = NULL;
+
+    for (size_t off = 0; off < in->data_len; off += chunk) {
+        size_t n = MIN(chunk, in->data_len - off);
+
+        if (!work) {
+            work = audio_block_alloc();
+            if (!work) {
+                // Pool exhausted: rest of the block passes through untouched
+                break;
+            }
+        }
+
+        oversample_up(ctx, &in->data[off], work->data, n);
+        work->data_len = n * ctx->factor;
+        work->flags = in->flags;
+
+        struct audio_block *out = audio_node_process(ctx->inner, work);
+
+        if (out) {
+            oversample_down(ctx, out->data, &in->data[off], n);
+        } else {
+            // Inner node dropped (and owns) the block: decimate silence
+            oversample_down(ctx, silence, &in->data[off], n);
+        }
+
+        if (out != work) {
+            if (out) {
+                audio_block_release(out);
+            }
+            work = NULL;
+        }
+    }
+
+    if (work) {
+        audio_block_release(work);
+    }
+
+    return in;
+}
+
+static void oversample_reset(struct audio_node *self)
+{
+    struct oversample_ctx *ctx = (struct oversample_ctx *)self->ctx;
+
+    audio_halfband_up_init(&ctx->up1, stage1_coeffs, CONFIG_AUDIO_OVERSAMPLE_TAPS);
+    audio_halfband_down_init(&ctx->down1, stage1_coeffs, CONFIG_AUDIO_OVERSAMPLE_TAPS);
+    audio_halfband_up_init(&ctx->up2, stage2_coeffs, CONFIG_AUDIO_OVERSAMPLE_STAGE2_TAPS);
+    audio_halfband_down_init(&ctx->down2, stage2_coeffs, CONFIG_AUDIO_OVERSAMPLE_STAGE2_TAPS);
+    ctx->pad = 0;
+
+    audio_node_reset(ctx->inner);
+}
+
+static void oversample_set_sample_rate(struct audio_node *self, uint32_t sample_rate)
+{
+    struct oversample_ctx *ctx = (struct oversample_ctx *)self->ctx;
+
+    audio_node_set_sample_rate(ctx->inner, sample_rate * ctx->factor);
+}
+
+static int oversample_set_param(struct audio_node *self, uint32_t id, float value,
+                                uint32_t ramp_samples)
+{
+    struct oversample_ctx *ctx = (struct oversample_ctx *)self->ctx;
+
+    return audio_node_set_param(ctx->inner, id, value, ramp_samples * ctx->factor);
+}
+
+static int oversample_get_param(struct audio_node *self, uint32_t id, float *value)
+{
+    struct oversample_ctx *ctx = (struct oversample_ctx *)self->ctx;
+
+    return audio_node_get_param(ctx->inner, id, value);
+}
+
+static struct oversample_ctx __audio_node_state oversample_contexts[CONFIG_AUDIO_OVERSAMPLE_MAX_NODES];
+static size_t oversample_ctx_index = 0;
+
+int node_oversample_init(struct audio_node *node, struct audio_node *inner, uint8_t factor)
+{
+    if (!node || !inner || (factor != 2 && factor != 4)) {
+        return -EINVAL;
+    }
+
+    if (oversample_ctx_index >= ARRAY_SIZE(oversample_contexts)) {
+        return -ENOMEM;
+    }
+
+    if (!coeffs_ready) {
+        audio_halfband_design(stage1_coeffs, CONFIG_AUDIO_OVERSAMPLE_TAPS);
+        audio_halfband_design(stage2_coeffs, CONFIG_AUDIO_OVERSAMPLE_STAGE2_TAPS);
+        coeffs_ready = true;
+    }
+
+    struct oversample_ctx *ctx = &oversample_contexts[oversample_ctx_index++];
+    ctx->inner = inner;
+    ctx->factor = factor;
+    ctx->api = (struct audio_node_api) {
+        .process = oversample_process,
+        .reset = oversample_reset,
+        .set_sample_rate = oversample_set_sample_rate,
+        .set_param = oversample_set_param,
+        .get_param = oversample_get_param,
+        .param_count = inner->vtable ? inner->vtable->param_count : 0,
+    };
+
+    node->vtable = &ctx->api;
+    node->ctx = ctx;
+
+    oversample_reset(node);
+    audio_node_set_sample_rate(inner, CONFIG_AUDIO_SAMPLE_RATE * factor);
+
+    return 0;
+}
+
+uint32_t node_oversample_get_latency(struct audio_node *node)
+{
+    // Each wrapper has its own vtable; the process function identifies it
+    if (!node || !node->vtable || node->vtable->process != oversample_process) {
+        return 0;
+    }
+
+    struct oversample_ctx *ctx = (struct oversample_ctx *)node->ctx;
+    uint32_t latency = CONFIG_AUDIO_OVERSAMPLE_TAPS - 1;
+
+    if (ctx->factor == 4) {
+        // Stage 2 adds taps2 - 1 samples at 2x, the pad one more
+        latency += CONFIG_AUDIO_OVERSAMPLE_STAGE2_TAPS / 2;
+    }
+
+    return latency;
+}
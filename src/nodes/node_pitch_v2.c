@@ -0,0 +1,336 @@
+/**
+ * @file node_pitch_v2.c
+ * @brief YIN pitch detector - Sequential Processing Version
+ *
+ * Analysis-only audio_stft with a rectangular window: every hop the last
+ * N = 2W samples are available as a spectrum X. With A the spectrum of
+ * the first W samples (zero-padded to N), IFFT(conj(A) * X) is the
+ * cross-correlation r(tau) = sum_{j<W} x[j] x[j + tau] for tau <= W,
+ * without circular wrap. The YIN difference function then follows as
+ *
+ *   d(tau) = sum_{j<W} x[j]^2 + sum_{j<W} x[j + tau]^2 - 2 r(tau)
+ *
+ * with the second energy term as a running sum, so a frame costs two
+ * FFTs of N plus O(W) instead of O(W^2).
+ *
+ * The cumulative mean normalized difference d'(tau) is searched between
+ * the lags of max_hz and min_hz for the first dip below the threshold,
+ * refined by parabolic interpolation. Estimates are published
+ * double-buffered under a sequence counter: the writer fills the slot
+ * readers are not using, so a reader never waits for the audio thread,
+ * even when it preempts it mid-update, and only retries if two whole
+ * estimates landed during its copy.
+ */
+
+#include "audio_fw_v2.h"
+#include "audio_stft.h"
+#include <zephyr/sys/barrier.h>
+#include <math.h>
+#include <string.h>
+
+#define PITCH_MAX_N     CONFIG_AUDIO_FFT_MAX_SIZE
+#define PITCH_MAX_W     (PITCH_MAX_N / 2)
+
+/**
+ * @brief Private context for the pitch detector
+ */
+struct pitch_ctx {
+    struct pitch_config config;
+    uint32_t sample_rate;
+    size_t window;                  /**< W, integration window and maximum lag */
+    size_t tau_min;
+    size_t tau_max;
+
+    struct audio_stft stft;
+
+    // Working buffers
+    float time[PITCH_MAX_N];
+    float cross[PITCH_MAX_N];       /**< conj(A) * X, then r(tau) */
+    float cmnd[PITCH_MAX_W + 1];    /**< d'(tau) */
+
+    // Published estimates: seq is twice the count, odd while writing;
+    // estimate p lives in slots[p & 1]
+    struct pitch_result slots[2];
+    atomic_t seq;
+};
+
+static void pitch_publish(struct pitch_ctx *ctx, const struct pitch_result *result)
+{
+    atomic_val_t seq = atomic_get(&ctx->seq);
+    uint32_t next = (uint32_t)(seq / 2) + 1;
+    struct pitch_result *slot = &ctx->slots[next & 1];
+
+    // Atomics are full barriers: the slot writes stay between the two
+    atomic_set(&ctx->seq, seq + 1);
+    *slot = *result;
+    slot->sequence = next;
+    atomic_set(&ctx->seq, seq + 2);
+}
+
+/* Picks the YIN lag and fills the estimate */
+static void pitch_estimate(struct pitch_ctx *ctx, struct pitch_result *result)
+{
+    const float *cmnd = ctx->cmnd;
+    size_t tau = 0;
+
+    for (size_t t = ctx->tau_min; t <= ctx->tau_max; t++) {
+        if (cmnd[t] < ctx->config.threshold) {
+            // Walk down to the bottom of this dip
+            while (t + 1 <= ctx->tau_max && cmnd[t + 1] < cmnd[t]) {
+                t++;
+            }
+            tau = t;
+            break;
+        }
+    }
+
+    result->voiced = tau != 0;
+    if (!result->voiced) {
+        tau = ctx->tau_min;
+        for (size_t t = ctx->tau_min + 1; t <= ctx->tau_max; t++) {
+            if (cmnd[t] < cmnd[tau]) {
+                tau = t;
+            }
+        }
+    }
+
+    result->confidence = CLAMP(1.0f - cmnd[tau], 0.0f, 1.0f);
+
+    // Parabolic interpolation of the minimum
+    float lag = (float)tau;
+    if (tau > 1 && tau < ctx->window) {
+        float a = cmnd[tau - 1], b = cmnd[tau], c = cmnd[tau + 1];
+        float den = a - 2.0f * b + c;
+        if (den > 0.0f) {
+            lag += CLAMP(0.5f * (a - c) / den, -0.5f, 0.5f);
+        }
+    }
+
+    result->frequency_hz = result->voiced ? (float)ctx->sample_rate / lag : 0.0f;
+}
+
+static __audio_hot void pitch_frame(struct audio_stft *stft, float *spec, void *user_data)
+{
+    struct pitch_ctx *ctx = (struct pitch_ctx *)user_data;
+    const size_t n = stft->config.fft_size;
+    const size_t w = ctx->window;
+    float *time = ctx->time;
+    float *cross = ctx->cross;
+
+    // A = FFT of the first W samples, zero-padded
+    float e0 = 0.0f;
+    for (size_t j = 0; j < w; j++) {
+        float x = (float)audio_stft_frame_sample(stft, j) / 32768.0f;
+        time[j] = x;
+        e0 += x * x;
+    }
+    memset(&time[w], 0, w * sizeof(float));
+    audio_fft_forward(stft->fft, time, cross);
+
+    // conj(A) * X in the packed layout
+    cross[0] *= spec[0];
+    cross[1] *= spec[1];
+    for (size_t k = 1; k < n / 2; k++) {
+        float ar = cross[2 * k], ai = cross[2 * k + 1];
+        float xr = spec[2 * k], xi = spec[2 * k + 1];
+        cross[2 * k] = ar * xr + ai * xi;
+        cross[2 * k + 1] = ar * xi - ai * xr;
+    }
+    audio_fft_inverse(stft->fft, cross, time);
+
+    // Difference function and its cumulative mean normalization
+    float energy = e0;
+    float running = 0.0f;
+
+    ctx->cmnd[0] = 1.0f;
+    for (size_t tau = 1; tau <= ctx->tau_max + 1 && tau <= w; tau++) {
+        float xo = (float)audio_stft_frame_sample(stft, tau - 1) / 32768.0f;
+        float xi = (float)audio_stft_frame_sample(stft, tau - 1 + w) / 32768.0f;
+        energy += xi * xi - xo * xo;
+
+        float d = MAX(e0 + energy - 2.0f * time[tau], 0.0f);
+        running += d;
+        ctx->cmnd[tau] = running > 0.0f ? d * (float)tau / running : 1.0f;
+    }
+
+    struct pitch_result result;
+    pitch_estimate(ctx, &result);
+    pitch_publish(ctx, &result);
+}
+
+static struct audio_block* pitch_process(struct audio_node *self, struct audio_block *in)
+{
+    if (!in) {
+        return NULL;
+    }
+
+    struct pitch_ctx *ctx = (struct pitch_ctx *)self->ctx;
+
+    audio_stft_process(&ctx->stft, in->data, in->data_len);
+    return in;
+}
+
+/* Sizes the frame for min_hz at the current rate and (re)starts the STFT */
+static int pitch_configure(struct pitch_ctx *ctx)
+{
+    const struct pitch_config *cfg = &ctx->config;
+    size_t tau_max = (size_t)ceilf((float)ctx->sample_rate / cfg->min_hz);
+    size_t tau_min = MAX((size_t)floorf((float)ctx->sample_rate / cfg->max_hz), 2U);
+
+    // One lag beyond tau_max for the interpolation
+    size_t w = 1U << LOG2CEIL(tau_max + 2);
+    size_t n = 2 * w;
+
+    if (n > PITCH_MAX_N || tau_min >= tau_max) {
+        return -EINVAL;
+    }
+
+    struct audio_stft_config stft_config = {
+        .fft_size = n,
+        .hop_size = cfg->hop_size ? MIN(cfg->hop_size, n) : n,
+        .analysis_only = true,
+        .frame = pitch_frame,
+        .user_data = ctx,
+    };
+
+    int ret = audio_stft_init(&ctx->stft, &stft_config);
+    if (ret) {
+        return ret;
+    }
+
+    // YIN correlates raw samples
+    for (size_t i = 0; i < n; i++) {
+        ctx->stft.window[i] = 1.0f;
+    }
+
+    ctx->window = w;
+    ctx->tau_min = tau_min;
+    ctx->tau_max = tau_max;
+    return 0;
+}
+
+static void pitch_reset(struct audio_node *self)
+{
+    struct pitch_ctx *ctx = (struct pitch_ctx *)self->ctx;
+
+    audio_stft_reset(&ctx->stft);
+}
+
+/**
+ * @brief Sample rate change: lags and frame length follow the rate
+ */
+static void pitch_set_sample_rate(struct audio_node *self, uint32_t sample_rate)
+{
+    struct pitch_ctx *ctx = (struct pitch_ctx *)self->ctx;
+    uint32_t old_rate = ctx->sample_rate;
+
+    ctx->sample_rate = sample_rate;
+    if (pitch_configure(ctx)) {
+        // min_hz no longer fits the FFT at this rate: keep the old setup
+        ctx->sample_rate = old_rate;
+        pitch_configure(ctx);
+    }
+}
+
+static int pitch_set_param(struct audio_node *self, uint32_t id, float value, uint32_t ramp_samples)
+{
+    struct pitch_ctx *ctx = (struct pitch_ctx *)self->ctx;
+
+    switch (id) {
+    case NODE_PITCH_PARAM_THRESHOLD:
+        if (value <= 0.0f || value > 1.0f) {
+            return -EINVAL;
+        }
+        ctx->config.threshold = value;
+        return 0;
+    default:
+        return -EINVAL;
+    }
+}
+
+static int pitch_get_param(struct audio_node *self, uint32_t id, float *value)
+{
+    struct pitch_ctx *ctx = (struct pitch_ctx *)self->ctx;
+
+    switch (id) {
+    case NODE_PITCH_PARAM_THRESHOLD:
+        *value = ctx->config.threshold;
+        return 0;
+    default:
+        return -EINVAL;
+    }
+}
+
+static const struct audio_node_api pitch_api = {
+    .process = pitch_process,
+    .reset = pitch_reset,
+    .set_sample_rate = pitch_set_sample_rate,
+    .set_param = pitch_set_param,
+    .get_param = pitch_get_param,
+    .param_count = 1,
+};
+
+static struct pitch_ctx __audio_node_state pitch_contexts[CONFIG_AUDIO_PITCH_MAX_NODES];
+static size_t pitch_ctx_index = 0;
+
+int node_pitch_init(struct audio_node *node, const struct pitch_config *config)
+{
+    if (!node) {
+        return -EINVAL;
+    }
+
+    struct pitch_config cfg = PITCH_DEFAULT_CONFIG;
+    if (config) {
+        cfg = *config;
+    }
+
+    if (cfg.min_hz <= 0.0f || cfg.max_hz <= cfg.min_hz ||
+        cfg.threshold <= 0.0f || cfg.threshold > 1.0f ||
+        (cfg.hop_size && !IS_POWER_OF_TWO(cfg.hop_size))) {
+        return -EINVAL;
+    }
+
+    if (pitch_ctx_index >= ARRAY_SIZE(pitch_contexts)) {
+        return -ENOMEM;
+    }
+
+    struct pitch_ctx *ctx = &pitch_contexts[pitch_ctx_index];
+
+    ctx->config = cfg;
+    ctx->sample_rate = CONFIG_AUDIO_SAMPLE_RATE;
+
+    int ret = pitch_configure(ctx);
+    if (ret) {
+        return ret;
+    }
+
+    pitch_ctx_index++;
+    atomic_set(&ctx->seq, 0);
+    node->vtable = &pitch_api;
+    node->ctx = ctx;
+    return 0;
+}
+
+int node_pitch_get(struct audio_node *node, struct pitch_result *result)
+{
+    if (!node || !result || node->vtable != &pitch_api) {
+        return -EINVAL;
+    }
+
+    struct pitch_ctx *ctx = (struct pitch_ctx *)node->ctx;
+    atomic_val_t published, again;
+
+    do {
+        published = atomic_get(&ctx->seq) / 2;
+        if (published == 0) {
+            return -EAGAIN;
+        }
+
+        *result = ctx->slots[published & 1];
+        barrier_dmem_fence_full();
+        again = atomic_get(&ctx->seq);
+        // Torn only if the writer started on this slot again (estimate + 2)
+    } while (again > 2 * published + 2);
+
+    return 0;
+}
@@ -7,13 +7,13 @@ struct sine_ctx {
     float amplitude;
 };
 
-void sine_process(struct audio_node *self) {
+__audio_hot void sine_process(struct audio_node *self) {
     struct sine_ctx *ctx = (struct sine_ctx *)self->ctx;
 
-    struct audio_block *block = audio_block_alloc();
+    /* Sleep until a consumer releases a block instead of polling */
+    struct audio_block *block = audio_block_alloc_timeout(K_FOREVER);
     
     if (!block) {
-        k_sleep(K_MSEC(1)); 
         return;
     }
 
@@ -15,6 +15,7 @@
  */
 struct sine_ctx {
     float frequency;     /**< Frequency in Hz */
+    uint32_t sample_rate; /**< Sample rate of the owning pipeline in Hz */
     float phase;         /**< Current phase (0 to 2π) */
     float phase_increment; /**< Phase increment per sample */
 };
@@ -22,7 +23,7 @@ struct sine_ctx {
 /**
  * @brief Sequential processing function for sine generator
  */
-static struct audio_block* sine_process(struct audio_node *self, struct audio_block *in)
+static __audio_hot struct audio_block* sine_process(struct audio_node *self, struct audio_block *in)
 {
     struct sine_ctx *ctx = (struct sine_ctx *)self->ctx;
 
@@ -65,12 +66,52 @@ static void sine_reset(struct audio_node *self)
     ctx->phase = 0.0f;
 }
 
+/**
+ * @brief Recompute the phase increment for a new pipeline rate
+ */
+static void sine_set_sample_rate(struct audio_node *self, uint32_t sample_rate)
+{
+    struct sine_ctx *ctx = (struct sine_ctx *)self->ctx;
+    ctx->sample_rate = sample_rate;
+    ctx->phase_increment = (2.0f * M_PI * ctx->frequency) / sample_rate;
+}
+
+static int sine_set_param(struct audio_node *self, uint32_t id, float value, uint32_t ramp_samples)
+{
+    struct sine_ctx *ctx = (struct sine_ctx *)self->ctx;
+
+    if (id != NODE_SINE_PARAM_FREQ || value <= 0.0f || value >= ctx->sample_rate / 2.0f) {
+        return -EINVAL;
+    }
+
+    // Phase stays continuous, so the change is click-free without a ramp
+    ctx->frequency = value;
+    sine_set_sample_rate(self, ctx->sample_rate);
+    return 0;
+}
+
+static int sine_get_param(struct audio_node *self, uint32_t id, float *value)
+{
+    struct sine_ctx *ctx = (struct sine_ctx *)self->ctx;
+
+    if (id != NODE_SINE_PARAM_FREQ) {
+        return -EINVAL;
+    }
+
+    *value = ctx->frequency;
+    return 0;
+}
+
 static const struct audio_node_api sine_api = {
     .process = sine_process,
     .reset = sine_reset,
+    .set_sample_rate = sine_set_sample_rate,
+    .set_param = sine_set_param,
+    .get_param = sine_get_param,
+    .param_count = 1,
 };
 
-static struct sine_ctx sine_contexts[4];  // Static allocation for up to 4 sine nodes
+static struct sine_ctx __audio_node_state sine_contexts[4];  // Static allocation for up to 4 sine nodes
 static size_t sine_ctx_index = 0;
 
 void node_sine_init(struct audio_node *node, float freq)
@@ -82,8 +123,10 @@ void node_sine_init(struct audio_node *node, float freq)
     struct sine_ctx *ctx = &sine_contexts[sine_ctx_index++];
     ctx->frequency = freq;
     ctx->phase = 0.0f;
-    ctx->phase_increment = (2.0f * M_PI * freq) / CONFIG_AUDIO_SAMPLE_RATE;
 
     node->vtable = &sine_api;
     node->ctx = ctx;
+
+    // Default rate until a strip propagates its own
+    sine_set_sample_rate(node, CONFIG_AUDIO_SAMPLE_RATE);
 }
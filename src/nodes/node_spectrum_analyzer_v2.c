@@ -1,68 +1,30 @@
 /**
  * @file node_spectrum_analyzer_v2.c
- * @brief Production-Ready Spectrum Analyzer with CMSIS-DSP Support
+ * @brief Production-Ready Spectrum Analyzer on the shared FFT
  *
  * Features:
- * - CMSIS-DSP FFT on ARM platforms (optimized)
- * - Fallback to basic implementation on other platforms
+ * - Analysis-only audio_stft on shared FFT plans (CMSIS-DSP on ARM)
  * - Configurable FFT size, window type, hop size
  * - Multiple output formats (magnitude, dB, phase)
+ * - Optional classifier features into a zero-copy frame ring
  */
 
 #include "audio_fw_v2.h"
+#include "audio_stft.h"
+#if defined(CONFIG_AUDIO_SPECTRUM_FEATURES)
+#include "audio_features.h"
+#endif
 #include <string.h>
 #include <math.h>
 
-// Platform detection
-#if defined(__ARM_ARCH) || defined(__arm__) || defined(__ARM_EABI__)
-    #define PLATFORM_ARM 1
-    #include <arm_math.h>  // CMSIS-DSP
-    #include <arm_const_structs.h>
-#else
-    #define PLATFORM_ARM 0
-#endif
-
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
-/**
- * @brief Window function types
- */
-enum spectrum_window_type {
-    SPECTRUM_WINDOW_RECTANGULAR,  // No window (for transient analysis)
-    SPECTRUM_WINDOW_HANN,         // Hann window (good general purpose)
-    SPECTRUM_WINDOW_HAMMING,      // Hamming window (slightly better sidelobe)
-    SPECTRUM_WINDOW_BLACKMAN,     // Blackman window (best sidelobe suppression)
-    SPECTRUM_WINDOW_FLAT_TOP,     // Flat-top (best amplitude accuracy)
-};
-
-/**
- * @brief Configuration for spectrum analyzer
- */
-struct spectrum_analyzer_config {
-    size_t fft_size;                    // FFT size (must be power of 2)
-    size_t hop_size;                    // Hop size (0 = non-overlapping)
-    enum spectrum_window_type window;    // Window function type
-    bool compute_phase;                  // Whether to compute phase spectrum
-    float magnitude_floor_db;            // Floor for magnitude in dB (-inf if 0)
-};
-
-/**
- * @brief Default configuration: 1024 FFT, Hann window, no overlap
- */
-#define SPECTRUM_ANALYZER_DEFAULT_CONFIG {      \
-    .fft_size = 1024,                           \
-    .hop_size = 0,                              \
-    .window = SPECTRUM_WINDOW_HANN,             \
-    .compute_phase = false,                     \
-    .magnitude_floor_db = -120.0f,              \
-}
-
 /**
  * @brief Maximum supported FFT size
  */
-#define MAX_FFT_SIZE 2048
+#define MAX_FFT_SIZE CONFIG_AUDIO_FFT_MAX_SIZE
 
 /**
  * @brief Spectrum analyzer context
@@ -70,31 +32,21 @@ struct spectrum_analyzer_config {
 struct spectrum_analyzer_ctx {
     // Configuration
     struct spectrum_analyzer_config config;
+    uint32_t sample_rate;  // Rate of the owning pipeline in Hz
 
-    // Accumulation buffer
-    int16_t sample_buffer[MAX_FFT_SIZE];
-    size_t buffer_pos;
-    size_t samples_accumulated;
-
-#if PLATFORM_ARM
-    // CMSIS-DSP specific
-    arm_rfft_fast_instance_f32 fft_instance;
-    float32_t fft_input[MAX_FFT_SIZE];
-    float32_t fft_output[MAX_FFT_SIZE];
-#else
-    // Generic fallback
-    float fft_input[MAX_FFT_SIZE];
-    float fft_output[MAX_FFT_SIZE * 2];  // Complex output (real, imag pairs)
-#endif
-
-    // Window function
-    float window[MAX_FFT_SIZE];
+    // Analysis-only STFT: sample ring, window, FFT buffers
+    struct audio_stft stft;
 
     // Output spectra
     float magnitude_spectrum[MAX_FFT_SIZE / 2];
     float phase_spectrum[MAX_FFT_SIZE / 2];  // Only if compute_phase enabled
     bool spectrum_ready;
 
+#if defined(CONFIG_AUDIO_SPECTRUM_FEATURES)
+    // Classifier features, computed from magnitude_spectrum
+    struct audio_features features;
+#endif
+
     // Statistics
     uint32_t process_count;
     float peak_frequency;
@@ -163,84 +115,31 @@ static void generate_window(float *window,
     }
 }
 
-#if PLATFORM_ARM
-/**
- * @brief Compute FFT using CMSIS-DSP (ARM optimized)
- */
-static void compute_fft_cmsis(struct spectrum_analyzer_ctx *ctx)
-{
-    size_t fft_size = ctx->config.fft_size;
-
-    // Convert int16 to float and apply window
-    for (size_t i = 0; i < fft_size; i++) {
-        float sample = (float)ctx->sample_buffer[i] / 32768.0f;
-        ctx->fft_input[i] = sample * ctx->window[i];
-    }
-
-    // Perform real FFT (optimized for real input)
-    arm_rfft_fast_f32(&ctx->fft_instance, ctx->fft_input, ctx->fft_output, 0);
-
-    // Compute magnitude (and phase if requested)
-    size_t num_bins = fft_size / 2;
-
-    for (size_t i = 0; i < num_bins; i++) {
-        float real = ctx->fft_output[i * 2];
-        float imag = ctx->fft_output[i * 2 + 1];
-
-        // Magnitude
-        arm_sqrt_f32(real * real + imag * imag, &ctx->magnitude_spectrum[i]);
-
-        // Normalize by FFT size
-        ctx->magnitude_spectrum[i] /= (float)fft_size;
-
-        // Phase (if requested)
-        if (ctx->config.compute_phase) {
-            ctx->phase_spectrum[i] = atan2f(imag, real);
-        }
-    }
-
-    // Find peak
-    uint32_t peak_index;
-    arm_max_f32(&ctx->magnitude_spectrum[1], num_bins - 1, &ctx->peak_magnitude, &peak_index);
-    peak_index += 1;  // Offset for skipping DC bin
-    ctx->peak_frequency = (float)peak_index * CONFIG_AUDIO_SAMPLE_RATE / (float)fft_size;
-}
-
-#else
-
 /**
- * @brief Naive DFT implementation (fallback for non-ARM platforms)
- *
- * WARNING: This is VERY slow - only for testing on non-ARM platforms!
- * In production on x86/other, use: FFTW, KissFFT, or pffft
+ * @brief STFT frame callback: magnitude/phase spectra and peak
  */
-static void compute_fft_naive(struct spectrum_analyzer_ctx *ctx)
+static __audio_hot void spectrum_frame(struct audio_stft *stft, float *spec, void *user_data)
 {
+    struct spectrum_analyzer_ctx *ctx = (struct spectrum_analyzer_ctx *)user_data;
     size_t fft_size = ctx->config.fft_size;
     size_t num_bins = fft_size / 2;
 
-    // Apply window and convert to float
-    for (size_t i = 0; i < fft_size; i++) {
-        ctx->fft_input[i] = ((float)ctx->sample_buffer[i] / 32768.0f) * ctx->window[i];
+    // DC is purely real (spec[1] holds Nyquist, which is not reported)
+    ctx->magnitude_spectrum[0] = fabsf(spec[0]) / (float)fft_size;
+    if (ctx->config.compute_phase) {
+        ctx->phase_spectrum[0] = (spec[0] < 0.0f) ? (float)M_PI : 0.0f;
     }
 
-    // Naive DFT: X[k] = Σ x[n] * e^(-j*2π*k*n/N)
-    for (size_t k = 0; k < num_bins; k++) {
-        float real_sum = 0.0f;
-        float imag_sum = 0.0f;
-
-        for (size_t n = 0; n < fft_size; n++) {
-            float angle = -2.0f * M_PI * k * n / fft_size;
-            real_sum += ctx->fft_input[n] * cosf(angle);
-            imag_sum += ctx->fft_input[n] * sinf(angle);
-        }
+    for (size_t i = 1; i < num_bins; i++) {
+        float real = spec[i * 2];
+        float imag = spec[i * 2 + 1];
 
-        // Magnitude
-        ctx->magnitude_spectrum[k] = sqrtf(real_sum * real_sum + imag_sum * imag_sum) / fft_size;
+        // Magnitude, normalized by FFT size
+        ctx->magnitude_spectrum[i] = sqrtf(real * real + imag * imag) / (float)fft_size;
 
         // Phase (if requested)
         if (ctx->config.compute_phase) {
-            ctx->phase_spectrum[k] = atan2f(imag_sum, real_sum);
+            ctx->phase_spectrum[i] = atan2f(imag, real);
         }
     }
 
@@ -253,11 +152,18 @@ static void compute_fft_naive(struct spectrum_analyzer_ctx *ctx)
             peak_index = i;
         }
     }
-    ctx->peak_frequency = (float)peak_index * CONFIG_AUDIO_SAMPLE_RATE / (float)fft_size;
-}
+    ctx->peak_frequency = (float)peak_index * ctx->sample_rate / (float)fft_size;
 
+#if defined(CONFIG_AUDIO_SPECTRUM_FEATURES)
+    if (ctx->config.compute_features) {
+        audio_features_compute(&ctx->features, ctx->magnitude_spectrum);
+    }
 #endif
 
+    ctx->spectrum_ready = true;
+    ctx->process_count++;
+}
+
 /**
  * @brief Process function for spectrum analyzer
  */
@@ -269,48 +175,9 @@ static struct audio_block* spectrum_analyzer_process(struct audio_node *self,
     }
 
     struct spectrum_analyzer_ctx *ctx = (struct spectrum_analyzer_ctx *)self->ctx;
-    size_t fft_size = ctx->config.fft_size;
-    size_t hop_size = ctx->config.hop_size ? ctx->config.hop_size : fft_size;
-
-    // Accumulate samples
-    size_t samples_to_copy = in->data_len;
-    size_t space_available = fft_size - ctx->buffer_pos;
-
-    if (samples_to_copy > space_available) {
-        samples_to_copy = space_available;
-    }
 
-    memcpy(&ctx->sample_buffer[ctx->buffer_pos],
-           in->data,
-           samples_to_copy * sizeof(int16_t));
-
-    ctx->buffer_pos += samples_to_copy;
-    ctx->samples_accumulated += samples_to_copy;
-
-    // Check if we have enough samples to process
-    if (ctx->buffer_pos >= fft_size) {
-        // Compute FFT (platform-specific)
-#if PLATFORM_ARM
-        compute_fft_cmsis(ctx);
-#else
-        compute_fft_naive(ctx);
-#endif
-
-        ctx->spectrum_ready = true;
-        ctx->process_count++;
-
-        // Handle hop size (overlap)
-        if (hop_size < fft_size) {
-            // Slide buffer left by hop_size
-            memmove(ctx->sample_buffer,
-                    &ctx->sample_buffer[hop_size],
-                    (fft_size - hop_size) * sizeof(int16_t));
-            ctx->buffer_pos = fft_size - hop_size;
-        } else {
-            // Non-overlapping: reset buffer
-            ctx->buffer_pos = 0;
-        }
-    }
+    // Frames fire every hop once fft_size samples have been seen
+    audio_stft_process(&ctx->stft, in->data, in->data_len);
 
     // Pass through
     return in;
@@ -323,21 +190,47 @@ static void spectrum_analyzer_reset(struct audio_node *self)
 {
     struct spectrum_analyzer_ctx *ctx = (struct spectrum_analyzer_ctx *)self->ctx;
 
-    ctx->buffer_pos = 0;
-    ctx->samples_accumulated = 0;
+    audio_stft_reset(&ctx->stft);
     ctx->spectrum_ready = false;
     ctx->process_count = 0;
     ctx->peak_frequency = 0.0f;
     ctx->peak_magnitude = 0.0f;
 
-    memset(ctx->sample_buffer, 0, sizeof(ctx->sample_buffer));
     memset(ctx->magnitude_spectrum, 0, sizeof(ctx->magnitude_spectrum));
     memset(ctx->phase_spectrum, 0, sizeof(ctx->phase_spectrum));
+
+#if defined(CONFIG_AUDIO_SPECTRUM_FEATURES)
+    // Flux must not compare the next frame against the pre-reset spectrum
+    if (ctx->config.compute_features) {
+        audio_features_reset(&ctx->features);
+    }
+#endif
+}
+
+/**
+ * @brief Sample rate change: bin frequencies follow the pipeline rate
+ */
+static void spectrum_analyzer_set_sample_rate(struct audio_node *self, uint32_t sample_rate)
+{
+    struct spectrum_analyzer_ctx *ctx = (struct spectrum_analyzer_ctx *)self->ctx;
+
+    ctx->sample_rate = sample_rate;
+
+#if defined(CONFIG_AUDIO_SPECTRUM_FEATURES)
+    // Mel bands are fixed in Hz
+    if (ctx->config.compute_features) {
+        audio_features_init(&ctx->features, ctx->config.fft_size, sample_rate);
+    }
+#endif
+
+    // Spectra computed at the old rate are meaningless now
+    spectrum_analyzer_reset(self);
 }
 
 static const struct audio_node_api spectrum_analyzer_api = {
     .process = spectrum_analyzer_process,
     .reset = spectrum_analyzer_reset,
+    .set_sample_rate = spectrum_analyzer_set_sample_rate,
 };
 
 // Static allocation for up to 4 spectrum analyzer nodes
@@ -371,6 +264,12 @@ int node_spectrum_analyzer_init_ex(struct audio_node *node,
     // Validate FFT size
     size_t fft_size = ctx->config.fft_size;
 
+#if !defined(CONFIG_AUDIO_SPECTRUM_FEATURES)
+    if (ctx->config.compute_features) {
+        return -ENOTSUP;  // Features not built in
+    }
+#endif
+
     if (fft_size > MAX_FFT_SIZE) {
         return -EINVAL;  // FFT size too large
     }
@@ -379,40 +278,33 @@ int node_spectrum_analyzer_init_ex(struct audio_node *node,
         return -EINVAL;  // FFT size not power of 2
     }
 
-    // Initialize CMSIS-DSP on ARM
-#if PLATFORM_ARM
-    arm_status status;
-
-    // Initialize real FFT instance
-    switch (fft_size) {
-        case 32:
-        case 64:
-        case 128:
-        case 256:
-        case 512:
-        case 1024:
-        case 2048:
-        case 4096:
-            status = arm_rfft_fast_init_f32(&ctx->fft_instance, fft_size);
-            if (status != ARM_MATH_SUCCESS) {
-                return -EINVAL;
-            }
-            break;
-        default:
-            return -EINVAL;  // Unsupported FFT size for CMSIS
+    // Analysis-only STFT on the shared plan for this size
+    struct audio_stft_config stft_config = {
+        .fft_size = fft_size,
+        .hop_size = ctx->config.hop_size ? ctx->config.hop_size : fft_size,
+        .analysis_only = true,
+        .frame = spectrum_frame,
+        .user_data = ctx,
+    };
+
+    if (audio_stft_init(&ctx->stft, &stft_config)) {
+        return -EINVAL;  // Unsupported FFT or hop size
     }
-#endif
 
-    // Generate window function
-    generate_window(ctx->window, fft_size, ctx->config.window);
+    // Replace the default sqrt-Hann with the configured analysis window
+    generate_window(ctx->stft.window, fft_size, ctx->config.window);
 
     // Initialize state
-    ctx->buffer_pos = 0;
-    ctx->samples_accumulated = 0;
+    ctx->sample_rate = CONFIG_AUDIO_SAMPLE_RATE;
+
+#if defined(CONFIG_AUDIO_SPECTRUM_FEATURES)
+    if (ctx->config.compute_features) {
+        audio_features_init(&ctx->features, fft_size, ctx->sample_rate);
+    }
+#endif
     ctx->spectrum_ready = false;
     ctx->process_count = 0;
 
-    memset(ctx->sample_buffer, 0, sizeof(ctx->sample_buffer));
     memset(ctx->magnitude_spectrum, 0, sizeof(ctx->magnitude_spectrum));
     memset(ctx->phase_spectrum, 0, sizeof(ctx->phase_spectrum));
 
@@ -574,3 +466,67 @@ uint32_t node_spectrum_analyzer_get_process_count(struct audio_node *node)
     struct spectrum_analyzer_ctx *ctx = (struct spectrum_analyzer_ctx *)node->ctx;
     return ctx->process_count;
 }
+
+/**
+ * @brief Borrow the oldest feature frame
+ */
+int node_spectrum_analyzer_get_features(struct audio_node *node,
+                                        const struct audio_feature_frame **frame)
+{
+    if (!node || !node->ctx || !frame) {
+        return -EINVAL;
+    }
+
+#if defined(CONFIG_AUDIO_SPECTRUM_FEATURES)
+    struct spectrum_analyzer_ctx *ctx = (struct spectrum_analyzer_ctx *)node->ctx;
+
+    if (!ctx->config.compute_features) {
+        return -ENOTSUP;
+    }
+
+    return audio_features_get(&ctx->features, frame);
+#else
+    return -ENOTSUP;
+#endif
+}
+
+/**
+ * @brief Return a borrowed feature frame
+ */
+int node_spectrum_analyzer_release_features(struct audio_node *node)
+{
+    if (!node || !node->ctx) {
+        return -EINVAL;
+    }
+
+#if defined(CONFIG_AUDIO_SPECTRUM_FEATURES)
+    struct spectrum_analyzer_ctx *ctx = (struct spectrum_analyzer_ctx *)node->ctx;
+
+    if (!ctx->config.compute_features) {
+        return -ENOTSUP;
+    }
+
+    audio_features_release(&ctx->features);
+    return 0;
+#else
+    return -ENOTSUP;
+#endif
+}
+
+/**
+ * @brief Get number of dropped feature frames
+ */
+uint32_t node_spectrum_analyzer_get_features_dropped(struct audio_node *node)
+{
+    if (!node || !node->ctx) {
+        return 0;
+    }
+
+#if defined(CONFIG_AUDIO_SPECTRUM_FEATURES)
+    struct spectrum_analyzer_ctx *ctx = (struct spectrum_analyzer_ctx *)node->ctx;
+
+    return audio_features_dropped(&ctx->features);
+#else
+    return 0;
+#endif
+}
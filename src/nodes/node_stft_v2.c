@@ -0,0 +1,61 @@
+/**
+ * @file node_stft_v2.c
+ * @brief Generic STFT node - Sequential Processing Version
+ *
+ * Wraps an audio_stft with a user callback, for spectral effects that need
+ * nothing beyond the per-frame hook.
+ */
+
+#include "audio_stft.h"
+
+static struct audio_block* stft_node_process(struct audio_node *self, struct audio_block *in)
+{
+    if (!in) {
+        return NULL;
+    }
+
+    audio_stft_process((struct audio_stft *)self->ctx, in->data, in->data_len);
+    return in;
+}
+
+static void stft_node_reset(struct audio_node *self)
+{
+    audio_stft_reset((struct audio_stft *)self->ctx);
+}
+
+static const struct audio_node_api stft_node_api = {
+    .process = stft_node_process,
+    .reset = stft_node_reset,
+};
+
+static struct audio_stft __audio_node_state stft_contexts[CONFIG_AUDIO_STFT_MAX_NODES];
+static size_t stft_ctx_index = 0;
+
+int node_stft_init(struct audio_node *node, const struct audio_stft_config *config)
+{
+    if (!node) {
+        return -EINVAL;
+    }
+
+    if (stft_ctx_index >= ARRAY_SIZE(stft_contexts)) {
+        return -ENOMEM;
+    }
+
+    int ret = audio_stft_init(&stft_contexts[stft_ctx_index], config);
+    if (ret) {
+        return ret;
+    }
+
+    node->vtable = &stft_node_api;
+    node->ctx = &stft_contexts[stft_ctx_index++];
+    return 0;
+}
+
+struct audio_stft *node_stft_get(struct audio_node *node)
+{
+    if (!node || node->vtable != &stft_node_api) {
+        return NULL;
+    }
+
+    return (struct audio_stft *)node->ctx;
+}
@@ -6,7 +6,7 @@ struct vol_ctx {
     float factor;
 };
 
-void vol_process(struct audio_node *self) {
+__audio_hot void vol_process(struct audio_node *self) {
     struct vol_ctx *ctx = (struct vol_ctx *)self->ctx;
 
     struct audio_block *block = k_fifo_get(&self->in_fifo, K_FOREVER);
@@ -19,14 +19,19 @@ void vol_process(struct audio_node *self) {
         return;
     }
     
-    for (size_t i = 0; i < block->data_len; i++) {
-        float sample = (float)block->data[i];
-        sample = sample * ctx->factor;
+    /* Aligned, padded payload: process whole vectors, no scalar tail */
+    int16_t *data = AUDIO_BLOCK_ASSUME_ALIGNED(block->data);
+    size_t len = AUDIO_BLOCK_PADDED_LEN(block->data_len);
+    float factor = ctx->factor;
+
+    for (size_t i = 0; i < len; i++) {
+        float sample = (float)data[i];
+        sample = sample * factor;
         
         if (sample > 32767.0f) sample = 32767.0f;
         if (sample < -32768.0f) sample = -32768.0f;
 
-        block->data[i] = (int16_t)sample;
+        data[i] = (int16_t)sample;
     }
 
     audio_node_push_output(self, block);
@@ -11,12 +11,15 @@
  */
 struct volume_ctx {
     float factor;  /**< Volume multiplication factor */
+    float target;  /**< Factor at the end of the running ramp */
+    float step;    /**< Per-sample factor increment while ramping */
+    uint32_t ramp_remaining; /**< Samples left in the ramp */
 };
 
 /**
  * @brief Sequential processing function for volume node
  */
-static struct audio_block* vol_process(struct audio_node *self, struct audio_block *in)
+static __audio_hot struct audio_block* vol_process(struct audio_node *self, struct audio_block *in)
 {
     if (!in) {
         return NULL;  // Volume node requires input
@@ -24,35 +27,99 @@ static struct audio_block* vol_process(struct audio_node *self, struct audio_blo
 
     struct volume_ctx *ctx = (struct volume_ctx *)self->ctx;
 
-    // Modify samples in-place (no CoW needed in sequential mode)
-    for (size_t i = 0; i < in->data_len; i++) {
-        float sample = (float)in->data[i];
-        sample = sample * ctx->factor;
+    // Modify samples in-place (no CoW needed in sequential mode).
+    // Payloads are block-aligned and padded, so run whole vectors.
+    int16_t *data = AUDIO_BLOCK_ASSUME_ALIGNED(in->data);
+    size_t len = AUDIO_BLOCK_PADDED_LEN(in->data_len);
+    size_t start = 0;
+
+    // Ramp part: per-sample factor, then the constant-gain vector loop
+    if (ctx->ramp_remaining) {
+        size_t ramp = MIN(in->data_len, ctx->ramp_remaining);
+        float factor = ctx->factor;
+
+        for (; start < ramp; start++) {
+            factor += ctx->step;
+            float sample = (float)data[start] * factor;
+
+            if (sample > INT16_MAX) sample = INT16_MAX;
+            if (sample < INT16_MIN) sample = INT16_MIN;
+
+            data[start] = (int16_t)sample;
+        }
+
+        ctx->ramp_remaining -= ramp;
+        ctx->factor = ctx->ramp_remaining ? factor : ctx->target;
+    }
+
+    float factor = ctx->factor;
+
+    for (size_t i = start; i < len; i++) {
+        float sample = (float)data[i];
+        sample = sample * factor;
 
         // Clipping
         if (sample > INT16_MAX) sample = INT16_MAX;
         if (sample < INT16_MIN) sample = INT16_MIN;
 
-        in->data[i] = (int16_t)sample;
+        data[i] = (int16_t)sample;
     }
 
     return in;  // Return modified block
 }
 
 /**
- * @brief Reset function (nothing to reset for stateless volume)
+ * @brief Reset function: a running ramp jumps to its target
  */
 static void vol_reset(struct audio_node *self)
 {
-    // Volume node is stateless, nothing to reset
+    struct volume_ctx *ctx = (struct volume_ctx *)self->ctx;
+
+    ctx->factor = ctx->target;
+    ctx->step = 0.0f;
+    ctx->ramp_remaining = 0;
+}
+
+static int vol_set_param(struct audio_node *self, uint32_t id, float value, uint32_t ramp_samples)
+{
+    struct volume_ctx *ctx = (struct volume_ctx *)self->ctx;
+
+    if (id != NODE_VOL_PARAM_GAIN || value < 0.0f) {
+        return -EINVAL;
+    }
+
+    ctx->target = value;
+    if (ramp_samples == 0) {
+        ctx->factor = value;
+        ctx->ramp_remaining = 0;
+    } else {
+        ctx->step = (value - ctx->factor) / (float)ramp_samples;
+        ctx->ramp_remaining = ramp_samples;
+    }
+    return 0;
+}
+
+static int vol_get_param(struct audio_node *self, uint32_t id, float *value)
+{
+    struct volume_ctx *ctx = (struct volume_ctx *)self->ctx;
+
+    if (id != NODE_VOL_PARAM_GAIN) {
+        return -EINVAL;
+    }
+
+    *value = ctx->target;
+    return 0;
 }
 
 static const struct audio_node_api volume_api = {
     .process = vol_process,
     .reset = vol_reset,
+    .set_param = vol_set_param,
+    .get_param = vol_get_param,
+    .param_count = 1,
 };
 
-static struct volume_ctx volume_contexts[8];  // Static allocation for up to 8 volume nodes
+static struct volume_ctx __audio_node_state volume_contexts[8];  // Static allocation for up to 8 volume nodes
 static size_t volume_ctx_index = 0;
 
 void node_vol_init(struct audio_node *node, float vol)
@@ -65,6 +132,8 @@ void node_vol_init(struct audio_node *node, float vol)
 
     struct volume_ctx *ctx = &volume_contexts[volume_ctx_index++];
     ctx->factor = vol;
+    ctx->target = vol;
+    ctx->ramp_remaining = 0;
 
     node->vtable = &volume_api;
     node->ctx = ctx;
@@ -75,5 +144,7 @@ void node_vol_set(struct audio_node *node, float vol)
     struct volume_ctx *ctx = (struct volume_ctx *)node->ctx;
     if (ctx) {
         ctx->factor = vol;
+        ctx->target = vol;
+        ctx->ramp_remaining = 0;
     }
 }
@@ -0,0 +1,181 @@
+/**
+ * @file main.c
+ * @brief Echo canceller: convergence, double-talk freeze, reference path
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <audio_fw_v2.h>
+#include <math.h>
+
+#define RATE            CONFIG_AUDIO_SAMPLE_RATE
+#define BLOCK           CONFIG_AUDIO_BLOCK_SAMPLES
+#define ROOM_TAPS       600
+#define ROOM_DELAY      40
+
+/* Synthetic room: direct path delay, then an exponentially decaying tail */
+static float room[ROOM_TAPS];
+static float ref_hist[ROOM_TAPS];
+static uint32_t rng_state;
+static float lowpass;
+
+static struct audio_node aec, tap;
+
+static float noise(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (float)rng_state / 4294967296.0f * 2.0f - 1.0f;
+}
+
+/*
+ * Runs one block: reference through the tap, echo plus near_level of
+ * near-end noise into the canceller. Returns the residual echo energy
+ * (output minus near-end) and accumulates the echo energy in *echo_energy.
+ */
+static float run_block(float near_level, float *echo_energy) {
+    struct audio_block *ref = audio_block_alloc();
+    struct audio_block *mic = audio_block_alloc();
+    int16_t speaker[BLOCK];
+    float near[BLOCK];
+    float residual = 0.0f;
+
+    zassert_not_null(ref, "Pool exhausted");
+    zassert_not_null(mic, "Pool exhausted");
+
+    for (size_t i = 0; i < BLOCK; i++) {
+        lowpass = 0.7f * lowpass + 0.3f * noise();
+        speaker[i] = (int16_t)(lowpass * 12000.0f);
+        ref->data[i] = speaker[i];
+    }
+    ref->data_len = BLOCK;
+    audio_block_release(audio_node_process(&tap, ref));
+
+    for (size_t i = 0; i < BLOCK; i++) {
+        float echo = 0.0f;
+
+        memmove(&ref_hist[1], ref_hist, (ROOM_TAPS - 1) * sizeof(float));
+        ref_hist[0] = (float)speaker[i];
+        for (size_t k = ROOM_DELAY; k < ROOM_TAPS; k++) {
+            echo += room[k] * ref_hist[k];
+        }
+
+        near[i] = near_level * noise();
+        mic->data[i] = (int16_t)CLAMP(echo + near[i], INT16_MIN, INT16_MAX);
+        *echo_energy += echo * echo;
+    }
+    mic->data_len = BLOCK;
+
+    mic = audio_node_process(&aec, mic);
+    for (size_t i = 0; i < BLOCK; i++) {
+        float r = (float)mic->data[i] - near[i];
+        residual += r * r;
+    }
+    audio_block_release(mic);
+
+    return residual;
+}
+
+/* Runs echo-only blocks and returns the ERLE over them in dB */
+static float run_echo(size_t blocks) {
+    float echo = 0.0f, residual = 0.0f;
+
+    for (size_t b = 0; b < blocks; b++) {
+        residual += run_block(0.0f, &echo);
+    }
+    return 10.0f * log10f(echo / residual);
+}
+
+static void *setup(void) {
+    zassert_ok(node_aec_init(&aec, NULL), "AEC init failed");
+    zassert_ok(node_aec_ref_init(&tap, &aec), "Tap init failed");
+    return NULL;
+}
+
+static void before(void *f) {
+    rng_state = 2463534242u;
+    lowpass = 0.0f;
+    memset(ref_hist, 0, sizeof(ref_hist));
+    for (size_t k = ROOM_DELAY; k < ROOM_TAPS; k++) {
+        room[k] = 0.02f * noise() * expf(-(float)(k - ROOM_DELAY) / 150.0f);
+    }
+    audio_node_reset(&aec);
+}
+
+ZTEST_SUITE(aec, NULL, setup, before, NULL, NULL);
+
+ZTEST(aec, test_converges) {
+    struct aec_stats stats;
+
+    run_echo(3 * RATE / BLOCK);
+    float erle = run_echo(RATE / BLOCK);
+
+    zassert_ok(node_aec_get_stats(&aec, &stats), "Stats failed");
+    TC_PRINT("ERLE in the 4th second: %.1f dB (estimate %.1f dB)\n",
+             (double)erle, (double)stats.erle_db);
+
+    zassert_true(erle > 15.0f, "Echo not cancelled");
+    zassert_equal(stats.ref_underruns, 0, "Tap did not deliver the reference");
+    zassert_equal(stats.double_talk_partitions, 0, "Echo alone flagged as double talk");
+}
+
+ZTEST(aec, test_double_talk_freezes_adaptation) {
+    float echo = 0.0f;
+    struct aec_stats stats;
+
+    run_echo(3 * RATE / BLOCK);
+    float before_dt = run_echo(RATE / BLOCK);
+
+    /* One second of loud near-end talk on top of the echo */
+    for (size_t b = 0; b < RATE / BLOCK; b++) {
+        run_block(8000.0f, &echo);
+    }
+
+    zassert_ok(node_aec_get_stats(&aec, &stats), "Stats failed");
+    zassert_true(stats.double_talk_partitions > 0, "Double talk not detected");
+
+    /* A frozen filter cancels as well as before, right away */
+    float after_dt = run_echo(RATE / (4 * BLOCK));
+    TC_PRINT("ERLE before %.1f dB, right after double talk %.1f dB\n",
+             (double)before_dt, (double)after_dt);
+    zassert_true(after_dt > before_dt - 3.0f, "Filter diverged during double talk");
+}
+
+ZTEST(aec, test_missing_reference_counted) {
+    struct audio_block *mic = audio_block_alloc();
+    struct aec_stats stats;
+
+    zassert_not_null(mic, "Pool exhausted");
+    memset(mic->data, 0, BLOCK * sizeof(int16_t));
+    mic->data_len = BLOCK;
+    audio_block_release(audio_node_process(&aec, mic));
+
+    zassert_ok(node_aec_get_stats(&aec, &stats), "Stats failed");
+    zassert_equal(stats.ref_underruns, BLOCK / CONFIG_AUDIO_AEC_PARTITION_SAMPLES,
+                  "Underruns not counted per partition");
+}
+
+ZTEST(aec, test_params) {
+    float value;
+
+    zassert_ok(audio_node_set_param(&aec, NODE_AEC_PARAM_STEP, 0.25f, 0), "Step rejected");
+    zassert_ok(audio_node_get_param(&aec, NODE_AEC_PARAM_STEP, &value), "Step read failed");
+    zassert_equal(value, 0.25f, "Step not stored");
+    zassert_equal(audio_node_set_param(&aec, NODE_AEC_PARAM_STEP, 2.0f, 0), -EINVAL,
+                  "Unstable step accepted");
+    zassert_equal(audio_node_set_param(&aec, NODE_AEC_PARAM_DT_THRESHOLD, 0.0f, 0), -EINVAL,
+                  "Zero threshold accepted");
+    zassert_ok(audio_node_set_param(&aec, NODE_AEC_PARAM_STEP, 0.5f, 0), "Step reset failed");
+}
+
+ZTEST(aec, test_init_rejects_bad_config) {
+    struct aec_config config = AEC_DEFAULT_CONFIG;
+    struct audio_node node;
+
+    config.step_size = 2.0f;
+    zassert_equal(node_aec_init(&node, &config), -EINVAL, "Unstable step accepted");
+
+    config.step_size = 0.5f;
+    config.dt_threshold = 0.0f;
+    zassert_equal(node_aec_init(&node, &config), -EINVAL, "Zero threshold accepted");
+}
@@ -0,0 +1,95 @@
+/**
+ * @file main.c
+ * @brief Blocking allocation, release wakeups and waiter ordering
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <audio_fw.h>
+
+#define POOL        CONFIG_AUDIO_MEM_SLAB_COUNT
+#define STACK_SIZE  1024
+
+K_THREAD_STACK_DEFINE(low_stack, STACK_SIZE);
+K_THREAD_STACK_DEFINE(high_stack, STACK_SIZE);
+static struct k_thread low_thread;
+static struct k_thread high_thread;
+
+static struct audio_block *held[POOL];
+static struct audio_block *got[2];
+static atomic_t served;
+static int order[2];
+
+static void exhaust(void) {
+    for (int i = 0; i < POOL; i++) {
+        held[i] = audio_block_alloc();
+        zassert_not_null(held[i], "Pool smaller than expected");
+    }
+    zassert_is_null(audio_block_alloc(), "Pool not exhausted");
+}
+
+static void release_held(int from) {
+    for (int i = from; i < POOL; i++) {
+        audio_block_release(held[i]);
+    }
+}
+
+static void waiter(void *p1, void *p2, void *p3) {
+    int id = (int)(intptr_t)p1;
+
+    got[id] = audio_block_alloc_timeout(K_FOREVER);
+    order[atomic_inc(&served)] = id;
+}
+
+ZTEST_SUITE(alloc_wait, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(alloc_wait, test_timeout_is_accounted) {
+    struct audio_alloc_wait_stats before, after;
+
+    audio_block_wait_stats_get(&before);
+    exhaust();
+
+    zassert_is_null(audio_block_alloc_timeout(K_MSEC(10)), "Alloc from empty pool");
+
+    audio_block_wait_stats_get(&after);
+    zassert_equal(after.waits, before.waits + 1, "Wait not counted");
+    zassert_equal(after.timeouts, before.timeouts + 1, "Timeout not counted");
+    zassert_true(after.total_wait_us - before.total_wait_us >= 9000, "Wait time too short");
+
+    release_held(0);
+}
+
+ZTEST(alloc_wait, test_higher_priority_waiter_served_first) {
+    int prio = k_thread_priority_get(k_current_get());
+
+    exhaust();
+    atomic_clear(&served);
+
+    /* The low-priority waiter blocks first; a FIFO wait queue would serve it first */
+    k_thread_create(&low_thread, low_stack, STACK_SIZE, waiter, (void *)0, NULL, NULL,
+                    prio + 2, 0, K_NO_WAIT);
+    k_msleep(10);
+    zassert_equal(atomic_get(&served), 0, "Low-priority waiter did not block");
+
+    k_thread_create(&high_thread, high_stack, STACK_SIZE, waiter, (void *)1, NULL, NULL,
+                    prio + 1, 0, K_NO_WAIT);
+    k_msleep(10);
+    zassert_equal(atomic_get(&served), 0, "High-priority waiter did not block");
+
+    audio_block_release(held[0]);
+    k_msleep(10);
+    zassert_equal(atomic_get(&served), 1, "Release did not wake a waiter");
+    zassert_equal(order[0], 1, "Low-priority waiter served first");
+
+    audio_block_release(held[1]);
+    k_msleep(10);
+    zassert_equal(atomic_get(&served), 2, "Second waiter not woken");
+    zassert_equal(order[1], 0, "Wrong second waiter");
+
+    k_thread_join(&low_thread, K_FOREVER);
+    k_thread_join(&high_thread, K_FOREVER);
+
+    audio_block_release(got[0]);
+    audio_block_release(got[1]);
+    release_held(2);
+}
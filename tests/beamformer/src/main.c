@@ -0,0 +1,245 @@
+/**
+ * @file main.c
+ * @brief Beamformer: steering, fractional delays and runtime updates
+ *
+ * A linear array of four mics 40 mm apart along x picks up a plane wave
+ * from a settable azimuth. The node runs two beams; each output block
+ * carries both, interleaved.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <audio_fw_v2.h>
+#include <math.h>
+
+#define RATE            CONFIG_AUDIO_SAMPLE_RATE
+#define BLOCK           CONFIG_AUDIO_BLOCK_SAMPLES
+#define MICS            4
+#define BEAMS           2
+#define FRAMES          (BLOCK / MICS)
+#define SETTLE_BLOCKS   4
+#define MEASURE_BLOCKS  16
+#define WAVE_HZ         4000.0f
+#define WAVE_LEVEL      10000.0f
+#define SPEED_OF_SOUND  343.0f
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static struct audio_node beamformer;
+static const struct beamformer_config config = {
+    .mics = MICS,
+    .beams = BEAMS,
+    .positions = { { -60.0f, 0.0f }, { -20.0f, 0.0f }, { 20.0f, 0.0f }, { 60.0f, 0.0f } },
+};
+
+static uint32_t frame_index;
+
+/* Plane wave from azimuth_deg; mics further along it hear it earlier */
+static struct audio_block *wave_block(float azimuth_deg) {
+    struct audio_block *block = audio_block_alloc();
+    const float w = 2.0f * (float)M_PI * WAVE_HZ;
+    const float ux = cosf(azimuth_deg * (float)M_PI / 180.0f);
+
+    zassert_not_null(block, "Pool exhausted");
+    for (size_t n = 0; n < FRAMES; n++, frame_index++) {
+        for (size_t m = 0; m < MICS; m++) {
+            float lead = config.positions[m].x_mm * ux / (1000.0f * SPEED_OF_SOUND);
+            float t = (float)(frame_index % RATE) / RATE + lead;
+
+            block->data[n * MICS + m] = (int16_t)(WAVE_LEVEL * sinf(w * t));
+        }
+    }
+    block->data_len = FRAMES * MICS;
+    return block;
+}
+
+/* Output RMS of each beam for a wave from azimuth_deg */
+static void measure(float azimuth_deg, float rms[BEAMS]) {
+    float energy[BEAMS] = { 0 };
+
+    for (size_t b = 0; b < SETTLE_BLOCKS + MEASURE_BLOCKS; b++) {
+        struct audio_block *out = audio_node_process(&beamformer, wave_block(azimuth_deg));
+
+        zassert_equal(out->data_len, FRAMES * BEAMS, "Expected %d interleaved beam samples",
+                      FRAMES * BEAMS);
+        if (b >= SETTLE_BLOCKS) {
+            for (size_t i = 0; i < out->data_len; i++) {
+                energy[i % BEAMS] += (float)out->data[i] * out->data[i];
+            }
+        }
+        audio_block_release(out);
+    }
+
+    for (size_t beam = 0; beam < BEAMS; beam++) {
+        rms[beam] = sqrtf(energy[beam] / (MEASURE_BLOCKS * FRAMES));
+    }
+}
+
+/* Beam 0 RMS of one block of a wave from azimuth_deg */
+static float block_rms(float azimuth_deg) {
+    struct audio_block *out = audio_node_process(&beamformer, wave_block(azimuth_deg));
+    float energy = 0.0f;
+
+    for (size_t n = 0; n < FRAMES; n++) {
+        energy += (float)out->data[n * BEAMS] * out->data[n * BEAMS];
+    }
+    audio_block_release(out);
+    return sqrtf(energy / FRAMES);
+}
+
+/* Feeds one block with an impulse on mic 0 at frame at (or silence), returns beam 0 */
+static void impulse_block(int at, int16_t beam0[FRAMES]) {
+    struct audio_block *block = audio_block_alloc();
+
+    zassert_not_null(block, "Pool exhausted");
+    memset(block->data, 0, BLOCK * sizeof(int16_t));
+    if (at >= 0) {
+        block->data[at * MICS] = 16000;
+    }
+    block->data_len = FRAMES * MICS;
+
+    block = audio_node_process(&beamformer, block);
+    for (size_t n = 0; n < FRAMES; n++) {
+        beam0[n] = block->data[n * BEAMS];
+    }
+    audio_block_release(block);
+}
+
+static void *setup(void) {
+    zassert_ok(node_beamformer_init(&beamformer, &config), "Init failed");
+    return NULL;
+}
+
+static void before(void *fixture) {
+    audio_node_reset(&beamformer);
+    frame_index = 0;
+}
+
+ZTEST_SUITE(beamformer, NULL, setup, before, NULL, NULL);
+
+ZTEST(beamformer, test_steered_beams) {
+    float rms[BEAMS];
+
+    zassert_ok(audio_node_set_param(&beamformer, NODE_BEAMFORMER_PARAM_AZIMUTH(0), 30.0f, 0),
+               "Steer failed");
+    zassert_ok(audio_node_set_param(&beamformer, NODE_BEAMFORMER_PARAM_AZIMUTH(1), 90.0f, 0),
+               "Steer failed");
+
+    measure(30.0f, rms);
+
+    float on_axis = 20.0f * log10f(rms[0] / (WAVE_LEVEL / sqrtf(2.0f)));
+    float off_axis = 20.0f * log10f(rms[1] / rms[0]);
+
+    TC_PRINT("%.0f Hz from 30 deg: beam at 30 deg %.2f dB, beam at 90 deg %.1f dB below\n",
+             (double)WAVE_HZ, (double)on_axis, (double)-off_axis);
+
+    zassert_within(on_axis, 0.0f, 0.5f, "On-axis wave not passed at unity");
+    zassert_true(off_axis < -6.0f, "Off-axis beam only %.1f dB down", (double)off_axis);
+}
+
+ZTEST(beamformer, test_fractional_delay) {
+    const float whole[MICS] = { 3.0f, 0.0f, 0.0f, 0.0f };
+    const float half[MICS] = { 2.5f, 0.0f, 0.0f, 0.0f };
+    const float weights[MICS] = { 1.0f, 0.0f, 0.0f, 0.0f };
+    int16_t beam0[FRAMES];
+
+    // Whole samples: the impulse, delayed by one more for the interpolator
+    zassert_ok(node_beamformer_set_beam(&beamformer, 0, whole, weights), "Set failed");
+    impulse_block(10, beam0);
+    for (size_t n = 0; n < FRAMES; n++) {
+        zassert_within(beam0[n], n == 14 ? 16000 : 0, 1, "Frame %u: %d", n, beam0[n]);
+    }
+
+    // Across the block boundary
+    impulse_block(FRAMES - 1, beam0);
+    impulse_block(-1, beam0);
+    zassert_within(beam0[3], 16000, 1, "Delay lost at the block boundary");
+
+    // Half a sample: Lagrange taps -1/16, 9/16, 9/16, -1/16 centred on 3.5
+    zassert_ok(node_beamformer_set_beam(&beamformer, 0, half, weights), "Set failed");
+    audio_node_reset(&beamformer);
+    impulse_block(0, beam0);
+
+    const int16_t expect[] = { 0, 0, -1000, 9000, 9000, -1000, 0 };
+    for (size_t n = 0; n < ARRAY_SIZE(expect); n++) {
+        zassert_within(beam0[n], expect[n], 1, "Frame %u: %d", n, beam0[n]);
+    }
+}
+
+ZTEST(beamformer, test_runtime_steering) {
+    float rms[BEAMS], azimuth;
+
+    zassert_ok(audio_node_set_param(&beamformer, NODE_BEAMFORMER_PARAM_AZIMUTH(0), 150.0f, 0),
+               "Steer failed");
+    measure(150.0f, rms);
+    float on_talker = rms[0];
+
+    // Steer away while running
+    zassert_ok(audio_node_set_param(&beamformer, NODE_BEAMFORMER_PARAM_AZIMUTH(0), 30.0f, 0),
+               "Steer failed");
+    zassert_ok(audio_node_get_param(&beamformer, NODE_BEAMFORMER_PARAM_AZIMUTH(0), &azimuth),
+               "Read failed");
+    zassert_within(azimuth, 30.0f, 0.001f, "Azimuth not stored");
+    measure(150.0f, rms);
+
+    TC_PRINT("Steered away from the talker: %.1f dB\n", (double)(20.0f * log10f(rms[0] / on_talker)));
+    zassert_true(rms[0] < 0.5f * on_talker, "Steering had no effect");
+
+    zassert_equal(audio_node_set_param(&beamformer, NODE_BEAMFORMER_PARAM_AZIMUTH(BEAMS), 0.0f, 0),
+                  -EINVAL, "Beam beyond config.beams accepted");
+
+    // Delays set directly have no azimuth
+    const float delays[MICS] = { 0 };
+    zassert_ok(node_beamformer_set_beam(&beamformer, 0, delays, NULL), "Set failed");
+    audio_node_get_param(&beamformer, NODE_BEAMFORMER_PARAM_AZIMUTH(0), &azimuth);
+    zassert_true(isnan(azimuth), "Custom beam reports an azimuth");
+}
+
+ZTEST(beamformer, test_ramped_steering) {
+    float rms[BEAMS];
+
+    zassert_ok(audio_node_set_param(&beamformer, NODE_BEAMFORMER_PARAM_AZIMUTH(0), 150.0f, 0),
+               "Steer failed");
+    measure(150.0f, rms);
+    float on_talker = rms[0];
+
+    // Crossfade over 8 blocks: the first one is still mostly the old beam
+    zassert_ok(audio_node_set_param(&beamformer, NODE_BEAMFORMER_PARAM_AZIMUTH(0), 30.0f,
+                                    8 * FRAMES), "Steer failed");
+    float first = block_rms(150.0f);
+
+    zassert_true(first > 0.75f * on_talker, "Ramped steer cut over at once (%.0f of %.0f)",
+                 (double)first, (double)on_talker);
+
+    for (int b = 0; b < 7; b++) {
+        block_rms(150.0f);
+    }
+    measure(150.0f, rms);
+    zassert_true(rms[0] < 0.5f * on_talker, "Ramp never reached the new azimuth");
+}
+
+ZTEST(beamformer, test_config) {
+    struct beamformer_config bad = config;
+    struct audio_node node;
+
+    bad.mics = 1;
+    bad.beams = 1;
+    zassert_equal(node_beamformer_init(&node, &bad), -EINVAL, "One mic accepted");
+
+    bad = config;
+    bad.beams = MICS + 1;
+    zassert_equal(node_beamformer_init(&node, &bad), -EINVAL, "More beams than mics accepted");
+
+    // 300 mm needs 42 samples at 48 kHz
+    bad = config;
+    bad.positions[3].x_mm = 240.0f;
+    zassert_equal(node_beamformer_init(&node, &bad), -EINVAL, "Aperture beyond MAX_DELAY accepted");
+
+    const float too_long[MICS] = { CONFIG_AUDIO_BEAMFORMER_MAX_DELAY + 1.0f };
+    zassert_equal(node_beamformer_set_beam(&beamformer, 0, too_long, NULL), -EINVAL,
+                  "Delay beyond MAX_DELAY accepted");
+
+    zassert_equal(node_beamformer_init(&node, &config), -ENOMEM, "Node pool not bounded");
+}
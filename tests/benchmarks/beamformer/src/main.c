@@ -0,0 +1,100 @@
+/**
+ * @file main.c
+ * @brief Beamformer benchmark
+ *
+ * Runs circular arrays of 2 to 8 mics (60 mm across) with one beam and
+ * with four, all fed the same number of frames per block, and prints the
+ * mean cycles per block and per mic and beam of one frame. The cost per
+ * mic and beam should stay flat as the array grows. testcase.yaml sweeps
+ * the block size.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <audio_fw_v2.h>
+#include <math.h>
+
+#define BLOCK           CONFIG_AUDIO_BLOCK_SAMPLES
+#define FRAMES          (BLOCK / CONFIG_AUDIO_BEAMFORMER_MAX_MICS)
+#define BLOCKS          200
+#define WARMUP_BLOCKS   20
+#define RADIUS_MM       30.0f
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static const uint8_t mic_counts[] = { 2, 4, 6, 8 };
+static const uint8_t beam_counts[] = { 1, 4 };
+
+static struct audio_node beamformer;
+static uint32_t rng_state = 2463534242u;
+
+static int16_t noise(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (int16_t)(rng_state >> 20) - 2048;
+}
+
+/* Mean cycles per block, warm-up excluded */
+static uint32_t measure(uint8_t mics) {
+    uint64_t total = 0;
+
+    for (size_t b = 0; b < BLOCKS; b++) {
+        struct audio_block *block = audio_block_alloc();
+        zassert_not_null(block, "Pool exhausted");
+
+        for (size_t i = 0; i < FRAMES * mics; i++) {
+            block->data[i] = noise();
+        }
+        block->data_len = FRAMES * mics;
+
+        uint32_t start = k_cycle_get_32();
+        block = audio_node_process(&beamformer, block);
+        uint32_t cycles = k_cycle_get_32() - start;
+
+        if (b >= WARMUP_BLOCKS) {
+            total += cycles;
+        }
+        audio_block_release(block);
+    }
+    return (uint32_t)(total / (BLOCKS - WARMUP_BLOCKS));
+}
+
+ZTEST_SUITE(beamformer_bench, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(beamformer_bench, test_cycles_per_mic) {
+    TC_PRINT("%d frames per block, mean cycles per block (per mic and beam of a frame):\n",
+             FRAMES);
+
+    for (size_t n = 0; n < ARRAY_SIZE(mic_counts); n++) {
+        for (size_t k = 0; k < ARRAY_SIZE(beam_counts); k++) {
+            struct beamformer_config config = {
+                .mics = mic_counts[n],
+                .beams = MIN(beam_counts[k], mic_counts[n]),
+            };
+
+            for (size_t m = 0; m < config.mics; m++) {
+                float a = 2.0f * (float)M_PI * m / config.mics;
+
+                config.positions[m].x_mm = RADIUS_MM * cosf(a);
+                config.positions[m].y_mm = RADIUS_MM * sinf(a);
+            }
+
+            zassert_ok(node_beamformer_init(&beamformer, &config), "Init failed");
+
+            // Spread the beams around the array
+            for (size_t b = 0; b < config.beams; b++) {
+                audio_node_set_param(&beamformer, NODE_BEAMFORMER_PARAM_AZIMUTH(b),
+                                     45.0f + 90.0f * b, 0);
+            }
+
+            uint32_t cycles = measure(config.mics);
+
+            TC_PRINT("  %u mics, %u beams: %7u (%u.%u)\n", config.mics, config.beams, cycles,
+                     cycles * 10 / (FRAMES * config.mics * config.beams) / 10,
+                     cycles * 10 / (FRAMES * config.mics * config.beams) % 10);
+        }
+    }
+}
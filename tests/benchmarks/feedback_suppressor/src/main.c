@@ -0,0 +1,94 @@
+/**
+ * @file main.c
+ * @brief Feedback suppressor benchmark
+ *
+ * Feeds one steady tone per notch over noise, so after the first second
+ * every notch of the cascade is deployed and retriggered, and prints the
+ * mean and worst cycles per block with all notches running, as a share
+ * of one block period at the cycle counter rate. Blocks that complete an
+ * analysis frame carry the FFT and peak search, so the worst case is
+ * what the strip has to budget. testcase.yaml sweeps rate and FFT length.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <audio_fw_v2.h>
+#include <math.h>
+
+#define RATE            CONFIG_AUDIO_SAMPLE_RATE
+#define BLOCK           CONFIG_AUDIO_BLOCK_SAMPLES
+#define SECONDS         3
+#define BLOCKS          (SECONDS * RATE / BLOCK)
+#define SETTLE_BLOCKS   (RATE / BLOCK)
+#define TONES           6
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static struct audio_node fbs;
+static uint32_t rng_state = 2463534242u;
+static float phase_step[TONES];
+
+static int16_t noise(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (int16_t)(rng_state >> 24) - 128;
+}
+
+static void *setup(void) {
+    zassert_ok(node_feedback_suppressor_init(&fbs, NULL), "Init failed");
+
+    /* Spread over the voice range, well apart */
+    for (size_t t = 0; t < TONES; t++) {
+        phase_step[t] = 2.0f * (float)M_PI * (350.0f + 1100.0f * t) / RATE;
+    }
+    return NULL;
+}
+
+ZTEST_SUITE(feedback_suppressor_bench, NULL, setup, NULL, NULL, NULL);
+
+ZTEST(feedback_suppressor_bench, test_cycles_per_block) {
+    struct feedback_suppressor_stats stats;
+    float phase[TONES] = { 0 };
+    uint64_t total = 0;
+    uint32_t worst = 0;
+
+    for (size_t b = 0; b < BLOCKS; b++) {
+        struct audio_block *block = audio_block_alloc();
+        zassert_not_null(block, "Pool exhausted");
+
+        for (size_t i = 0; i < BLOCK; i++) {
+            float x = noise();
+            for (size_t t = 0; t < TONES; t++) {
+                phase[t] = fmodf(phase[t] + phase_step[t], 2.0f * (float)M_PI);
+                x += 2500.0f * sinf(phase[t]);
+            }
+            block->data[i] = (int16_t)x;
+        }
+        block->data_len = BLOCK;
+
+        uint32_t start = k_cycle_get_32();
+        block = audio_node_process(&fbs, block);
+        uint32_t cycles = k_cycle_get_32() - start;
+
+        if (b >= SETTLE_BLOCKS) {
+            total += cycles;
+            worst = MAX(worst, cycles);
+        }
+        audio_block_release(block);
+    }
+
+    zassert_ok(node_feedback_suppressor_get_stats(&fbs, &stats), "Stats failed");
+
+    uint64_t period = (uint64_t)sys_clock_hw_cycles_per_sec() * BLOCK / RATE;
+
+    TC_PRINT("%d Hz, FFT %d, block %d, %u notches:\n", RATE, CONFIG_AUDIO_FBS_FFT_SIZE, BLOCK,
+             stats.active_notches);
+    TC_PRINT("  mean:   %u cycles/block\n", (uint32_t)(total / (BLOCKS - SETTLE_BLOCKS)));
+    TC_PRINT("  worst:  %u cycles/block, %u.%u%% of the block period\n", worst,
+             (uint32_t)(worst * 100 / period), (uint32_t)(worst * 1000 / period % 10));
+
+    zassert_equal(stats.active_notches, TONES, "Benchmark must run with every notch deployed");
+}
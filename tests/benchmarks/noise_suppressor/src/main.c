@@ -0,0 +1,70 @@
+/**
+ * @file main.c
+ * @brief Noise suppressor benchmark
+ *
+ * Runs the suppressor on noisy bursts and prints the mean and worst
+ * cycles per block, and the worst case as a share of one block period at
+ * the cycle counter rate. With a hop of half the frame, a block sees zero
+ * or more whole frames, so the worst case is what the strip has to budget.
+ * testcase.yaml sweeps sample rate and frame length.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <audio_fw_v2.h>
+
+#define RATE            CONFIG_AUDIO_SAMPLE_RATE
+#define BLOCK           CONFIG_AUDIO_BLOCK_SAMPLES
+#define SECONDS         2
+#define BLOCKS          (SECONDS * RATE / BLOCK)
+
+static struct audio_node ns;
+static uint32_t rng_state = 2463534242u;
+
+static int16_t noise(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (int16_t)(rng_state >> 20) - 2048;
+}
+
+static void *setup(void) {
+    zassert_ok(node_noise_suppressor_init(&ns, NULL), "Init failed");
+    return NULL;
+}
+
+ZTEST_SUITE(noise_suppressor_bench, NULL, setup, NULL, NULL, NULL);
+
+ZTEST(noise_suppressor_bench, test_cycles_per_block) {
+    uint64_t total = 0;
+    uint32_t worst = 0;
+
+    for (size_t b = 0; b < BLOCKS; b++) {
+        struct audio_block *block = audio_block_alloc();
+        zassert_not_null(block, "Pool exhausted");
+
+        /* Quarter-second bursts of a loud square wave over the noise */
+        bool burst = ((b * BLOCK) / (RATE / 4)) % 2;
+        for (size_t i = 0; i < BLOCK; i++) {
+            int16_t tone = ((b * BLOCK + i) / 40) % 2 ? 8000 : -8000;
+            block->data[i] = noise() + (burst ? tone : 0);
+        }
+        block->data_len = BLOCK;
+
+        uint32_t start = k_cycle_get_32();
+        block = audio_node_process(&ns, block);
+        uint32_t cycles = k_cycle_get_32() - start;
+
+        total += cycles;
+        worst = MAX(worst, cycles);
+        audio_block_release(block);
+    }
+
+    uint64_t period = (uint64_t)sys_clock_hw_cycles_per_sec() * BLOCK / RATE;
+
+    TC_PRINT("%d Hz, frame %d, block %d:\n", RATE, CONFIG_AUDIO_NS_FFT_SIZE, BLOCK);
+    TC_PRINT("  mean:   %u cycles/block\n", (uint32_t)(total / BLOCKS));
+    TC_PRINT("  worst:  %u cycles/block, %u.%u%% of the block period\n", worst,
+             (uint32_t)(worst * 100 / period), (uint32_t)(worst * 1000 / period % 10));
+    TC_PRINT("  latency %d samples\n", CONFIG_AUDIO_NS_FFT_SIZE - 1);
+}
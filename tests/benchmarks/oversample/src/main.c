@@ -0,0 +1,78 @@
+/**
+ * @file main.c
+ * @brief Oversampling wrapper benchmark
+ *
+ * Runs a soft clipper directly and wrapped at 2x and 4x, and prints the
+ * cycles per base-rate sample of each together with the added latency.
+ * testcase.yaml sweeps the half-band filter lengths.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <audio_fw_v2.h>
+
+#define BLOCKS          200
+
+/* Cubic soft clipper, cheap enough not to hide the resampling cost */
+static struct audio_block *soft_clip_process(struct audio_node *self, struct audio_block *in) {
+    for (size_t i = 0; i < in->data_len; i++) {
+        int32_t x = in->data[i];
+        int32_t x3 = ((x * x) >> 15) * x >> 15;
+        in->data[i] = (int16_t)CLAMP(x - x3 / 3, INT16_MIN, INT16_MAX);
+    }
+    return in;
+}
+
+static const struct audio_node_api soft_clip_api = {
+    .process = soft_clip_process,
+};
+
+static struct audio_node plain = { .vtable = &soft_clip_api };
+static struct audio_node inner2 = { .vtable = &soft_clip_api };
+static struct audio_node inner4 = { .vtable = &soft_clip_api };
+static struct audio_node os2, os4;
+
+static void *setup(void) {
+    zassert_ok(node_oversample_init(&os2, &inner2, 2), "2x init failed");
+    zassert_ok(node_oversample_init(&os4, &inner4, 4), "4x init failed");
+    return NULL;
+}
+
+ZTEST_SUITE(oversample_bench, NULL, setup, NULL, NULL, NULL);
+
+static uint32_t run_blocks(struct audio_node *node) {
+    uint32_t cycles = 0;
+
+    for (int b = 0; b < BLOCKS; b++) {
+        struct audio_block *block = audio_block_alloc();
+        zassert_not_null(block, "Pool exhausted");
+
+        for (size_t i = 0; i < block->data_len; i++) {
+            block->data[i] = (int16_t)((i * 977) & 0x7fff) - 16384;
+        }
+
+        uint32_t start = k_cycle_get_32();
+        block = audio_node_process(node, block);
+        cycles += k_cycle_get_32() - start;
+
+        audio_block_release(block);
+    }
+
+    return cycles;
+}
+
+ZTEST(oversample_bench, test_factor_sweep) {
+    const uint32_t samples = BLOCKS * CONFIG_AUDIO_BLOCK_SAMPLES;
+
+    uint32_t direct = run_blocks(&plain);
+    uint32_t x2 = run_blocks(&os2);
+    uint32_t x4 = run_blocks(&os4);
+
+    TC_PRINT("block %d samples, taps %d/%d:\n", CONFIG_AUDIO_BLOCK_SAMPLES,
+             CONFIG_AUDIO_OVERSAMPLE_TAPS, CONFIG_AUDIO_OVERSAMPLE_STAGE2_TAPS);
+    TC_PRINT("  1x:  %u cycles/sample\n", direct / samples);
+    TC_PRINT("  2x:  %u cycles/sample, latency %u samples\n", x2 / samples,
+             node_oversample_get_latency(&os2));
+    TC_PRINT("  4x:  %u cycles/sample, latency %u samples\n", x4 / samples,
+             node_oversample_get_latency(&os4));
+}
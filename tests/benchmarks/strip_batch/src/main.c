@@ -0,0 +1,77 @@
+/**
+ * @file main.c
+ * @brief Strip batching benchmark
+ *
+ * Feeds bursts of blocks into a running channel strip and measures the
+ * cycles per sample from push to output, once without batching and once
+ * with CONFIG_AUDIO_STRIP_BATCH_MAX. testcase.yaml sweeps the block size.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <audio_fw_v2.h>
+#include <channel_strip.h>
+
+#define STRIP_NODES     4
+#define BURST_BLOCKS    8
+#define BURSTS          100
+#define STRIP_STACK     2048
+
+K_THREAD_STACK_DEFINE(strip_stack, STRIP_STACK);
+
+static struct channel_strip strip;
+static struct audio_node gains[STRIP_NODES];
+static struct k_fifo out_fifo;
+
+static void *setup(void) {
+    k_fifo_init(&out_fifo);
+    channel_strip_init(&strip, "bench");
+    for (int i = 0; i < STRIP_NODES; i++) {
+        node_vol_init(&gains[i], 0.9f);
+        channel_strip_add_node(&strip, &gains[i]);
+    }
+    strip.out_fifo = &out_fifo;
+
+    /* Lower priority than the test thread so bursts queue up */
+    channel_strip_start(&strip, strip_stack, STRIP_STACK,
+                        k_thread_priority_get(k_current_get()) + 1);
+    return NULL;
+}
+
+ZTEST_SUITE(strip_batch_bench, NULL, setup, NULL, NULL, NULL);
+
+static uint32_t run_bursts(size_t batch_limit) {
+    zassert_ok(channel_strip_set_batch_limit(&strip, batch_limit), "Bad batch limit");
+
+    uint32_t cycles = 0;
+
+    for (int burst = 0; burst < BURSTS; burst++) {
+        uint32_t start = k_cycle_get_32();
+
+        for (int b = 0; b < BURST_BLOCKS; b++) {
+            struct audio_block *block = audio_block_alloc();
+            zassert_not_null(block, "Pool exhausted");
+            channel_strip_push_input(&strip, block);
+        }
+
+        for (int b = 0; b < BURST_BLOCKS; b++) {
+            struct audio_block *block = k_fifo_get(&out_fifo, K_FOREVER);
+            audio_block_release(block);
+        }
+
+        cycles += k_cycle_get_32() - start;
+    }
+
+    return cycles;
+}
+
+ZTEST(strip_batch_bench, test_batch_sweep) {
+    const uint32_t samples = BURSTS * BURST_BLOCKS * CONFIG_AUDIO_BLOCK_SAMPLES;
+
+    uint32_t single = run_bursts(1);
+    uint32_t batched = run_bursts(CONFIG_AUDIO_STRIP_BATCH_MAX);
+
+    TC_PRINT("block %3d samples, %d nodes:\n", CONFIG_AUDIO_BLOCK_SAMPLES, STRIP_NODES);
+    TC_PRINT("  batch 1:  %u cycles/sample\n", single / samples);
+    TC_PRINT("  batch %d:  %u cycles/sample\n", CONFIG_AUDIO_STRIP_BATCH_MAX, batched / samples);
+}
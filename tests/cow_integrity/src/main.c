@@ -1,6 +1,7 @@
 #include <zephyr/kernel.h>
 #include <zephyr/ztest.h>
 #include <audio_fw.h>
+#include <string.h>
 
 static void *setup(void) {
     return NULL;
@@ -55,3 +56,104 @@ ZTEST(audio_cow, test_cow_shared) {
     audio_block_release(block);       /* Release new block */
     audio_block_release(original_ptr); /* Release original block (simulating the other owner) */
 }
+
+#define READER_STACK 1024
+K_THREAD_STACK_DEFINE(reader_stack, READER_STACK);
+static struct k_thread reader_thread;
+
+static void reader_entry(void *p1, void *p2, void *p3) {
+    struct audio_block *block = p1;
+
+    /* Read-only consumer: inspect, then drop the declared reference */
+    zassert_equal(block->data[0], 7, "Reader saw wrong data");
+    audio_block_release_read(block);
+}
+
+ZTEST(audio_cow, test_cow_elided_behind_reader) {
+    /* Test 3: Splitter fan-out to a declared reader and a writer */
+    Z_TEST_SKIP_IFNDEF(CONFIG_AUDIO_COW_ELISION);
+
+    struct audio_cow_stats before, after;
+    audio_cow_stats_get(&before);
+
+    struct audio_block *block = audio_block_alloc();
+    zassert_not_null(block, "Alloc failed");
+    block->data[0] = 7;
+
+    atomic_inc(&block->ref_count);
+    audio_block_begin_read(block); /* Reader's reference */
+
+    /* Same priority: the reader only runs when the writer yields */
+    k_thread_create(&reader_thread, reader_stack, READER_STACK, reader_entry,
+                    block, NULL, NULL, k_thread_priority_get(k_current_get()), 0, K_NO_WAIT);
+
+    struct audio_block *original_ptr = block;
+    int ret = audio_block_get_writable(&block);
+    zassert_equal(ret, 0, "get_writable failed");
+    zassert_equal_ptr(block, original_ptr, "Copy should have been elided");
+    zassert_equal(atomic_get(&block->ref_count), 1, "Writer should be sole owner");
+
+    audio_cow_stats_get(&after);
+    zassert_equal(after.avoided, before.avoided + 1, "Avoided copy not counted");
+    zassert_equal(after.copies, before.copies, "Unexpected copy");
+
+    k_thread_join(&reader_thread, K_FOREVER);
+    audio_block_release(block);
+}
+
+ZTEST(audio_cow, test_cow_undeclared_sharer_still_copies) {
+    /* Test 4: A co-owner that did not declare itself may write, so copy */
+    struct audio_cow_stats before, after;
+    audio_cow_stats_get(&before);
+
+    struct audio_block *block = audio_block_alloc();
+    zassert_not_null(block, "Alloc failed");
+    atomic_inc(&block->ref_count);
+
+    struct audio_block *original_ptr = block;
+    zassert_equal(audio_block_get_writable(&block), 0, "get_writable failed");
+    zassert_not_equal(block, original_ptr, "Should have copied");
+
+    audio_cow_stats_get(&after);
+    zassert_equal(after.copies, before.copies + 1, "Copy not counted");
+    zassert_equal(after.avoided, before.avoided, "Copy counted as avoided");
+
+    audio_block_release(block);
+    audio_block_release(original_ptr);
+}
+
+ZTEST(audio_cow, test_cow_preserves_metadata) {
+    /* Test 5: Every metadata byte survives the copy, also for future fields */
+    struct audio_block *block = audio_block_alloc();
+    zassert_not_null(block, "Alloc failed");
+
+    memset((uint8_t *)block + AUDIO_BLOCK_META_OFFSET, 0xA5, AUDIO_BLOCK_META_SIZE);
+    block->data_len = 50;
+    block->flags = AUDIO_BLOCK_FLAG_IDLE;
+    for (size_t i = 0; i < CONFIG_AUDIO_BLOCK_SAMPLES; i++) {
+        block->data[i] = (int16_t)(i + 1);
+    }
+
+    atomic_inc(&block->ref_count);
+    struct audio_block *original_ptr = block;
+
+    zassert_equal(audio_block_get_writable(&block), 0, "get_writable failed");
+    zassert_not_equal(block, original_ptr, "Should have copied");
+
+    zassert_mem_equal((uint8_t *)block + AUDIO_BLOCK_META_OFFSET,
+                      (uint8_t *)original_ptr + AUDIO_BLOCK_META_OFFSET,
+                      AUDIO_BLOCK_META_SIZE, "Metadata lost in CoW");
+    zassert_equal(atomic_get(&block->ref_count), 1, "Instance fields must not be copied");
+
+    /* Valid samples copied, samples past the padded length untouched */
+    size_t padded = AUDIO_BLOCK_PADDED_LEN(50);
+    for (size_t i = 0; i < padded; i++) {
+        zassert_equal(block->data[i], (int16_t)(i + 1), "Sample %zu not copied", i);
+    }
+    for (size_t i = padded; i < CONFIG_AUDIO_BLOCK_SAMPLES; i++) {
+        zassert_equal(block->data[i], 0, "Sample %zu past data_len was copied", i);
+    }
+
+    audio_block_release(block);
+    audio_block_release(original_ptr);
+}
@@ -0,0 +1,312 @@
+/**
+ * @file main.c
+ * @brief Feedback suppressor: closed-loop howl, tone tracking and release
+ *
+ * The howl test closes a simulated room loop around the node: the output
+ * comes back to the input ROOM_DELAY samples later through a resonance at
+ * ROOM_HZ with a loop gain of ROOM_GAIN, on top of quiet noise. Without
+ * suppression the loop rings up to full scale; with it a notch has to
+ * land on the resonance and keep the level down.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <audio_fw_v2.h>
+#include <math.h>
+
+#define RATE            CONFIG_AUDIO_SAMPLE_RATE
+#define BLOCK           CONFIG_AUDIO_BLOCK_SAMPLES
+#define SECONDS         4
+#define BLOCKS          (SECONDS * RATE / BLOCK)
+#define ROOM_DELAY      480
+#define ROOM_HZ         1000.0f
+#define ROOM_Q          8.0f
+#define ROOM_GAIN       1.3f
+#define NOISE_LEVEL     30.0f
+
+BUILD_ASSERT(ROOM_DELAY >= BLOCK, "The loop is closed block by block");
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static struct audio_node suppressor, quick;
+static uint32_t rng_state;
+
+static float white(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (float)rng_state / 4294967296.0f * 2.0f - 1.0f;
+}
+
+/* Constant-peak-gain bandpass, the room resonance */
+struct resonator {
+    float b0, a1, a2;
+    float x1, x2, y1, y2;
+};
+
+static void resonator_init(struct resonator *r) {
+    float w0 = 2.0f * (float)M_PI * ROOM_HZ / RATE;
+    float alpha = sinf(w0) / (2.0f * ROOM_Q);
+    float a0 = 1.0f + alpha;
+
+    *r = (struct resonator) {
+        .b0 = alpha / a0,
+        .a1 = -2.0f * cosf(w0) / a0,
+        .a2 = (1.0f - alpha) / a0,
+    };
+}
+
+static float resonator_next(struct resonator *r, float x) {
+    float y = r->b0 * (x - r->x2) - r->a1 * r->y1 - r->a2 * r->y2;
+
+    r->x2 = r->x1;
+    r->x1 = x;
+    r->y2 = r->y1;
+    r->y1 = y;
+    return y;
+}
+
+/* Runs the room loop, with or without the node; returns the output RMS of the last second */
+static float run_loop(struct audio_node *node) {
+    static float out_ring[ROOM_DELAY];
+    struct resonator room;
+    float energy = 0.0f;
+    size_t n = 0;
+
+    memset(out_ring, 0, sizeof(out_ring));
+    resonator_init(&room);
+    rng_state = 2463534242u;
+
+    for (size_t b = 0; b < BLOCKS; b++) {
+        struct audio_block *block = audio_block_alloc();
+        zassert_not_null(block, "Pool exhausted");
+
+        for (size_t i = 0; i < BLOCK; i++) {
+            float back = ROOM_GAIN * resonator_next(&room, out_ring[(n + i) % ROOM_DELAY]);
+            float x = back + NOISE_LEVEL * white();
+
+            block->data[i] = (int16_t)CLAMP(lrintf(x), INT16_MIN, INT16_MAX);
+        }
+        block->data_len = BLOCK;
+
+        if (node) {
+            block = audio_node_process(node, block);
+        }
+
+        for (size_t i = 0; i < BLOCK; i++, n++) {
+            float y = block->data[i];
+
+            out_ring[n % ROOM_DELAY] = y;
+            if (b >= BLOCKS - RATE / BLOCK) {
+                energy += y * y;
+            }
+        }
+        audio_block_release(block);
+    }
+
+    return sqrtf(energy / (float)((RATE / BLOCK) * BLOCK));
+}
+
+/* Feeds a sum of sines (amplitude each) plus quiet noise for a while */
+static void run_tones(struct audio_node *node, const float *freqs, size_t count, float amplitude,
+                      size_t blocks, float *out_rms) {
+    static size_t n;
+    float energy = 0.0f;
+
+    for (size_t b = 0; b < blocks; b++) {
+        struct audio_block *block = audio_block_alloc();
+        zassert_not_null(block, "Pool exhausted");
+
+        for (size_t i = 0; i < BLOCK; i++, n++) {
+            float x = NOISE_LEVEL * white();
+            for (size_t t = 0; t < count; t++) {
+                x += amplitude * sinf(2.0f * (float)M_PI * freqs[t] * (float)(n % RATE) / RATE);
+            }
+            block->data[i] = (int16_t)CLAMP(lrintf(x), INT16_MIN, INT16_MAX);
+        }
+        block->data_len = BLOCK;
+
+        block = audio_node_process(node, block);
+        for (size_t i = 0; i < BLOCK; i++) {
+            energy += (float)block->data[i] * block->data[i];
+        }
+        audio_block_release(block);
+    }
+
+    if (out_rms) {
+        *out_rms = sqrtf(energy / (float)(blocks * BLOCK));
+    }
+}
+
+static void *setup(void) {
+    struct feedback_suppressor_config fast = FEEDBACK_SUPPRESSOR_DEFAULT_CONFIG;
+
+    fast.max_notches = 2;
+    fast.hold_ms = 200;
+    fast.release_ms = 500;
+
+    zassert_ok(node_feedback_suppressor_init(&suppressor, NULL), "Init failed");
+    zassert_ok(node_feedback_suppressor_init(&quick, &fast), "Init failed");
+    return NULL;
+}
+
+static void before(void *fixture) {
+    rng_state = 2463534242u;
+    audio_node_reset(&suppressor);
+    audio_node_reset(&quick);
+}
+
+ZTEST_SUITE(feedback_suppressor, NULL, setup, before, NULL, NULL);
+
+ZTEST(feedback_suppressor, test_howl_suppressed) {
+    struct feedback_suppressor_notch notches[CONFIG_AUDIO_BIQUAD_MAX_STAGES];
+
+    float open = run_loop(NULL);
+    float closed = run_loop(&suppressor);
+    int count = node_feedback_suppressor_get_notches(&suppressor, notches, ARRAY_SIZE(notches));
+
+    TC_PRINT("Loop output: %.1f dBFS unsuppressed, %.1f dBFS suppressed\n",
+             (double)(20.0f * log10f(open / 32768.0f)), (double)(20.0f * log10f(closed / 32768.0f)));
+    for (int i = 0; i < count; i++) {
+        TC_PRINT("  notch %.1f Hz, %.1f dB\n", (double)notches[i].frequency_hz,
+                 (double)notches[i].depth_db);
+    }
+
+    zassert_true(open > 8000.0f, "Loop did not howl without suppression");
+    zassert_true(closed < 0.02f * open, "Howl not suppressed (%.0f vs %.0f RMS)",
+                 (double)closed, (double)open);
+    zassert_true(count > 0, "No notch deployed");
+
+    bool on_resonance = false;
+    for (int i = 0; i < count; i++) {
+        on_resonance |= fabsf(notches[i].frequency_hz - ROOM_HZ) < ROOM_HZ / ROOM_Q;
+    }
+    zassert_true(on_resonance, "No notch on the room resonance");
+}
+
+ZTEST(feedback_suppressor, test_tone_tracked_and_deepened) {
+    const float freq = 2345.0f;
+    struct feedback_suppressor_notch notch;
+    struct feedback_suppressor_stats stats;
+    float before_rms, after_rms;
+
+    /* Shorter than the detection time: left alone */
+    run_tones(&suppressor, &freq, 1, 3000.0f, 50 * RATE / 1000 / BLOCK, &before_rms);
+    zassert_equal(node_feedback_suppressor_get_notches(&suppressor, &notch, 1), 0,
+                  "Notch before the detection time");
+
+    run_tones(&suppressor, &freq, 1, 3000.0f, RATE / BLOCK, NULL);
+    run_tones(&suppressor, &freq, 1, 3000.0f, RATE / 4 / BLOCK, &after_rms);
+
+    zassert_equal(node_feedback_suppressor_get_notches(&suppressor, &notch, 1), 1, "No notch");
+    zassert_ok(node_feedback_suppressor_get_stats(&suppressor, &stats), "Stats failed");
+
+    float reduction = 20.0f * log10f(before_rms / after_rms);
+
+    TC_PRINT("Notch at %.1f Hz (tone %.1f Hz), %.1f dB deep; tone down %.1f dB\n",
+             (double)notch.frequency_hz, (double)freq, (double)notch.depth_db, (double)reduction);
+
+    zassert_within(notch.frequency_hz, freq, 5.0f, "Notch off the tone");
+    zassert_within(notch.depth_db, 18.0f, 1e-3f, "Notch not deepened to the maximum");
+    zassert_true(reduction > 12.0f, "Tone reduced by only %.1f dB", (double)reduction);
+    zassert_equal(stats.deployed, 1, "Retriggers must deepen, not deploy");
+    zassert_equal(stats.active_notches, 1, "Stats disagree with the notch list");
+}
+
+ZTEST(feedback_suppressor, test_broadband_ignored) {
+    struct feedback_suppressor_stats stats;
+    float rms;
+
+    /* Loud noise: no narrow peaks; the output must be bit-exact */
+    for (size_t b = 0; b < 2 * RATE / BLOCK; b++) {
+        struct audio_block *block = audio_block_alloc();
+        int16_t ref[BLOCK];
+
+        zassert_not_null(block, "Pool exhausted");
+        for (size_t i = 0; i < BLOCK; i++) {
+            ref[i] = block->data[i] = (int16_t)lrintf(8000.0f * white());
+        }
+        block->data_len = BLOCK;
+
+        block = audio_node_process(&suppressor, block);
+        zassert_mem_equal(block->data, ref, sizeof(ref), "Audio changed without notches");
+        audio_block_release(block);
+    }
+
+    /* Tones below the level floor */
+    const float freq = 1500.0f;
+    run_tones(&suppressor, &freq, 1, 50.0f, RATE / BLOCK, &rms);
+
+    zassert_ok(node_feedback_suppressor_get_stats(&suppressor, &stats), "Stats failed");
+    zassert_equal(stats.deployed, 0, "Notch on broadband or quiet content");
+    zassert_true(stats.frames > 0, "No analysis frames");
+}
+
+ZTEST(feedback_suppressor, test_release) {
+    const float freq = 800.0f;
+    struct feedback_suppressor_stats stats;
+
+    run_tones(&quick, &freq, 1, 3000.0f, RATE / 2 / BLOCK, NULL);
+    zassert_ok(node_feedback_suppressor_get_stats(&quick, &stats), "Stats failed");
+    zassert_equal(stats.active_notches, 1, "No notch on the tone");
+
+    /* Within the hold time the notch stays */
+    run_tones(&quick, NULL, 0, 0.0f, 100 * RATE / 1000 / BLOCK, NULL);
+    zassert_ok(node_feedback_suppressor_get_stats(&quick, &stats), "Stats failed");
+    zassert_equal(stats.active_notches, 1, "Released within the hold time");
+
+    /* Hold plus release from at most the maximum depth */
+    run_tones(&quick, NULL, 0, 0.0f, 800 * RATE / 1000 / BLOCK, NULL);
+    zassert_ok(node_feedback_suppressor_get_stats(&quick, &stats), "Stats failed");
+    zassert_equal(stats.active_notches, 0, "Notch not released");
+}
+
+ZTEST(feedback_suppressor, test_notch_limit) {
+    const float freqs[] = { 600.0f, 1700.0f, 3900.0f };
+    struct feedback_suppressor_notch notches[3];
+    struct feedback_suppressor_stats stats;
+
+    run_tones(&quick, freqs, ARRAY_SIZE(freqs), 2000.0f, RATE / BLOCK, NULL);
+
+    zassert_equal(node_feedback_suppressor_get_notches(&quick, notches, ARRAY_SIZE(notches)), 2,
+                  "max_notches exceeded");
+    zassert_ok(node_feedback_suppressor_get_stats(&quick, &stats), "Stats failed");
+    zassert_true(stats.deployed >= 3, "Third peak never got a notch");
+}
+
+ZTEST(feedback_suppressor, test_config_and_params) {
+    struct feedback_suppressor_config bad = FEEDBACK_SUPPRESSOR_DEFAULT_CONFIG;
+    struct audio_node node;
+    float value;
+
+    bad.max_notches = CONFIG_AUDIO_BIQUAD_MAX_STAGES + 1;
+    zassert_equal(node_feedback_suppressor_init(&node, &bad), -EINVAL, "Too many notches");
+    bad.max_notches = 1;
+    bad.notch_q = 0.0f;
+    zassert_equal(node_feedback_suppressor_init(&node, &bad), -EINVAL, "Zero Q accepted");
+    bad.notch_q = NAN;
+    zassert_equal(node_feedback_suppressor_init(&node, &bad), -EINVAL, "NaN Q accepted");
+    bad.notch_q = 30.0f;
+    bad.depth_step_db = NAN;
+    zassert_equal(node_feedback_suppressor_init(&node, &bad), -EINVAL, "NaN depth step accepted");
+    bad.depth_step_db = 6.0f;
+    bad.max_depth_db = NAN;
+    zassert_equal(node_feedback_suppressor_init(&node, &bad), -EINVAL, "NaN max depth accepted");
+    zassert_equal(node_feedback_suppressor_init(NULL, NULL), -EINVAL, "NULL node accepted");
+
+    zassert_ok(audio_node_set_param(&suppressor, NODE_FBS_PARAM_THRESHOLD, 12.0f, 0),
+               "Set failed");
+    zassert_ok(audio_node_get_param(&suppressor, NODE_FBS_PARAM_THRESHOLD, &value), "Get failed");
+    zassert_within(value, 12.0f, 1e-6f, "Threshold not stored");
+    zassert_equal(audio_node_set_param(&suppressor, NODE_FBS_PARAM_MAX_DEPTH, 0.0f, 0), -EINVAL,
+                  "Zero depth accepted");
+    zassert_equal(audio_node_set_param(&suppressor, NODE_FBS_PARAM_MAX_DEPTH, NAN, 0), -EINVAL,
+                  "NaN depth accepted");
+    zassert_equal(audio_node_set_param(&suppressor, NODE_FBS_PARAM_THRESHOLD, NAN, 0), -EINVAL,
+                  "NaN threshold accepted");
+    zassert_equal(audio_node_set_param(&suppressor, 2, 0.0f, 0), -EINVAL, "Unknown param");
+    zassert_ok(audio_node_set_param(&suppressor, NODE_FBS_PARAM_THRESHOLD, 20.0f, 0),
+               "Restore failed");
+}
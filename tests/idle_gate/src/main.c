@@ -0,0 +1,107 @@
+/**
+ * @file main.c
+ * @brief Silence gate and idle residency of strips
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <audio_fw_v2.h>
+#include <audio_idle.h>
+#include <channel_strip.h>
+
+#define HOLD_BLOCKS     4
+#define THRESHOLD       32
+#define STRIP_STACK     2048
+
+K_THREAD_STACK_DEFINE(strip_stack, STRIP_STACK);
+
+static struct audio_block *make_block(int16_t level) {
+    struct audio_block *block = audio_block_alloc();
+    zassert_not_null(block, "Pool exhausted");
+
+    for (size_t i = 0; i < block->data_len; i++) {
+        block->data[i] = (i & 1) ? level : -level;
+    }
+    return block;
+}
+
+ZTEST_SUITE(idle_gate, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(idle_gate, test_gate_enters_and_leaves_idle) {
+    struct audio_idle_detector det;
+    struct audio_block *out;
+    struct audio_idle_stats stats;
+
+    audio_idle_detector_init(&det, THRESHOLD, HOLD_BLOCKS);
+
+    // Silence within the hold time is still emitted unmarked
+    for (int i = 0; i < HOLD_BLOCKS - 1; i++) {
+        out = audio_idle_gate(&det, make_block(THRESHOLD));
+        zassert_not_null(out, "Block %d dropped during hold time", i);
+        zassert_equal(out->flags & AUDIO_BLOCK_FLAG_IDLE, 0, "Marked too early");
+        audio_block_release(out);
+    }
+
+    // The block completing the hold time carries the marker
+    out = audio_idle_gate(&det, make_block(0));
+    zassert_not_null(out, "Idle marker block dropped");
+    zassert_true(out->flags & AUDIO_BLOCK_FLAG_IDLE, "Idle marker missing");
+    zassert_true(audio_idle_is_idle(&det), "Detector not idle");
+    audio_block_release(out);
+
+    // Further silence is swallowed
+    zassert_is_null(audio_idle_gate(&det, make_block(0)), "Silence emitted while idle");
+
+    // Resume on the first loud block
+    out = audio_idle_gate(&det, make_block(1000));
+    zassert_not_null(out, "Activity not emitted");
+    zassert_equal(out->flags & AUDIO_BLOCK_FLAG_IDLE, 0, "Active block marked idle");
+    zassert_false(audio_idle_is_idle(&det), "Detector still idle");
+    audio_block_release(out);
+
+    audio_idle_residency_get(&det.residency, &stats);
+    zassert_equal(stats.entries, 1, "Expected one idle entry, got %u", stats.entries);
+    zassert_false(stats.idle, "Residency still idle");
+}
+
+ZTEST(idle_gate, test_strip_counts_residency) {
+    static struct channel_strip strip;
+    static struct audio_node gain;
+    static struct k_fifo out_fifo;
+    struct audio_idle_stats stats;
+    struct audio_block *out;
+
+    k_fifo_init(&out_fifo);
+    channel_strip_init(&strip, "idle");
+    node_vol_init(&gain, 0.5f);
+    channel_strip_add_node(&strip, &gain);
+    strip.out_fifo = &out_fifo;
+    channel_strip_start(&strip, strip_stack, STRIP_STACK,
+                        k_thread_priority_get(k_current_get()) - 1);
+
+    struct audio_block *last = make_block(0);
+    last->flags |= AUDIO_BLOCK_FLAG_IDLE;
+    channel_strip_push_input(&strip, last);
+
+    out = k_fifo_get(&out_fifo, K_MSEC(100));
+    zassert_not_null(out, "Strip produced no output");
+    zassert_true(out->flags & AUDIO_BLOCK_FLAG_IDLE, "Strip dropped the idle marker");
+    audio_block_release(out);
+
+    k_msleep(50);
+
+    channel_strip_get_idle_stats(&strip, &stats);
+    zassert_true(stats.idle, "Strip not idle after marker");
+    zassert_true(stats.idle_ms >= 40, "Idle residency %llu ms too short", stats.idle_ms);
+
+    channel_strip_push_input(&strip, make_block(1000));
+    out = k_fifo_get(&out_fifo, K_MSEC(100));
+    zassert_not_null(out, "Strip did not resume");
+    audio_block_release(out);
+
+    channel_strip_get_idle_stats(&strip, &stats);
+    zassert_false(stats.idle, "Strip still idle after activity");
+    zassert_equal(stats.entries, 1, "Expected one idle entry, got %u", stats.entries);
+
+    channel_strip_stop(&strip);
+}
@@ -0,0 +1,64 @@
+/**
+ * @file main.c
+ * @brief Block owner tagging and stale block dump
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <audio_fw.h>
+
+#define STALE_PERIODS   10
+#define RATE            CONFIG_AUDIO_SAMPLE_RATE
+
+/* Block period in ms, rounded up */
+#define PERIOD_MS  ((CONFIG_AUDIO_BLOCK_SAMPLES * 1000 + RATE - 1) / RATE)
+
+ZTEST_SUITE(leak_detect, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(leak_detect, test_only_stale_blocks_are_listed) {
+    size_t base = audio_block_outstanding();
+
+    struct audio_block *leaked = audio_block_alloc();
+    struct audio_block *fresh = audio_block_alloc();
+    zassert_not_null(leaked, "Alloc failed");
+    zassert_not_null(fresh, "Alloc failed");
+    zassert_equal(audio_block_outstanding(), base + 2, "Outstanding count wrong");
+
+    audio_block_set_owner(leaked, "leaky_strip", 2);
+    k_msleep(2 * STALE_PERIODS * PERIOD_MS);
+
+    /* Handing a block on resets its age */
+    audio_block_set_owner(fresh, "busy_strip", 0);
+
+    zassert_equal(audio_block_dump_stale(STALE_PERIODS, RATE), 1,
+                  "Expected exactly the leaked block");
+
+    /* Periods are eight times longer at an eighth of the rate */
+    zassert_equal(audio_block_dump_stale(STALE_PERIODS, RATE / 8), 0,
+                  "Age not measured at the given rate");
+
+    audio_block_release(leaked);
+    audio_block_release(fresh);
+
+    zassert_equal(audio_block_outstanding(), base, "Blocks not returned");
+    zassert_equal(audio_block_dump_stale(0, RATE), 0, "Released blocks still listed");
+}
+
+ZTEST(leak_detect, test_cow_copy_is_tracked) {
+    struct audio_block *block = audio_block_alloc();
+    zassert_not_null(block, "Alloc failed");
+
+    atomic_inc(&block->ref_count);
+    struct audio_block *shared = block;
+
+    zassert_ok(audio_block_get_writable(&block), "CoW failed");
+    zassert_not_equal(block, shared, "CoW did not copy");
+
+    k_msleep(2 * STALE_PERIODS * PERIOD_MS);
+    zassert_equal(audio_block_dump_stale(STALE_PERIODS, RATE), 2,
+                  "Original and copy should be listed");
+
+    audio_block_release(shared);
+    audio_block_release(block);
+    zassert_equal(audio_block_dump_stale(0, RATE), 0, "Blocks still listed");
+}
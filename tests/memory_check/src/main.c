@@ -1,6 +1,7 @@
 #include <zephyr/kernel.h>
 #include <zephyr/ztest.h>
 #include <audio_fw.h> // Dein Header
+#include <string.h>
 
 // Setup: Läuft vor jedem Test
 static void *setup(void) {
@@ -48,4 +49,70 @@ ZTEST(audio_memory, test_pool_capacity) {
     for(int j=0; j<i; j++) {
         audio_block_release(blocks[j]);
     }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Testet, ob Payload und Header auf CONFIG_AUDIO_BLOCK_ALIGNMENT liegen
+ * und sich zwei Blöcke keine Cache-Line teilen.
+ */
+ZTEST(audio_memory, test_payload_alignment) {
+    struct audio_block *a = audio_block_alloc();
+    struct audio_block *b = audio_block_alloc();
+    zassert_not_null(a, "Alloc fehlgeschlagen");
+    zassert_not_null(b, "Alloc fehlgeschlagen");
+
+    zassert_true(IS_ALIGNED(a->data, AUDIO_BLOCK_ALIGN), "Payload %p nicht ausgerichtet", a->data);
+    zassert_true(IS_ALIGNED(b->data, AUDIO_BLOCK_ALIGN), "Payload %p nicht ausgerichtet", b->data);
+    zassert_true(IS_ALIGNED(a, AUDIO_BLOCK_ALIGN), "Header %p nicht ausgerichtet", a);
+
+    // Abstand zweier Payloads muss mindestens ein Stride sein
+    uintptr_t pa = (uintptr_t)a->data;
+    uintptr_t pb = (uintptr_t)b->data;
+    uintptr_t dist = (pa > pb) ? (pa - pb) : (pb - pa);
+    zassert_true(dist >= AUDIO_BLOCK_STRIDE_BYTES, "Payloads überlappen (Abstand %u)", (unsigned)dist);
+
+    audio_block_release(a);
+    audio_block_release(b);
+}
+
+/**
+ * @brief Testet, ob ein kurzer Block bis AUDIO_BLOCK_PADDED_LEN genullt ist,
+ * auch wenn der Slab-Speicher vorher beschrieben wurde.
+ */
+ZTEST(audio_memory, test_short_block_padding) {
+    const size_t stride_samples = AUDIO_BLOCK_STRIDE_BYTES / sizeof(int16_t);
+    const size_t short_len = 3 * AUDIO_BLOCK_VEC_SAMPLES + 5;
+    struct audio_block *blocks[2];
+
+    zassert_true(AUDIO_BLOCK_PADDED_LEN(short_len) > short_len, "Kein Padding zu prüfen");
+    zassert_true(AUDIO_BLOCK_PADDED_LEN(short_len) <= stride_samples, "Block zu klein");
+
+    // Ganzen Stride beschreiben, freigeben und wieder holen
+    for (int i = 0; i < 2; i++) {
+        blocks[i] = audio_block_alloc();
+        zassert_not_null(blocks[i], "Alloc fehlgeschlagen");
+        memset(blocks[i]->data, 0x5a, AUDIO_BLOCK_STRIDE_BYTES);
+    }
+    for (int i = 0; i < 2; i++) {
+        audio_block_release(blocks[i]);
+    }
+
+    for (int i = 0; i < 2; i++) {
+        struct audio_block *block = audio_block_alloc();
+        zassert_not_null(block, "Alloc fehlgeschlagen");
+
+        // Kurzer Block: gepaddete Kernels lesen bis AUDIO_BLOCK_PADDED_LEN(data_len)
+        block->data_len = short_len;
+        for (size_t n = 0; n < short_len; n++) {
+            block->data[n] = 1000;
+        }
+        for (size_t n = short_len; n < AUDIO_BLOCK_PADDED_LEN(short_len); n++) {
+            zassert_equal(block->data[n], 0, "Padding nicht genullt bei %u", (unsigned)n);
+        }
+        blocks[i] = block;
+    }
+
+    for (int i = 0; i < 2; i++) {
+        audio_block_release(blocks[i]);
+    }
+}
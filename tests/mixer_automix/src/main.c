@@ -0,0 +1,223 @@
+/**
+ * @file main.c
+ * @brief Automix: gain sharing over 32 open microphones
+ *
+ * Every channel strip holds one "microphone" node that replaces the
+ * block with its own signal: a tone at a settable level over a faint
+ * hiss, or a constant for the ramp checks. The mixer runs without its
+ * thread, block by block through audio_mixer_process_block().
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <channel_strip.h>
+#include <math.h>
+#include <stdlib.h>
+
+#define RATE            CONFIG_AUDIO_SAMPLE_RATE
+#define BLOCK           CONFIG_AUDIO_BLOCK_SAMPLES
+#define CHANNELS        MIXER_MAX_CHANNELS
+#define SETTLE_BLOCKS   (RATE / 2 / BLOCK)
+#define TALK_LEVEL      8000.0f
+#define HISS_LEVEL      8
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+struct mic_ctx {
+    float level;        /* Tone amplitude, 0 = hiss only */
+    float phase;
+    float step;
+    bool dc;            /* Constant level instead of the tone */
+    uint32_t rng;
+};
+
+static struct audio_block *mic_process(struct audio_node *self, struct audio_block *in) {
+    struct mic_ctx *ctx = self->ctx;
+
+    for (size_t i = 0; i < in->data_len; i++) {
+        float x;
+
+        if (ctx->dc) {
+            x = ctx->level;
+        } else {
+            ctx->rng = ctx->rng * 1664525u + 1013904223u;
+            x = ctx->level * sinf(ctx->phase) + (float)((int32_t)(ctx->rng >> 28) - HISS_LEVEL);
+            ctx->phase = fmodf(ctx->phase + ctx->step, 2.0f * (float)M_PI);
+        }
+        in->data[i] = (int16_t)x;
+    }
+    return in;
+}
+
+static const struct audio_node_api mic_api = {
+    .process = mic_process,
+};
+
+static struct audio_mixer mixer;
+static struct channel_strip strips[CHANNELS];
+static struct audio_node mics[CHANNELS];
+static struct mic_ctx mic_ctx[CHANNELS];
+
+static void talk(size_t ch, float level) {
+    mic_ctx[ch].level = level;
+}
+
+static void silence_all(bool dc) {
+    for (size_t ch = 0; ch < CHANNELS; ch++) {
+        mic_ctx[ch].level = 0.0f;
+        mic_ctx[ch].dc = dc;
+    }
+}
+
+/* Runs blocks and returns the output RMS of the last one */
+static float run(size_t blocks) {
+    float energy = 0.0f;
+
+    for (size_t b = 0; b < blocks; b++) {
+        struct audio_block *in = audio_block_alloc();
+        zassert_not_null(in, "Pool exhausted");
+        in->data_len = BLOCK;
+
+        struct audio_block *out = audio_mixer_process_block(&mixer, in);
+        zassert_not_null(out, "No mix");
+
+        if (b == blocks - 1) {
+            for (size_t i = 0; i < BLOCK; i++) {
+                energy += (float)out->data[i] * out->data[i];
+            }
+        }
+        audio_block_release(out);
+    }
+    return sqrtf(energy / BLOCK);
+}
+
+static void *setup(void) {
+    audio_mixer_init(&mixer);
+
+    for (size_t ch = 0; ch < CHANNELS; ch++) {
+        mic_ctx[ch] = (struct mic_ctx) {
+            .step = 2.0f * (float)M_PI * (300.0f + 37.0f * ch) / RATE,
+            .rng = 1 + ch,
+        };
+        mics[ch].vtable = &mic_api;
+        mics[ch].ctx = &mic_ctx[ch];
+
+        channel_strip_init(&strips[ch], "mic");
+        channel_strip_add_node(&strips[ch], &mics[ch]);
+        zassert_equal(audio_mixer_add_channel(&mixer, &strips[ch]), (int)ch, "Add failed");
+    }
+    return NULL;
+}
+
+static void before(void *fixture) {
+    struct audio_mixer_automix_config config = AUDIO_MIXER_AUTOMIX_DEFAULT_CONFIG;
+
+    silence_all(false);
+    zassert_ok(audio_mixer_set_automix(&mixer, &config), "Automix not enabled");
+}
+
+ZTEST_SUITE(mixer_automix, NULL, setup, before, NULL, NULL);
+
+ZTEST(mixer_automix, test_single_talker_unity) {
+    float gains[CHANNELS];
+
+    talk(5, TALK_LEVEL);
+    float rms = run(SETTLE_BLOCKS);
+
+    zassert_equal(audio_mixer_get_automix_gains(&mixer, gains, CHANNELS), CHANNELS,
+                  "One gain per channel expected");
+    TC_PRINT("Talker gain %.3f, others %.4f, mix %.0f RMS\n", (double)gains[5],
+             (double)gains[0], (double)rms);
+
+    zassert_true(gains[5] > 0.95f, "Talker attenuated to %.3f", (double)gains[5]);
+    for (size_t ch = 0; ch < CHANNELS; ch++) {
+        if (ch != 5) {
+            zassert_true(gains[ch] < 0.05f, "Open mic %u at %.3f", ch, (double)gains[ch]);
+        }
+    }
+    zassert_within(rms, TALK_LEVEL / sqrtf(2.0f), 0.1f * TALK_LEVEL, "Mix level off");
+}
+
+ZTEST(mixer_automix, test_shared_talkers_constant_power) {
+    float gains[CHANNELS];
+
+    talk(2, TALK_LEVEL);
+    float one = run(SETTLE_BLOCKS);
+
+    talk(17, TALK_LEVEL);
+    float two = run(SETTLE_BLOCKS);
+
+    talk(30, TALK_LEVEL);
+    talk(9, TALK_LEVEL);
+    float four = run(SETTLE_BLOCKS);
+
+    audio_mixer_get_automix_gains(&mixer, gains, CHANNELS);
+    TC_PRINT("Mix RMS: %.0f one, %.0f two, %.0f four talkers; gain %.3f each\n",
+             (double)one, (double)two, (double)four, (double)gains[2]);
+
+    zassert_within(gains[2], 0.5f, 0.03f, "Four talkers should share at 1/2");
+    zassert_within(gains[9], gains[30], 0.01f, "Equal talkers, unequal gains");
+    zassert_within(20.0f * log10f(two / one), 0.0f, 1.0f, "Two talkers changed the level");
+    zassert_within(20.0f * log10f(four / one), 0.0f, 1.0f, "Four talkers changed the level");
+}
+
+ZTEST(mixer_automix, test_silence_shared_evenly) {
+    float gains[CHANNELS];
+
+    run(SETTLE_BLOCKS);
+    audio_mixer_get_automix_gains(&mixer, gains, CHANNELS);
+
+    for (size_t ch = 0; ch < CHANNELS; ch++) {
+        zassert_within(gains[ch], sqrtf(1.0f / CHANNELS), 0.02f, "Channel %u at %.3f", ch,
+                       (double)gains[ch]);
+    }
+}
+
+ZTEST(mixer_automix, test_gain_ramps) {
+    silence_all(true);
+    talk(0, TALK_LEVEL);
+    run(SETTLE_BLOCKS);
+
+    /* Talker hands over: the mix of two constants must move without steps */
+    talk(0, 0.0f);
+    talk(1, TALK_LEVEL);
+
+    int16_t prev = 0;
+    int32_t max_step = 0;
+    for (size_t b = 0; b < SETTLE_BLOCKS; b++) {
+        struct audio_block *in = audio_block_alloc();
+        zassert_not_null(in, "Pool exhausted");
+        in->data_len = BLOCK;
+
+        struct audio_block *out = audio_mixer_process_block(&mixer, in);
+        for (size_t i = 0; i < BLOCK; i++) {
+            if (b || i) {
+                max_step = MAX(max_step, abs(out->data[i] - prev));
+            }
+            prev = out->data[i];
+        }
+        audio_block_release(out);
+    }
+
+    TC_PRINT("Largest sample step during the handover: %d\n", max_step);
+
+    /* A full gain swing spread over one block at most */
+    zassert_true(max_step <= (int32_t)(TALK_LEVEL / BLOCK) + 2, "Gain stepped by %d", max_step);
+    zassert_within(prev, TALK_LEVEL, 0.05f * TALK_LEVEL, "Handover incomplete");
+}
+
+ZTEST(mixer_automix, test_off_and_config) {
+    struct audio_mixer_automix_config bad = AUDIO_MIXER_AUTOMIX_DEFAULT_CONFIG;
+
+    bad.attack_ms = 0;
+    zassert_equal(audio_mixer_set_automix(&mixer, &bad), -EINVAL, "Zero attack accepted");
+
+    /* Off: plain sum of all channels */
+    zassert_ok(audio_mixer_set_automix(&mixer, NULL), "Disable failed");
+    silence_all(true);
+    talk(3, 100.0f);
+    talk(4, 200.0f);
+    zassert_within(run(1), 300.0f, 0.5f, "Plain sum not restored");
+}
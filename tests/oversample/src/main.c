@@ -0,0 +1,170 @@
+/**
+ * @file main.c
+ * @brief Oversampling wrapper: latency, transparency, alias rejection
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <audio_fw_v2.h>
+#include <math.h>
+
+#define RATE            CONFIG_AUDIO_SAMPLE_RATE
+#define BLOCK           CONFIG_AUDIO_BLOCK_SAMPLES
+#define BLOCKS          16
+#define TOTAL           (BLOCKS * BLOCK)
+#define CLIP_LEVEL      8000
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* Pass-through that records what the wrapper hands it */
+struct probe {
+    uint32_t rate;
+    size_t last_len;
+};
+
+static struct audio_block *probe_process(struct audio_node *self, struct audio_block *in) {
+    ((struct probe *)self->ctx)->last_len = in->data_len;
+    return in;
+}
+
+static void probe_set_sample_rate(struct audio_node *self, uint32_t rate) {
+    ((struct probe *)self->ctx)->rate = rate;
+}
+
+static const struct audio_node_api probe_api = {
+    .process = probe_process,
+    .set_sample_rate = probe_set_sample_rate,
+};
+
+/* Hard clipper, the worst case for aliasing */
+static struct audio_block *clip_process(struct audio_node *self, struct audio_block *in) {
+    for (size_t i = 0; i < in->data_len; i++) {
+        in->data[i] = CLAMP(in->data[i], -CLIP_LEVEL, CLIP_LEVEL);
+    }
+    return in;
+}
+
+static const struct audio_node_api clip_api = {
+    .process = clip_process,
+};
+
+static struct probe probes[2];
+static struct audio_node inner2 = { .vtable = &probe_api, .ctx = &probes[0] };
+static struct audio_node inner4 = { .vtable = &probe_api, .ctx = &probes[1] };
+static struct audio_node clip_inner = { .vtable = &clip_api };
+static struct audio_node clip_plain = { .vtable = &clip_api };
+static struct audio_node os2, os4, os_clip;
+
+static int16_t input[TOTAL];
+static int16_t output[TOTAL];
+
+static void make_sine(float freq, float amplitude) {
+    for (size_t i = 0; i < TOTAL; i++) {
+        input[i] = (int16_t)(amplitude * sinf(2.0f * (float)M_PI * freq * i / RATE));
+    }
+}
+
+static void run(struct audio_node *node) {
+    for (size_t b = 0; b < BLOCKS; b++) {
+        struct audio_block *block = audio_block_alloc();
+        zassert_not_null(block, "Pool exhausted");
+
+        memcpy(block->data, &input[b * BLOCK], BLOCK * sizeof(int16_t));
+        block->data_len = BLOCK;
+
+        struct audio_block *out = audio_node_process(node, block);
+        zassert_not_null(out, "Wrapper dropped a block");
+        memcpy(&output[b * BLOCK], out->data, BLOCK * sizeof(int16_t));
+        audio_block_release(out);
+    }
+}
+
+/* Goertzel magnitude of one bin over the settled second half */
+static float tone_level(const int16_t *x, float freq) {
+    const size_t n = TOTAL / 2;
+    float coeff = 2.0f * cosf(2.0f * (float)M_PI * freq / RATE);
+    float s1 = 0.0f, s2 = 0.0f;
+
+    for (size_t i = 0; i < n; i++) {
+        float s = x[TOTAL - n + i] + coeff * s1 - s2;
+        s2 = s1;
+        s1 = s;
+    }
+    return sqrtf(s1 * s1 + s2 * s2 - coeff * s1 * s2) / n;
+}
+
+static void *setup(void) {
+    zassert_ok(node_oversample_init(&os2, &inner2, 2), "2x init failed");
+    zassert_ok(node_oversample_init(&os4, &inner4, 4), "4x init failed");
+    zassert_ok(node_oversample_init(&os_clip, &clip_inner, 4), "Clip init failed");
+    return NULL;
+}
+
+static void before(void *f) {
+    audio_node_reset(&os2);
+    audio_node_reset(&os4);
+    audio_node_reset(&os_clip);
+}
+
+ZTEST_SUITE(oversample, NULL, setup, before, NULL, NULL);
+
+ZTEST(oversample, test_bad_factor) {
+    struct audio_node node;
+    zassert_equal(node_oversample_init(&node, &inner2, 3), -EINVAL, "Factor 3 accepted");
+}
+
+ZTEST(oversample, test_latency_reported) {
+    zassert_equal(node_oversample_get_latency(&os2), CONFIG_AUDIO_OVERSAMPLE_TAPS - 1,
+                  "Wrong 2x latency");
+    zassert_equal(node_oversample_get_latency(&os4),
+                  CONFIG_AUDIO_OVERSAMPLE_TAPS - 1 + CONFIG_AUDIO_OVERSAMPLE_STAGE2_TAPS / 2,
+                  "Wrong 4x latency");
+    zassert_equal(node_oversample_get_latency(&inner2), 0, "Latency read from a non-wrapper");
+}
+
+ZTEST(oversample, test_inner_runs_at_oversampled_rate) {
+    make_sine(1000.0f, 10000.0f);
+    run(&os2);
+    run(&os4);
+
+    zassert_equal(probes[0].rate, 2 * RATE, "2x inner rate");
+    zassert_equal(probes[1].rate, 4 * RATE, "4x inner rate");
+    zassert_equal(probes[0].last_len, BLOCK, "2x chunks must fill a block");
+    zassert_equal(probes[1].last_len, BLOCK, "4x chunks must fill a block");
+}
+
+static void check_transparent(struct audio_node *node) {
+    uint32_t latency = node_oversample_get_latency(node);
+
+    make_sine(1000.0f, 10000.0f);
+    run(node);
+
+    for (size_t i = TOTAL / 2; i < TOTAL; i++) {
+        zassert_within(output[i], input[i - latency], 4,
+                       "Output %d is not the input delayed by %u", i, latency);
+    }
+}
+
+ZTEST(oversample, test_passthrough_2x) {
+    check_transparent(&os2);
+}
+
+ZTEST(oversample, test_passthrough_4x) {
+    check_transparent(&os4);
+}
+
+ZTEST(oversample, test_clipping_aliases_less) {
+    /* 9 kHz clipped: the 5th harmonic (45 kHz) folds to 3 kHz at 48 kHz */
+    make_sine(9000.0f, 20000.0f);
+
+    run(&clip_plain);
+    float plain = tone_level(output, 3000.0f);
+
+    run(&os_clip);
+    float oversampled = tone_level(output, 3000.0f);
+
+    TC_PRINT("3 kHz alias: plain %.1f, 4x %.1f\n", (double)plain, (double)oversampled);
+    zassert_true(oversampled * 10.0f < plain, "Oversampling did not reduce aliasing");
+}
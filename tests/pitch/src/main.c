@@ -0,0 +1,170 @@
+/**
+ * @file main.c
+ * @brief YIN pitch detector: accuracy, voicing, hop cadence
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <audio_fw_v2.h>
+#include <math.h>
+
+#define RATE            CONFIG_AUDIO_SAMPLE_RATE
+#define BLOCK           CONFIG_AUDIO_BLOCK_SAMPLES
+#define HOP             512
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static struct audio_node pitch, narrow;
+static uint32_t rng_state = 2463534242u;
+
+enum signal {
+    SIGNAL_SINE,
+    SIGNAL_SAW,         /* Rich harmonics, the fundamental must win */
+    SIGNAL_NOISE,
+    SIGNAL_SILENCE,
+};
+
+static float white(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (float)rng_state / 4294967296.0f * 2.0f - 1.0f;
+}
+
+/* Feeds 'seconds' of a signal, checks audio passes untouched */
+static void feed(struct audio_node *node, enum signal type, float freq, float seconds) {
+    static float phase;
+    size_t blocks = (size_t)(seconds * RATE) / BLOCK;
+
+    for (size_t b = 0; b < blocks; b++) {
+        struct audio_block *block = audio_block_alloc();
+        int16_t copy[BLOCK];
+        zassert_not_null(block, "Pool exhausted");
+
+        for (size_t i = 0; i < BLOCK; i++) {
+            float x = 0.0f;
+            phase = fmodf(phase + freq / RATE, 1.0f);
+            switch (type) {
+            case SIGNAL_SINE:
+                x = sinf(2.0f * (float)M_PI * phase);
+                break;
+            case SIGNAL_SAW:
+                x = 2.0f * phase - 1.0f;
+                break;
+            case SIGNAL_NOISE:
+                x = white();
+                break;
+            case SIGNAL_SILENCE:
+                break;
+            }
+            block->data[i] = (int16_t)(x * 12000.0f);
+            copy[i] = block->data[i];
+        }
+        block->data_len = BLOCK;
+
+        block = audio_node_process(node, block);
+        zassert_mem_equal(block->data, copy, sizeof(copy), "Pitch detector modified audio");
+        audio_block_release(block);
+    }
+}
+
+static void *setup(void) {
+    struct pitch_config cfg = PITCH_DEFAULT_CONFIG;
+
+    zassert_ok(node_pitch_init(&pitch, NULL), "Init failed");
+
+    cfg.min_hz = 200.0f;
+    cfg.max_hz = 400.0f;
+    zassert_ok(node_pitch_init(&narrow, &cfg), "Narrow-range init failed");
+    return NULL;
+}
+
+static void before(void *f) {
+    audio_node_reset(&pitch);
+    audio_node_reset(&narrow);
+}
+
+ZTEST_SUITE(pitch, NULL, setup, before, NULL, NULL);
+
+static void check_pitch(enum signal type, float freq) {
+    struct pitch_result result;
+
+    feed(&pitch, type, freq, 0.2f);
+    zassert_ok(node_pitch_get(&pitch, &result), "No estimate");
+    zassert_true(result.voiced, "%d Hz not voiced", (int)freq);
+    zassert_within(result.frequency_hz, freq, freq * 0.005f, "Expected %d Hz, got %d.%02d Hz",
+                   (int)freq, (int)result.frequency_hz,
+                   (int)(result.frequency_hz * 100) % 100);
+    zassert_true(result.confidence > 0.9f, "Low confidence on a clean tone");
+}
+
+ZTEST(pitch, test_sine_accuracy) {
+    check_pitch(SIGNAL_SINE, 82.4f);
+    check_pitch(SIGNAL_SINE, 220.0f);
+    check_pitch(SIGNAL_SINE, 440.0f);
+    check_pitch(SIGNAL_SINE, 987.8f);
+}
+
+ZTEST(pitch, test_harmonic_tone) {
+    check_pitch(SIGNAL_SAW, 110.0f);
+    check_pitch(SIGNAL_SAW, 261.6f);
+}
+
+ZTEST(pitch, test_noise_unvoiced) {
+    struct pitch_result result;
+
+    feed(&pitch, SIGNAL_NOISE, 0.0f, 0.2f);
+    zassert_ok(node_pitch_get(&pitch, &result), "No estimate");
+    zassert_false(result.voiced, "Noise reported voiced at %d Hz", (int)result.frequency_hz);
+    zassert_equal(result.frequency_hz, 0.0f, "Unvoiced estimate carries a frequency");
+}
+
+ZTEST(pitch, test_silence_unvoiced) {
+    struct pitch_result result;
+
+    feed(&pitch, SIGNAL_SILENCE, 0.0f, 0.1f);
+    zassert_ok(node_pitch_get(&pitch, &result), "No estimate");
+    zassert_false(result.voiced, "Silence reported voiced");
+    zassert_equal(result.confidence, 0.0f, "Confidence on silence");
+}
+
+ZTEST(pitch, test_hop_cadence) {
+    struct pitch_result first, last;
+
+    zassert_equal(node_pitch_get(&narrow, &first), -EAGAIN, "Estimate before a full frame");
+
+    /* The narrow range needs a shorter frame than the default one */
+    feed(&narrow, SIGNAL_SINE, 300.0f, 0.05f);
+    zassert_ok(node_pitch_get(&narrow, &first), "No estimate after a frame");
+    feed(&narrow, SIGNAL_SINE, 300.0f, (float)(16 * HOP) / RATE);
+    zassert_ok(node_pitch_get(&narrow, &last), "No estimate");
+
+    zassert_equal(last.sequence - first.sequence, 16, "Expected one estimate per hop");
+    zassert_within(last.frequency_hz, 300.0f, 1.5f, "Narrow range missed 300 Hz");
+}
+
+ZTEST(pitch, test_range_limits) {
+    struct pitch_result result;
+
+    /* 150 Hz is below the narrow range: no lag there, no voiced estimate */
+    feed(&narrow, SIGNAL_SINE, 150.0f, 0.1f);
+    zassert_ok(node_pitch_get(&narrow, &result), "No estimate");
+    zassert_true(!result.voiced || result.frequency_hz >= 200.0f,
+                 "Estimate outside the configured range");
+}
+
+ZTEST(pitch, test_rejects_bad_config) {
+    struct audio_node node;
+    struct pitch_config cfg = PITCH_DEFAULT_CONFIG;
+
+    cfg.min_hz = 5.0f;
+    zassert_equal(node_pitch_init(&node, &cfg), -EINVAL, "Frame beyond the FFT accepted");
+    cfg.min_hz = 500.0f;
+    cfg.max_hz = 400.0f;
+    zassert_equal(node_pitch_init(&node, &cfg), -EINVAL, "Inverted range accepted");
+    cfg.max_hz = 1000.0f;
+    cfg.hop_size = 300;
+    zassert_equal(node_pitch_init(&node, &cfg), -EINVAL, "Non power of two hop accepted");
+}
@@ -0,0 +1,70 @@
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <audio_fw_v2.h>
+
+/*
+ * Section names are the Kconfig defaults (audio_pool, audio_node_state,
+ * audio_hot). Being valid C identifiers, the linker provides start/stop
+ * symbols for them.
+ */
+extern char __start_audio_pool[];
+extern char __stop_audio_pool[];
+extern char __start_audio_node_state[];
+extern char __stop_audio_node_state[];
+extern char __start_audio_hot[];
+extern char __stop_audio_hot[];
+
+static bool in_section(const void *ptr, const char *start, const char *stop) {
+    const char *p = (const char *)ptr;
+    return (p >= start) && (p < stop);
+}
+
+/* Application node arena, placed like the framework's own arenas */
+static uint32_t __audio_node_state test_arena[4];
+
+static void *setup(void) {
+    return NULL;
+}
+
+ZTEST_SUITE(audio_placement, NULL, setup, NULL, NULL, NULL);
+
+ZTEST(audio_placement, test_pool_in_section) {
+    struct audio_block *block = audio_block_alloc();
+    zassert_not_null(block, "Alloc failed");
+
+    zassert_true(in_section(block->data, __start_audio_pool, __stop_audio_pool),
+                 "Payload %p outside audio_pool", block->data);
+    zassert_true(in_section(block, __start_audio_pool, __stop_audio_pool),
+                 "Header %p outside audio_pool", block);
+
+    audio_block_release(block);
+}
+
+ZTEST(audio_placement, test_node_state_in_section) {
+    zassert_true(in_section(test_arena, __start_audio_node_state, __stop_audio_node_state),
+                 "Node arena %p outside audio_node_state", test_arena);
+}
+
+ZTEST(audio_placement, test_framework_node_state_in_section) {
+    /* Contexts handed out by the framework's own node arenas */
+    struct audio_node vol = { 0 }, sine = { 0 };
+
+    node_vol_init(&vol, 1.0f);
+    node_sine_init(&sine, 440.0f);
+    zassert_not_null(vol.ctx, "Volume node has no context");
+    zassert_not_null(sine.ctx, "Sine node has no context");
+
+    zassert_true(in_section(vol.ctx, __start_audio_node_state, __stop_audio_node_state),
+                 "Volume context %p outside audio_node_state", vol.ctx);
+    zassert_true(in_section(sine.ctx, __start_audio_node_state, __stop_audio_node_state),
+                 "Sine context %p outside audio_node_state", sine.ctx);
+}
+
+ZTEST(audio_placement, test_hot_code_in_section) {
+    zassert_true(in_section((const void *)audio_block_alloc, __start_audio_hot, __stop_audio_hot),
+                 "audio_block_alloc not in audio_hot");
+    zassert_true(in_section((const void *)audio_block_release, __start_audio_hot, __stop_audio_hot),
+                 "audio_block_release not in audio_hot");
+    zassert_true(in_section((const void *)audio_block_get_writable, __start_audio_hot, __stop_audio_hot),
+                 "audio_block_get_writable not in audio_hot");
+}
@@ -0,0 +1,122 @@
+/**
+ * @file main.c
+ * @brief Guaranteed per-class block reservations
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <audio_fw.h>
+
+#define POOL            CONFIG_AUDIO_MEM_SLAB_COUNT
+#define CLASS_MONITOR   1
+#define CLASS_BULK      2
+#define MONITOR_BLOCKS  4
+
+static struct audio_block *held[POOL];
+
+static size_t drain(uint8_t cls, struct audio_block **out, size_t max) {
+    size_t n = 0;
+
+    while (n < max) {
+        struct audio_block *b = audio_block_alloc_class(cls);
+        if (!b) {
+            break;
+        }
+        out[n++] = b;
+    }
+    return n;
+}
+
+static void release_all(struct audio_block **blocks, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        audio_block_release(blocks[i]);
+    }
+}
+
+static void before(void *f) {
+    zassert_ok(audio_pool_reserve(CLASS_MONITOR, MONITOR_BLOCKS), "Reserve failed");
+}
+
+static void after(void *f) {
+    audio_pool_reserve(CLASS_MONITOR, 0);
+    audio_pool_unbind_thread(k_current_get());
+}
+
+ZTEST_SUITE(pool_reserve, NULL, NULL, before, after, NULL);
+
+ZTEST(pool_reserve, test_bulk_cannot_take_reserved_blocks) {
+    struct audio_pool_stats stats;
+
+    size_t bulk = drain(CLASS_BULK, held, POOL);
+    zassert_equal(bulk, POOL - MONITOR_BLOCKS, "Bulk got %zu blocks", bulk);
+
+    audio_pool_stats_get(CLASS_BULK, &stats);
+    zassert_equal(stats.denials, 1, "Denial not counted");
+
+    /* The monitor still gets its guaranteed blocks */
+    size_t monitor = drain(CLASS_MONITOR, held + bulk, POOL - bulk);
+    zassert_equal(monitor, MONITOR_BLOCKS, "Monitor got %zu blocks", monitor);
+
+    audio_pool_stats_get(CLASS_MONITOR, &stats);
+    zassert_equal(stats.used, MONITOR_BLOCKS, "Monitor usage wrong");
+    zassert_equal(stats.shared_free, 0, "Shared region should be empty");
+
+    release_all(held, bulk + monitor);
+
+    audio_pool_stats_get(CLASS_BULK, &stats);
+    zassert_equal(stats.used, 0, "Bulk blocks not uncharged");
+}
+
+ZTEST(pool_reserve, test_reserve_while_overflowing) {
+    struct audio_pool_stats stats;
+
+    /* Bulk takes the whole shared region */
+    size_t bulk = drain(CLASS_BULK, held, POOL);
+    zassert_equal(bulk, POOL - MONITOR_BLOCKS, "Bulk got %zu blocks", bulk);
+
+    /* Nothing shared is left to reserve; growing one would wrap the free count */
+    zassert_equal(audio_pool_reserve(CLASS_MONITOR, MONITOR_BLOCKS + 1), -ENOMEM,
+                  "Reserved blocks that overflow allocations hold");
+
+    audio_pool_stats_get(CLASS_MONITOR, &stats);
+    zassert_equal(stats.reserved, MONITOR_BLOCKS, "Failed reserve changed the class");
+    zassert_equal(stats.shared_free, 0, "Shared free count wrong");
+
+    /* Once one is returned it can be reserved */
+    audio_block_release(held[--bulk]);
+    zassert_ok(audio_pool_reserve(CLASS_MONITOR, MONITOR_BLOCKS + 1), "Reserve failed");
+    audio_pool_stats_get(CLASS_MONITOR, &stats);
+    zassert_equal(stats.shared_free, 0, "Shared free count wrong");
+
+    release_all(held, bulk);
+}
+
+ZTEST(pool_reserve, test_reserved_class_overflows_into_shared) {
+    size_t n = drain(CLASS_MONITOR, held, POOL);
+    zassert_equal(n, POOL, "Reserved class should also use the shared region");
+    release_all(held, n);
+}
+
+ZTEST(pool_reserve, test_thread_binding_applies_to_alloc_and_cow) {
+    struct audio_pool_stats stats;
+
+    zassert_ok(audio_pool_bind_thread(k_current_get(), CLASS_MONITOR), "Bind failed");
+
+    struct audio_block *block = audio_block_alloc();
+    zassert_not_null(block, "Alloc failed");
+
+    atomic_inc(&block->ref_count);
+    struct audio_block *shared = block;
+    zassert_ok(audio_block_get_writable(&block), "CoW failed");
+
+    audio_pool_stats_get(CLASS_MONITOR, &stats);
+    zassert_equal(stats.used, 2, "Alloc and CoW copy should be charged to the bound class");
+
+    audio_block_release(shared);
+    audio_block_release(block);
+}
+
+ZTEST(pool_reserve, test_overcommit_rejected) {
+    zassert_equal(audio_pool_reserve(CLASS_BULK, POOL), -ENOMEM, "Overcommit accepted");
+    zassert_equal(audio_pool_reserve(CONFIG_AUDIO_POOL_CLASSES, 1), -EINVAL, "Bad class accepted");
+}
@@ -0,0 +1,205 @@
+/**
+ * @file main.c
+ * @brief Spectrum analyzer classifier features and feature ring
+ *
+ * Runs in float and (testcase.yaml) Q15; all checks go through the
+ * audio_feature_*_to_float() helpers.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <audio_fw_v2.h>
+#include <audio_features.h>
+#include <math.h>
+
+#define RATE            CONFIG_AUDIO_SAMPLE_RATE
+#define BLOCK           CONFIG_AUDIO_BLOCK_SAMPLES
+#define FFT_SIZE        1024
+#define NYQUIST         (RATE / 2.0f)
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+enum signal {
+    SIGNAL_SILENCE,
+    SIGNAL_SINE,        /* 1 kHz */
+    SIGNAL_NOISE,
+    SIGNAL_MIX,         /* Sine plus noise, for the MFCC gain check */
+};
+
+static struct audio_node analyzer, plain;
+static uint32_t rng_state;
+static size_t sample_index;
+
+static float white(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (float)rng_state / 4294967296.0f * 2.0f - 1.0f;
+}
+
+static void feed(struct audio_node *node, enum signal type, float gain, size_t frames) {
+    for (size_t b = 0; b < frames * FFT_SIZE / BLOCK; b++) {
+        struct audio_block *block = audio_block_alloc();
+        zassert_not_null(block, "Pool exhausted");
+
+        for (size_t i = 0; i < BLOCK; i++, sample_index++) {
+            float sine = sinf(2.0f * (float)M_PI * 1000.0f * sample_index / RATE);
+            float x = 0.0f;
+
+            switch (type) {
+            case SIGNAL_SILENCE:
+                break;
+            case SIGNAL_SINE:
+                x = sine;
+                break;
+            case SIGNAL_NOISE:
+                x = white();
+                break;
+            case SIGNAL_MIX:
+                x = 0.5f * sine + 0.3f * white();
+                break;
+            }
+            block->data[i] = (int16_t)(x * gain * 8000.0f);
+        }
+        block->data_len = BLOCK;
+
+        block = audio_node_process(node, block);
+        audio_block_release(block);
+    }
+}
+
+/* Copies the newest queued frame, drains the rest */
+static struct audio_feature_frame latest(void) {
+    const struct audio_feature_frame *frame;
+    struct audio_feature_frame copy;
+    int frames = 0;
+
+    while (node_spectrum_analyzer_get_features(&analyzer, &frame) == 0) {
+        copy = *frame;
+        zassert_ok(node_spectrum_analyzer_release_features(&analyzer), "Release failed");
+        frames++;
+    }
+    zassert_true(frames > 0, "No feature frame queued");
+    return copy;
+}
+
+static void *setup(void) {
+    struct spectrum_analyzer_config cfg = SPECTRUM_ANALYZER_DEFAULT_CONFIG;
+
+    cfg.fft_size = FFT_SIZE;
+    cfg.compute_features = true;
+    zassert_ok(node_spectrum_analyzer_init_ex(&analyzer, &cfg), "Init failed");
+
+    cfg.compute_features = false;
+    zassert_ok(node_spectrum_analyzer_init_ex(&plain, &cfg), "Init failed");
+    return NULL;
+}
+
+static void before(void *f) {
+    const struct audio_feature_frame *frame;
+
+    audio_node_reset(&analyzer);
+    while (node_spectrum_analyzer_get_features(&analyzer, &frame) == 0) {
+        node_spectrum_analyzer_release_features(&analyzer);
+    }
+    rng_state = 2463534242u;
+    sample_index = 0;
+}
+
+ZTEST_SUITE(spectrum_features, NULL, setup, before, NULL, NULL);
+
+ZTEST(spectrum_features, test_sine) {
+    feed(&analyzer, SIGNAL_SINE, 1.0f, 4);
+    struct audio_feature_frame f = latest();
+
+    zassert_within(audio_feature_to_float(f.centroid) * NYQUIST, 1000.0f, 100.0f,
+                   "Centroid off the tone");
+    zassert_within(audio_feature_to_float(f.rolloff) * NYQUIST, 1000.0f, 2 * NYQUIST / 512,
+                   "Rolloff off the tone");
+    zassert_true(audio_feature_to_float(f.flatness) < 0.01f, "Tone not tonal");
+    zassert_true(audio_feature_to_float(f.flux) < 0.05f, "Flux on a steady tone");
+}
+
+ZTEST(spectrum_features, test_noise) {
+    feed(&analyzer, SIGNAL_NOISE, 1.0f, 8);
+    struct audio_feature_frame f = latest();
+
+    /* Exponentially distributed bin powers: geometric / arithmetic mean = e^-gamma */
+    zassert_within(audio_feature_to_float(f.flatness), 0.56f, 0.1f, "White noise not flat");
+    zassert_within(audio_feature_to_float(f.centroid), 0.5f, 0.05f, "Centroid not mid-band");
+    zassert_within(audio_feature_to_float(f.rolloff), 0.85f, 0.05f, "Rolloff not at 85 %");
+}
+
+ZTEST(spectrum_features, test_onset_flux) {
+    feed(&analyzer, SIGNAL_SILENCE, 1.0f, 2);
+    latest();
+    feed(&analyzer, SIGNAL_NOISE, 1.0f, 1);
+    struct audio_feature_frame f = latest();
+
+    zassert_true(audio_feature_to_float(f.flux) > 0.5f, "Onset without flux");
+}
+
+ZTEST(spectrum_features, test_reset_restarts_flux) {
+    /* Same onset as above, but a reset in between forgets the silence */
+    feed(&analyzer, SIGNAL_SILENCE, 1.0f, 2);
+    latest();
+    audio_node_reset(&analyzer);
+    feed(&analyzer, SIGNAL_NOISE, 1.0f, 1);
+    struct audio_feature_frame f = latest();
+
+    zassert_equal(audio_feature_to_float(f.flux), 0.0f, "Flux against the pre-reset spectrum");
+}
+
+ZTEST(spectrum_features, test_mfcc_gain) {
+    /* Amplitude x2 adds ln(4) to every log band: c0 moves by sqrt(bands) ln 4 */
+    feed(&analyzer, SIGNAL_MIX, 1.0f, 4);
+    struct audio_feature_frame quiet = latest();
+
+    before(NULL);
+    feed(&analyzer, SIGNAL_MIX, 2.0f, 4);
+    struct audio_feature_frame loud = latest();
+
+    float shift = sqrtf((float)CONFIG_AUDIO_FEATURE_MEL_BANDS) * logf(4.0f);
+    zassert_within(audio_feature_mfcc_to_float(loud.mfcc[0]) -
+                   audio_feature_mfcc_to_float(quiet.mfcc[0]), shift, 0.1f, "c0 shift");
+
+    for (size_t i = 1; i < CONFIG_AUDIO_FEATURE_MFCC_COEFFS; i++) {
+        zassert_within(audio_feature_mfcc_to_float(loud.mfcc[i]),
+                       audio_feature_mfcc_to_float(quiet.mfcc[i]), 0.1f,
+                       "c%d depends on the level", i);
+    }
+}
+
+ZTEST(spectrum_features, test_ring) {
+    const struct audio_feature_frame *frame;
+    const size_t extra = 3;
+
+    /* First frame once FFT_SIZE samples are in, then one per FFT_SIZE */
+    feed(&analyzer, SIGNAL_NOISE, 1.0f, CONFIG_AUDIO_FEATURE_RING_FRAMES + extra);
+
+    uint32_t dropped = node_spectrum_analyzer_get_features_dropped(&analyzer);
+    zassert_ok(node_spectrum_analyzer_get_features(&analyzer, &frame), "Ring empty");
+    uint32_t first = frame->sequence;
+
+    for (size_t i = 0; i < CONFIG_AUDIO_FEATURE_RING_FRAMES; i++) {
+        zassert_ok(node_spectrum_analyzer_get_features(&analyzer, &frame), "Frame missing");
+        zassert_equal(frame->sequence, first + i, "Frames out of order");
+        zassert_ok(node_spectrum_analyzer_release_features(&analyzer), "Release failed");
+    }
+
+    zassert_equal(node_spectrum_analyzer_get_features(&analyzer, &frame), -EAGAIN,
+                  "Ring not empty");
+    zassert_true(node_spectrum_analyzer_get_features_dropped(&analyzer) - dropped == 0,
+                 "Drop count changed while reading");
+    zassert_true(dropped >= extra, "Overflow not counted");
+}
+
+ZTEST(spectrum_features, test_not_enabled) {
+    const struct audio_feature_frame *frame;
+
+    feed(&plain, SIGNAL_SINE, 1.0f, 2);
+    zassert_equal(node_spectrum_analyzer_get_features(&plain, &frame), -ENOTSUP,
+                  "Features from an analyzer without them");
+}
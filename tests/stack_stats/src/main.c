@@ -0,0 +1,154 @@
+/**
+ * @file main.c
+ * @brief Stack high-water tracking, entry reuse and profiled strip stacks
+ *
+ * Runs on QEMU only: native_sim threads execute on host stacks, so the
+ * Zephyr stack buffers never see the node's frame.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <string.h>
+#include <audio_fw_v2.h>
+#include <channel_strip.h>
+#include <audio_stack.h>
+
+#define STACK_SIZE  2048
+#define FRAME_SIZE  512
+
+K_THREAD_STACK_DEFINE(strip_stack, STACK_SIZE);
+
+/* Pass-through with a stack frame of known size */
+static struct audio_block *frame_process(struct audio_node *self, struct audio_block *in) {
+    volatile uint8_t frame[FRAME_SIZE];
+
+    for (size_t i = 0; i < sizeof(frame); i++) {
+        frame[i] = (uint8_t)i;
+    }
+    return in;
+}
+
+static const struct audio_node_api frame_api = {
+    .process = frame_process,
+};
+
+static struct audio_node frame_node = { .vtable = &frame_api };
+static struct channel_strip strip;
+static struct k_fifo strip_out;
+static int prio;
+
+static struct audio_stack_profile_entry profile[1];
+
+static void cycle(void) {
+    struct audio_block *block = audio_block_alloc();
+    zassert_not_null(block, "Pool exhausted");
+
+    channel_strip_push_input(&strip, block);
+    block = k_fifo_get(&strip_out, K_MSEC(100));
+    zassert_not_null(block, "Strip produced no output");
+    audio_block_release(block);
+}
+
+/* Entry of the tracking table registered under name, or -ENOENT */
+static int find_stats(const char *name, struct audio_stack_stats *stats) {
+    for (size_t i = 0; audio_stack_stats_get(i, stats) == 0; i++) {
+        if (stats->name && strcmp(stats->name, name) == 0) {
+            return (int)i;
+        }
+    }
+    return -ENOENT;
+}
+
+static size_t entry_count(void) {
+    struct audio_stack_stats stats;
+    size_t n = 0;
+
+    while (audio_stack_stats_get(n, &stats) == 0) {
+        n++;
+    }
+    return n;
+}
+
+static void *setup(void) {
+    prio = k_thread_priority_get(k_current_get()) - 1;
+
+    k_fifo_init(&strip_out);
+    channel_strip_init(&strip, "stack");
+    channel_strip_add_node(&strip, &frame_node);
+    strip.out_fifo = &strip_out;
+    return NULL;
+}
+
+static void before(void *fixture) {
+    channel_strip_start(&strip, strip_stack, STACK_SIZE, prio);
+}
+
+static void after(void *fixture) {
+    channel_strip_stop(&strip);
+}
+
+ZTEST_SUITE(stack_stats, NULL, setup, before, after, NULL);
+
+ZTEST(stack_stats, test_tracks_strip_usage) {
+    struct audio_stack_stats stats;
+
+    cycle();
+
+    zassert_true(find_stats("stack", &stats) >= 0, "Strip not tracked");
+    zassert_equal(stats.size, STACK_SIZE, "Wrong stack size %zu", stats.size);
+    zassert_true(stats.used >= FRAME_SIZE, "Node frame not seen, used %zu", stats.used);
+    zassert_true(stats.used < stats.size, "Used %zu of %zu", stats.used, stats.size);
+    zassert_true(stats.recommended >= stats.used + CONFIG_AUDIO_STACK_MARGIN,
+                 "Recommended %zu lacks the margin", stats.recommended);
+}
+
+ZTEST(stack_stats, test_restart_reuses_entry) {
+    struct audio_stack_stats stats;
+
+    cycle();
+    int index = find_stats("stack", &stats);
+    zassert_true(index >= 0, "Strip not tracked");
+    size_t count = entry_count();
+    size_t used = stats.used;
+
+    for (int i = 0; i < 3; i++) {
+        channel_strip_stop(&strip);
+        channel_strip_start(&strip, strip_stack, STACK_SIZE, prio);
+    }
+
+    zassert_equal(entry_count(), count, "Restart added a tracking entry");
+    zassert_equal(find_stats("stack", &stats), index, "Restart moved the entry");
+    zassert_true(stats.used >= used, "High-water mark lost: %zu < %zu", stats.used, used);
+
+    /* The reused entry follows the new thread */
+    cycle();
+    zassert_ok(audio_stack_stats_get(index, &stats), "Entry vanished");
+    zassert_true(stats.used >= FRAME_SIZE, "Restarted thread not sampled");
+}
+
+ZTEST(stack_stats, test_start_profiled) {
+    struct audio_stack_stats stats;
+
+    cycle();
+    zassert_true(find_stats("stack", &stats) >= 0, "Strip not tracked");
+    size_t peak = stats.used;
+
+    /* Same table audio_stack_stats_report() prints */
+    profile[0].name = stats.name;
+    profile[0].stack_size = stats.recommended;
+    audio_stack_profile_set(profile, ARRAY_SIZE(profile));
+    zassert_equal(audio_stack_profile_lookup("stack", 0), stats.recommended,
+                  "Profile table does not contain the strip");
+
+    channel_strip_stop(&strip);
+    zassert_ok(channel_strip_start_profiled(&strip, prio), "Profiled start failed");
+    zassert_not_null(strip.dyn_stack, "No stack allocated");
+
+    cycle();
+    zassert_true(find_stats("stack", &stats) >= 0, "Profiled strip not tracked");
+    zassert_equal(stats.size, profile[0].stack_size, "Profiled size not used");
+    zassert_true(stats.size >= peak, "Recommended %zu below the peak %zu", stats.size, peak);
+    zassert_true(stats.used <= stats.size, "Profiled stack overflowed");
+
+    audio_stack_profile_set(NULL, 0);
+}
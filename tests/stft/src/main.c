@@ -0,0 +1,163 @@
+/**
+ * @file main.c
+ * @brief STFT base: reconstruction, frame cadence, analysis-only mode
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <audio_fw_v2.h>
+#include <audio_stft.h>
+#include <math.h>
+
+#define RATE            CONFIG_AUDIO_SAMPLE_RATE
+#define BLOCK           CONFIG_AUDIO_BLOCK_SAMPLES
+#define FFT_SIZE        256
+#define BLOCKS          16
+#define TOTAL           (BLOCKS * BLOCK)
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* Scales every bin by *user_data */
+static void gain_frame(struct audio_stft *stft, float *spec, void *user_data) {
+    float gain = *(float *)user_data;
+
+    for (size_t k = 0; k < stft->config.fft_size; k++) {
+        spec[k] *= gain;
+    }
+}
+
+static float gain_half = 1.0f;
+static float gain_quarter = 1.0f;
+static uint32_t analysis_calls;
+
+static void count_frame(struct audio_stft *stft, float *spec, void *user_data) {
+    analysis_calls++;
+}
+
+static struct audio_node half_hop, quarter_hop, analysis, analyzer;
+static int16_t input[TOTAL];
+static int16_t output[TOTAL];
+
+static void run(struct audio_node *node) {
+    for (size_t b = 0; b < BLOCKS; b++) {
+        struct audio_block *block = audio_block_alloc();
+        zassert_not_null(block, "Pool exhausted");
+
+        memcpy(block->data, &input[b * BLOCK], BLOCK * sizeof(int16_t));
+        block->data_len = BLOCK;
+
+        block = audio_node_process(node, block);
+        memcpy(&output[b * BLOCK], block->data, BLOCK * sizeof(int16_t));
+        audio_block_release(block);
+    }
+}
+
+static void *setup(void) {
+    struct audio_stft_config cfg = {
+        .fft_size = FFT_SIZE,
+        .hop_size = FFT_SIZE / 2,
+        .frame = gain_frame,
+        .user_data = &gain_half,
+    };
+    zassert_ok(node_stft_init(&half_hop, &cfg), "Half-hop init failed");
+
+    cfg.hop_size = FFT_SIZE / 4;
+    cfg.user_data = &gain_quarter;
+    zassert_ok(node_stft_init(&quarter_hop, &cfg), "Quarter-hop init failed");
+
+    cfg.analysis_only = true;
+    cfg.hop_size = FFT_SIZE;
+    cfg.frame = count_frame;
+    zassert_ok(node_stft_init(&analysis, &cfg), "Analysis init failed");
+
+    zassert_ok(node_spectrum_analyzer_init_ex(&analyzer, NULL), "Analyzer init failed");
+
+    for (size_t i = 0; i < TOTAL; i++) {
+        input[i] = (int16_t)(8000.0f * sinf(2.0f * (float)M_PI * 1000.0f * i / RATE) +
+                             4000.0f * sinf(2.0f * (float)M_PI * 5300.0f * i / RATE));
+    }
+    return NULL;
+}
+
+static void before(void *f) {
+    gain_half = 1.0f;
+    gain_quarter = 1.0f;
+    analysis_calls = 0;
+    audio_node_reset(&half_hop);
+    audio_node_reset(&quarter_hop);
+    audio_node_reset(&analysis);
+}
+
+ZTEST_SUITE(stft, NULL, setup, before, NULL, NULL);
+
+static void check_reconstruction(struct audio_node *node, float gain) {
+    uint32_t latency = audio_stft_latency(node_stft_get(node));
+
+    zassert_equal(latency, FFT_SIZE - 1, "Unexpected latency");
+    run(node);
+
+    for (size_t i = FFT_SIZE; i < TOTAL; i++) {
+        zassert_within(output[i], (int16_t)(gain * input[i - latency]), 2,
+                       "Sample %d not reconstructed", i);
+    }
+}
+
+ZTEST(stft, test_identity_half_hop) {
+    check_reconstruction(&half_hop, 1.0f);
+}
+
+ZTEST(stft, test_identity_quarter_hop) {
+    check_reconstruction(&quarter_hop, 1.0f);
+}
+
+ZTEST(stft, test_spectral_gain) {
+    gain_half = 0.5f;
+    check_reconstruction(&half_hop, 0.5f);
+}
+
+ZTEST(stft, test_frame_cadence) {
+    run(&quarter_hop);
+    zassert_equal(node_stft_get(&quarter_hop)->frames, TOTAL / (FFT_SIZE / 4),
+                  "One frame per hop expected");
+}
+
+ZTEST(stft, test_analysis_only_passes_through) {
+    run(&analysis);
+
+    zassert_mem_equal(output, input, sizeof(input), "Analysis-only mode modified samples");
+    /* No frame over zeroed history: the first fires at FFT_SIZE samples */
+    zassert_equal(analysis_calls, TOTAL / FFT_SIZE, "Wrong analysis frame count");
+}
+
+ZTEST(stft, test_rejects_bad_config) {
+    struct audio_stft stft;
+    struct audio_stft_config cfg = {
+        .fft_size = FFT_SIZE,
+        .hop_size = FFT_SIZE,
+        .frame = gain_frame,
+        .user_data = &gain_half,
+    };
+
+    zassert_equal(audio_stft_init(&stft, &cfg), -EINVAL, "Synthesis without overlap accepted");
+    cfg.hop_size = 3;
+    zassert_equal(audio_stft_init(&stft, &cfg), -EINVAL, "Hop not dividing the frame accepted");
+    cfg.fft_size = 200;
+    cfg.hop_size = 100;
+    zassert_equal(audio_stft_init(&stft, &cfg), -EINVAL, "Non power of two accepted");
+}
+
+ZTEST(stft, test_spectrum_analyzer_on_stft) {
+    float peak_freq, peak_mag;
+
+    audio_node_reset(&analyzer);
+    zassert_equal(node_spectrum_analyzer_get_peak(&analyzer, &peak_freq, &peak_mag), -EAGAIN,
+                  "Spectrum ready before a full frame");
+
+    run(&analyzer);
+
+    zassert_ok(node_spectrum_analyzer_get_peak(&analyzer, &peak_freq, &peak_mag), "No spectrum");
+    zassert_within(peak_freq, 1000.0f, (float)RATE / 1024, "Peak at %d Hz", (int)peak_freq);
+    zassert_mem_equal(output, input, sizeof(input), "Analyzer modified samples");
+}
@@ -0,0 +1,105 @@
+/**
+ * @file main.c
+ * @brief CPU masks, load balancing and suspended strips on SMP
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <audio_fw_v2.h>
+#include <channel_strip.h>
+
+#define STACK_SIZE  2048
+
+K_THREAD_STACK_DEFINE(heavy_stack, STACK_SIZE);
+K_THREAD_STACK_DEFINE(light_stack, STACK_SIZE);
+
+/* Pass-through that records the CPU it ran on */
+static struct audio_block *probe_process(struct audio_node *self, struct audio_block *in) {
+    *(int *)self->ctx = arch_curr_cpu()->id;
+    return in;
+}
+
+static const struct audio_node_api probe_api = {
+    .process = probe_process,
+};
+
+static int heavy_cpu, light_cpu;
+static struct audio_node heavy_nodes[2] = {
+    { .vtable = &probe_api, .ctx = &heavy_cpu },
+    { .vtable = &probe_api, .ctx = &heavy_cpu },
+};
+static struct audio_node light_node = { .vtable = &probe_api, .ctx = &light_cpu };
+
+static struct channel_strip heavy, light;
+static struct k_fifo heavy_out, light_out;
+
+/* Runs one block through a strip; false if it produced nothing in time */
+static bool cycle(struct channel_strip *strip, struct k_fifo *out, k_timeout_t timeout) {
+    struct audio_block *block = audio_block_alloc();
+    zassert_not_null(block, "Pool exhausted");
+
+    channel_strip_push_input(strip, block);
+    block = k_fifo_get(out, timeout);
+    if (!block) {
+        return false;
+    }
+    audio_block_release(block);
+    return true;
+}
+
+static void *setup(void) {
+    int prio = k_thread_priority_get(k_current_get()) - 1;
+
+    k_fifo_init(&heavy_out);
+    channel_strip_init(&heavy, "heavy");
+    channel_strip_add_node(&heavy, &heavy_nodes[0]);
+    channel_strip_add_node(&heavy, &heavy_nodes[1]);
+    heavy.out_fifo = &heavy_out;
+    channel_strip_start(&heavy, heavy_stack, STACK_SIZE, prio);
+
+    k_fifo_init(&light_out);
+    channel_strip_init(&light, "light");
+    channel_strip_add_node(&light, &light_node);
+    light.out_fifo = &light_out;
+    channel_strip_start(&light, light_stack, STACK_SIZE, prio);
+    return NULL;
+}
+
+ZTEST_SUITE(strip_affinity, NULL, setup, NULL, NULL, NULL);
+
+ZTEST(strip_affinity, test_mask_applied) {
+    for (int cpu = 0; cpu < (int)arch_num_cpus(); cpu++) {
+        zassert_ok(channel_strip_set_cpu_mask(&light, BIT(cpu)), "Mask rejected");
+        for (int i = 0; i < 4; i++) {
+            zassert_true(cycle(&light, &light_out, K_MSEC(100)), "Strip produced no output");
+            zassert_equal(light_cpu, cpu, "Strip ran on CPU %d, pinned to %d", light_cpu, cpu);
+        }
+    }
+
+    zassert_equal(channel_strip_set_cpu_mask(&light, BIT(arch_num_cpus())), -EINVAL,
+                  "Mask with a missing CPU accepted");
+    zassert_ok(channel_strip_set_cpu_mask(&light, 0), "Unpinning failed");
+}
+
+ZTEST(strip_affinity, test_suspended_strip_stays_suspended_after_balance) {
+    struct channel_strip *strips[] = { &heavy, &light };
+
+    zassert_ok(channel_strip_suspend(&light), "Suspend failed");
+    zassert_ok(channel_strip_balance(strips, ARRAY_SIZE(strips)), "Balance failed");
+
+    zassert_false(cycle(&light, &light_out, K_MSEC(50)), "Suspended strip resumed by balance");
+
+    zassert_ok(channel_strip_resume(&light), "Resume failed");
+    struct audio_block *block = k_fifo_get(&light_out, K_MSEC(100));
+    zassert_not_null(block, "Queued block not processed after resume");
+    audio_block_release(block);
+
+    /* Two strips, two CPUs: the balancer separates them */
+    zassert_true(cycle(&heavy, &heavy_out, K_MSEC(100)), "Strip produced no output");
+    zassert_true(cycle(&light, &light_out, K_MSEC(100)), "Strip produced no output");
+    zassert_not_equal(heavy_cpu, light_cpu, "Balanced strips share CPU %d", heavy_cpu);
+
+    zassert_equal(channel_strip_resume(&light), 0, "Resuming a running strip failed");
+    zassert_ok(channel_strip_set_cpu_mask(&heavy, 0), "Unpinning failed");
+    zassert_ok(channel_strip_set_cpu_mask(&light, 0), "Unpinning failed");
+}
@@ -0,0 +1,160 @@
+/**
+ * @file main.c
+ * @brief Control command ring: parameter sets, ramps, bypass, reads, idle wakeups
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <audio_fw_v2.h>
+#include <channel_strip.h>
+
+#define STRIP_STACK     2048
+#define LEVEL           1000
+
+K_THREAD_STACK_DEFINE(strip_stack, STRIP_STACK);
+
+static struct channel_strip strip;
+static struct audio_node gain;
+static struct k_fifo out_fifo;
+
+static void push_level(void) {
+    struct audio_block *block = audio_block_alloc();
+
+    if (block) {
+        for (size_t i = 0; i < block->data_len; i++) {
+            block->data[i] = LEVEL;
+        }
+        channel_strip_push_input(&strip, block);
+    }
+}
+
+/* Runs one block through the strip and returns it */
+static struct audio_block *cycle(void) {
+    push_level();
+    struct audio_block *out = k_fifo_get(&out_fifo, K_MSEC(100));
+    zassert_not_null(out, "Strip produced no output");
+    return out;
+}
+
+static int16_t cycle_first_sample(void) {
+    struct audio_block *out = cycle();
+    int16_t sample = out->data[0];
+    audio_block_release(out);
+    return sample;
+}
+
+static void feed_tick(struct k_timer *timer) {
+    push_level();
+}
+
+K_TIMER_DEFINE(feed_timer, feed_tick, NULL);
+
+static void *setup(void) {
+    k_fifo_init(&out_fifo);
+    channel_strip_init(&strip, "cmd");
+    node_vol_init(&gain, 1.0f);
+    channel_strip_add_node(&strip, &gain);
+    strip.out_fifo = &out_fifo;
+    channel_strip_start(&strip, strip_stack, STRIP_STACK,
+                        k_thread_priority_get(k_current_get()) - 1);
+    return NULL;
+}
+
+static void before(void *f) {
+    zassert_ok(channel_strip_set_param(&strip, 0, NODE_VOL_PARAM_GAIN, 1.0f, 0), "Queue failed");
+    zassert_ok(channel_strip_set_bypass(&strip, CHANNEL_STRIP_ALL_NODES, false), "Queue failed");
+    audio_block_release(cycle());
+}
+
+ZTEST_SUITE(strip_commands, NULL, setup, before, NULL, NULL);
+
+ZTEST(strip_commands, test_param_applied_at_next_block) {
+    zassert_ok(channel_strip_set_param(&strip, 0, NODE_VOL_PARAM_GAIN, 0.5f, 0), "Queue failed");
+    zassert_equal(cycle_first_sample(), LEVEL / 2, "Gain not applied");
+}
+
+ZTEST(strip_commands, test_ramp_is_monotonic) {
+    zassert_ok(channel_strip_set_param(&strip, 0, NODE_VOL_PARAM_GAIN, 0.0f,
+                                       2 * CONFIG_AUDIO_BLOCK_SAMPLES), "Queue failed");
+
+    struct audio_block *out = cycle();
+    for (size_t i = 1; i < out->data_len; i++) {
+        zassert_true(out->data[i] <= out->data[i - 1], "Ramp not monotonic at %zu", i);
+    }
+    zassert_true(out->data[out->data_len - 1] > 0, "Ramp ended too early");
+    audio_block_release(out);
+
+    audio_block_release(cycle());
+    zassert_equal(cycle_first_sample(), 0, "Ramp did not reach its target");
+}
+
+ZTEST(strip_commands, test_bypass) {
+    zassert_ok(channel_strip_set_param(&strip, 0, NODE_VOL_PARAM_GAIN, 0.25f, 0), "Queue failed");
+    zassert_ok(channel_strip_set_bypass(&strip, 0, true), "Queue failed");
+    zassert_equal(cycle_first_sample(), LEVEL, "Bypassed node still processed");
+
+    zassert_ok(channel_strip_set_bypass(&strip, 0, false), "Queue failed");
+    zassert_equal(cycle_first_sample(), LEVEL / 4, "Node not re-enabled");
+}
+
+ZTEST(strip_commands, test_read_param_at_block_boundary) {
+    float value = 0.0f;
+
+    zassert_ok(channel_strip_set_param(&strip, 0, NODE_VOL_PARAM_GAIN, 0.75f, 0), "Queue failed");
+
+    /* No block is due: the command itself wakes the strip thread */
+    zassert_ok(channel_strip_read_param(&strip, 0, NODE_VOL_PARAM_GAIN, &value, K_MSEC(10)),
+               "Read not answered without blocks");
+    zassert_within(value, 0.75f, 0.0001f, "Read returned %f", (double)value);
+
+    /* And with blocks flowing */
+    k_timer_start(&feed_timer, K_MSEC(5), K_MSEC(5));
+    zassert_ok(channel_strip_read_param(&strip, 0, NODE_VOL_PARAM_GAIN, &value, K_MSEC(100)),
+               "Read failed");
+    k_timer_stop(&feed_timer);
+
+    zassert_within(value, 0.75f, 0.0001f, "Read returned %f", (double)value);
+
+    /* Unknown parameter ids are reported */
+    k_timer_start(&feed_timer, K_MSEC(5), K_MSEC(5));
+    zassert_equal(channel_strip_read_param(&strip, 0, 42, &value, K_MSEC(100)), -EINVAL,
+                  "Unknown id accepted");
+    k_timer_stop(&feed_timer);
+
+    /* Drop what the timer fed */
+    struct audio_block *out;
+    k_msleep(10);
+    while ((out = k_fifo_get(&out_fifo, K_NO_WAIT)) != NULL) {
+        audio_block_release(out);
+    }
+}
+
+ZTEST(strip_commands, test_param_applied_while_idle) {
+    float value = 0.0f;
+
+    /* No block arrives, as behind a silence gate */
+    zassert_ok(channel_strip_set_param(&strip, 0, NODE_VOL_PARAM_GAIN, 0.5f, 0), "Queue failed");
+    k_msleep(1);
+
+    /* Direct read: the strip thread has applied it and is waiting again */
+    zassert_ok(audio_node_get_param(&gain, NODE_VOL_PARAM_GAIN, &value), "Read failed");
+    zassert_within(value, 0.5f, 0.0001f, "Command waited for a block");
+    zassert_equal(cycle_first_sample(), LEVEL / 2, "Gain not applied");
+}
+
+ZTEST(strip_commands, test_full_ring_rejects) {
+    int ret = 0;
+
+    /* Keep the woken strip thread from draining the ring in between */
+    k_sched_lock();
+    for (int i = 0; i <= CONFIG_AUDIO_CMD_QUEUE_DEPTH && ret == 0; i++) {
+        ret = channel_strip_set_param(&strip, 0, NODE_VOL_PARAM_GAIN, 1.0f, 0);
+    }
+    k_sched_unlock();
+    zassert_equal(ret, -ENOSPC, "Full ring accepted a command");
+
+    zassert_equal(channel_strip_set_param(&strip, CHANNEL_STRIP_MAX_NODES, 0, 1.0f, 0), -EINVAL,
+                  "Bad node index accepted");
+
+    audio_block_release(cycle());
+}
@@ -0,0 +1,164 @@
+/**
+ * @file main.c
+ * @brief Modulation sources bound to node parameters
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <audio_fw_v2.h>
+#include <channel_strip.h>
+#include <audio_mod.h>
+
+#define STRIP_STACK     2048
+#define LEVEL           1000
+
+/* Square LFO that flips sign every block */
+#define FLIP_RATE_HZ    ((float)CONFIG_AUDIO_SAMPLE_RATE / (2.0f * CONFIG_AUDIO_BLOCK_SAMPLES))
+
+K_THREAD_STACK_DEFINE(strip_stack, STRIP_STACK);
+K_THREAD_STACK_DEFINE(mixer_stack, STRIP_STACK);
+
+static struct channel_strip strip;
+static struct audio_node gain;
+static struct k_fifo out_fifo;
+static struct audio_mod_source source;
+static struct audio_mod_binding binding;
+
+static struct audio_mixer mixer;
+static struct channel_strip channels[2];
+static struct audio_node channel_gains[2];
+static struct audio_mod_binding channel_bindings[2];
+static struct k_fifo mixer_out;
+
+/* Runs one block through the strip and returns its last sample */
+static int16_t cycle_last_sample(void) {
+    struct audio_block *block = audio_block_alloc();
+    zassert_not_null(block, "Pool exhausted");
+
+    for (size_t i = 0; i < block->data_len; i++) {
+        block->data[i] = LEVEL;
+    }
+    channel_strip_push_input(&strip, block);
+
+    struct audio_block *out = k_fifo_get(&out_fifo, K_MSEC(100));
+    zassert_not_null(out, "Strip produced no output");
+    int16_t sample = out->data[out->data_len - 1];
+    audio_block_release(out);
+    return sample;
+}
+
+/* Runs one block through the mixer and returns the last mixed sample */
+static int16_t mixer_last_sample(void) {
+    struct audio_block *block = audio_block_alloc();
+    zassert_not_null(block, "Pool exhausted");
+
+    for (size_t i = 0; i < block->data_len; i++) {
+        block->data[i] = LEVEL;
+    }
+    k_fifo_put(&mixer.in_fifo, block);
+
+    struct audio_block *out = k_fifo_get(&mixer_out, K_MSEC(100));
+    zassert_not_null(out, "Mixer produced no output");
+    int16_t sample = out->data[out->data_len - 1];
+    audio_block_release(out);
+    return sample;
+}
+
+static void *setup(void) {
+    int prio = k_thread_priority_get(k_current_get()) - 1;
+
+    k_fifo_init(&mixer_out);
+    audio_mixer_init(&mixer);
+    for (int i = 0; i < 2; i++) {
+        channel_strip_init(&channels[i], "ch");
+        node_vol_init(&channel_gains[i], 1.0f);
+        channel_strip_add_node(&channels[i], &channel_gains[i]);
+        audio_mixer_add_channel(&mixer, &channels[i]);
+    }
+    mixer.out_fifo = &mixer_out;
+    audio_mixer_start(&mixer, mixer_stack, STRIP_STACK, prio);
+
+    k_fifo_init(&out_fifo);
+    channel_strip_init(&strip, "mod");
+    node_vol_init(&gain, 1.0f);
+    channel_strip_add_node(&strip, &gain);
+    strip.out_fifo = &out_fifo;
+    channel_strip_start(&strip, strip_stack, STRIP_STACK, prio);
+    return NULL;
+}
+
+static void after(void *f) {
+    zassert_ok(channel_strip_mod_unbind(&strip, &binding), "Queue failed");
+    zassert_ok(channel_strip_set_param(&strip, 0, NODE_VOL_PARAM_GAIN, 1.0f, 0), "Queue failed");
+    cycle_last_sample();
+}
+
+ZTEST_SUITE(strip_modulation, NULL, setup, NULL, after, NULL);
+
+ZTEST(strip_modulation, test_lfo_modulates_gain) {
+    audio_mod_lfo_init(&source, AUDIO_MOD_LFO_SQUARE, FLIP_RATE_HZ);
+    zassert_ok(channel_strip_mod_bind(&strip, &binding, &source, 0, NODE_VOL_PARAM_GAIN,
+                                      0.5f, 0.5f), "Queue failed");
+
+    int16_t first = cycle_last_sample();
+    int16_t second = cycle_last_sample();
+    int16_t third = cycle_last_sample();
+
+    zassert_within(first, 0, 2, "Gain did not follow the LFO low phase");
+    zassert_within(second, LEVEL, 2, "Gain did not follow the LFO high phase");
+    zassert_within(third, 0, 2, "LFO did not keep running");
+}
+
+ZTEST(strip_modulation, test_envelope_follows_gate) {
+    audio_mod_env_init(&source, 0.0f, 0.0f);
+    zassert_ok(channel_strip_mod_bind(&strip, &binding, &source, 0, NODE_VOL_PARAM_GAIN,
+                                      0.0f, 1.0f), "Queue failed");
+
+    zassert_within(cycle_last_sample(), 0, 2, "Closed envelope not silent");
+
+    audio_mod_env_gate(&source, true);
+    zassert_within(cycle_last_sample(), LEVEL, 2, "Gate did not open the envelope");
+
+    audio_mod_env_gate(&source, false);
+    zassert_within(cycle_last_sample(), 0, 2, "Gate did not close the envelope");
+}
+
+ZTEST(strip_modulation, test_unbind_freezes_parameter) {
+    audio_mod_lfo_init(&source, AUDIO_MOD_LFO_SQUARE, FLIP_RATE_HZ);
+    zassert_ok(channel_strip_mod_bind(&strip, &binding, &source, 0, NODE_VOL_PARAM_GAIN,
+                                      0.5f, 0.5f), "Queue failed");
+    cycle_last_sample();
+    int16_t held = cycle_last_sample();
+
+    zassert_ok(channel_strip_mod_unbind(&strip, &binding), "Queue failed");
+
+    for (int i = 0; i < 3; i++) {
+        zassert_within(cycle_last_sample(), held, 2, "Parameter still modulated after unbind");
+    }
+}
+
+ZTEST(strip_modulation, test_bind_rejects_bad_node) {
+    audio_mod_lfo_init(&source, AUDIO_MOD_LFO_SINE, 1.0f);
+    zassert_equal(channel_strip_mod_bind(&strip, &binding, &source, CHANNEL_STRIP_MAX_NODES,
+                                         NODE_VOL_PARAM_GAIN, 0.0f, 1.0f), -EINVAL,
+                  "Bad node index accepted");
+}
+
+ZTEST(strip_modulation, test_shared_source_advances_once_per_mixer_block) {
+    static struct audio_mod_source shared;
+
+    audio_mod_lfo_init(&shared, AUDIO_MOD_LFO_SQUARE, FLIP_RATE_HZ);
+    for (int i = 0; i < 2; i++) {
+        zassert_ok(channel_strip_mod_bind(&channels[i], &channel_bindings[i], &shared, 0,
+                                          NODE_VOL_PARAM_GAIN, 0.5f, 0.5f), "Queue failed");
+    }
+
+    /* Advancing once per channel would skip every other phase */
+    zassert_within(mixer_last_sample(), 0, 4, "Channels did not follow the LFO low phase");
+    zassert_within(mixer_last_sample(), 2 * LEVEL, 4, "Channels did not follow the high phase");
+    zassert_within(mixer_last_sample(), 0, 4, "Shared LFO advanced more than once per block");
+
+    for (int i = 0; i < 2; i++) {
+        zassert_ok(channel_strip_mod_unbind(&channels[i], &channel_bindings[i]), "Queue failed");
+    }
+}
@@ -0,0 +1,168 @@
+/**
+ * @file main.c
+ * @brief Runtime sample rate changes on strips and the mixer
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <audio_fw_v2.h>
+#include <channel_strip.h>
+
+#define STACK_SIZE  2048
+
+K_THREAD_STACK_DEFINE(strip_stack, STACK_SIZE);
+K_THREAD_STACK_DEFINE(mixer_stack, STACK_SIZE);
+
+/* Pass-through that records its rate and the rate its last block ran at */
+struct probe {
+    uint32_t rate;
+    uint32_t block_rate;
+};
+
+static struct audio_block *probe_process(struct audio_node *self, struct audio_block *in) {
+    struct probe *p = self->ctx;
+
+    p->block_rate = p->rate;
+    return in;
+}
+
+static void probe_set_sample_rate(struct audio_node *self, uint32_t rate) {
+    ((struct probe *)self->ctx)->rate = rate;
+}
+
+static const struct audio_node_api probe_api = {
+    .process = probe_process,
+    .set_sample_rate = probe_set_sample_rate,
+};
+
+/* strip, idle strip, two mixer channels, mixer master */
+static struct probe probes[5];
+static struct audio_node nodes[5];
+
+static struct channel_strip strip;
+static struct channel_strip idle;
+static struct k_fifo strip_out;
+
+static struct audio_mixer mixer;
+static struct channel_strip channels[2];
+static struct channel_strip master;
+static struct k_fifo mixer_out;
+
+static void strip_cycle(void) {
+    struct audio_block *block = audio_block_alloc();
+    zassert_not_null(block, "Pool exhausted");
+
+    channel_strip_push_input(&strip, block);
+    block = k_fifo_get(&strip_out, K_MSEC(100));
+    zassert_not_null(block, "Strip produced no output");
+    audio_block_release(block);
+}
+
+static void mixer_cycle(void) {
+    struct audio_block *block = audio_block_alloc();
+    zassert_not_null(block, "Pool exhausted");
+
+    k_fifo_put(&mixer.in_fifo, block);
+    block = k_fifo_get(&mixer_out, K_MSEC(100));
+    zassert_not_null(block, "Mixer produced no output");
+    audio_block_release(block);
+}
+
+static void *setup(void) {
+    int prio = k_thread_priority_get(k_current_get()) - 1;
+
+    for (size_t i = 0; i < ARRAY_SIZE(nodes); i++) {
+        nodes[i].vtable = &probe_api;
+        nodes[i].ctx = &probes[i];
+    }
+
+    k_fifo_init(&strip_out);
+    channel_strip_init(&strip, "rate");
+    channel_strip_add_node(&strip, &nodes[0]);
+    strip.out_fifo = &strip_out;
+    channel_strip_start(&strip, strip_stack, STACK_SIZE, prio);
+
+    channel_strip_init(&idle, "idle");
+
+    k_fifo_init(&mixer_out);
+    audio_mixer_init(&mixer);
+    for (int i = 0; i < 2; i++) {
+        channel_strip_init(&channels[i], "ch");
+        channel_strip_add_node(&channels[i], &nodes[2 + i]);
+        audio_mixer_add_channel(&mixer, &channels[i]);
+    }
+    channel_strip_init(&master, "master");
+    channel_strip_add_node(&master, &nodes[4]);
+    audio_mixer_set_master(&mixer, &master);
+    mixer.out_fifo = &mixer_out;
+    audio_mixer_start(&mixer, mixer_stack, STACK_SIZE, prio);
+    return NULL;
+}
+
+ZTEST_SUITE(strip_rate, NULL, setup, NULL, NULL, NULL);
+
+ZTEST(strip_rate, test_stopped_strip_applies_immediately) {
+    zassert_ok(channel_strip_set_sample_rate(&idle, 16000), "Rate rejected");
+    zassert_equal(channel_strip_get_sample_rate(&idle), 16000, "Rate not applied");
+
+    /* Nodes added later start at the strip's rate */
+    channel_strip_add_node(&idle, &nodes[1]);
+    zassert_equal(probes[1].rate, 16000, "New node at %u Hz", probes[1].rate);
+
+    zassert_ok(channel_strip_set_sample_rate(&idle, 24000), "Rate rejected");
+    zassert_equal(probes[1].rate, 24000, "Rate not propagated to the node");
+
+    zassert_equal(channel_strip_set_sample_rate(&idle, 0), -EINVAL, "Zero rate accepted");
+}
+
+ZTEST(strip_rate, test_running_strip_defers_to_block_boundary) {
+    uint32_t old = channel_strip_get_sample_rate(&strip);
+    uint32_t rate = old == 32000 ? 22050 : 32000;
+
+    strip_cycle();
+    zassert_equal(probes[0].block_rate, old, "Block ran at %u Hz", probes[0].block_rate);
+
+    /* The queued change wakes the strip thread; hold it off to see it pending */
+    k_sched_lock();
+    zassert_ok(channel_strip_set_sample_rate(&strip, rate), "Rate rejected");
+    zassert_equal(channel_strip_get_sample_rate(&strip), old, "Applied mid-block");
+    zassert_equal(probes[0].rate, old, "Node changed mid-block");
+    zassert_equal(channel_strip_set_sample_rate(&strip, 44100), -EBUSY,
+                  "Second change accepted while the first is pending");
+    k_sched_unlock();
+
+    strip_cycle();
+    zassert_equal(channel_strip_get_sample_rate(&strip), rate, "Rate not applied");
+    zassert_equal(probes[0].block_rate, rate, "Next block ran at %u Hz", probes[0].block_rate);
+
+    /* Once applied, the next change is accepted again */
+    zassert_ok(channel_strip_set_sample_rate(&strip, old), "Rate rejected after apply");
+    strip_cycle();
+    zassert_equal(probes[0].block_rate, old, "Rate not restored");
+}
+
+ZTEST(strip_rate, test_mixer_propagates_to_all_strips) {
+    uint32_t old = mixer.sample_rate;
+    uint32_t rate = old == 96000 ? 88200 : 96000;
+
+    zassert_equal(channel_strip_set_sample_rate(&channels[0], rate), -EBUSY,
+                  "Mixer channel accepted its own rate");
+    zassert_equal(channel_strip_set_sample_rate(&master, rate), -EBUSY,
+                  "Mixer master accepted its own rate");
+
+    k_sched_lock();
+    zassert_ok(audio_mixer_set_sample_rate(&mixer, rate), "Rate rejected");
+    zassert_equal(audio_mixer_set_sample_rate(&mixer, 44100), -EBUSY,
+                  "Second change accepted while the first is pending");
+    for (int i = 2; i < 5; i++) {
+        zassert_equal(probes[i].rate, old, "Strip %d changed mid-block", i);
+    }
+    k_sched_unlock();
+
+    mixer_cycle();
+    for (int i = 2; i < 5; i++) {
+        zassert_equal(probes[i].block_rate, rate, "Strip %d ran at %u Hz",
+                      i, probes[i].block_rate);
+    }
+    zassert_equal(channel_strip_get_sample_rate(&master), rate, "Master not at the mix rate");
+}